@@ -1,13 +1,42 @@
-
 #include "mainwindow.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
 
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption generateOption("generate", "Fill the canvas with a synthetic graph of <count> nodes.", "count");
+    QCommandLineOption seedOption("seed", "Seed of the synthetic graph.", "seed", "0");
+    QCommandLineOption exportOption("export", "Export the graph to a .png or .svg <file> and quit without showing "
+                                              "the window. Works with -platform offscreen.", "file");
+    QCommandLineOption exportScaleOption("export-scale", "Output pixels per canvas unit of the export.", "scale", "1");
+    parser.addOption(generateOption);
+    parser.addOption(seedOption);
+    parser.addOption(exportOption);
+    parser.addOption(exportScaleOption);
+    parser.process(a);
+
     MainWindow w;
+    if (parser.isSet(generateOption))
+    {
+        GraphLib::GraphGeneratorOptions options;
+        options.nodeCount = parser.value(generateOption).toInt();
+        options.seed = parser.value(seedOption).toUInt();
+        w.generateGraph(options);
+    }
+
+    if (parser.isSet(exportOption))
+    {
+        GraphLib::ExportOptions options;
+        options.scale = parser.value(exportScaleOption).toDouble();
+        return w.exportGraph(parser.value(exportOption), options) ? 0 : 1;
+    }
+
     w.show();
     return a.exec();
 }
@@ -1,4 +1,8 @@
 
+#include <QShortcut>
+#include <QInputDialog>
+#include <QStandardPaths>
+
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 #include "constants.h"
@@ -23,21 +27,26 @@ MainWindow::MainWindow(QWidget *parent)
     QString path = "./../../";
     QString pins = "pins.json", nodes = "nodes.json";
 
-    NodeTypeManager *nodeManager = new NodeTypeManager();
-    PinTypeManager *pinManager = new PinTypeManager();
-    nodeManager->loadTypes(path + nodes);
-    pinManager->loadTypes(path + pins);
-    _canvas->setNodeTypeManager(nodeManager);
-    _canvas->setPinTypeManager(pinManager);
+    _nodeTypeManager = new NodeTypeManager();
+    _pinTypeManager = new PinTypeManager();
+    // compiled catalogs make the next start skip scanning the ones that haven't changed
+    const TypeCatalogCache cache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/types");
+    _nodeTypeManager->setCatalogCache(cache);
+    _pinTypeManager->setCatalogCache(cache);
+    _canvas->setNodeTypeManager(_nodeTypeManager);
+    _canvas->setPinTypeManager(_pinTypeManager);
 
+    // the catalogs load in the background and are reloaded when they're edited
+    _nodeCatalogWatcher = new TypeCatalogWatcher(_nodeTypeManager, this);
+    _pinCatalogWatcher = new TypeCatalogWatcher(_pinTypeManager, this);
+    connect(_nodeCatalogWatcher, &TypeCatalogWatcher::onTypesChanged, _canvas, &Canvas::reloadTypes);
+    connect(_pinCatalogWatcher, &TypeCatalogWatcher::onTypesChanged, _canvas, &Canvas::reloadPinTypes);
+    _pinCatalogWatcher->load(path + pins);
+    _nodeCatalogWatcher->load(path + nodes);
 
-    setFocusPolicy(Qt::StrongFocus);
+    connect(new QShortcut(QKeySequence::Find, this), &QShortcut::activated, this, &MainWindow::findNode);
 
-    _timer = new QTimer(this);
-    connect(_timer, &QTimer::timeout, this, [&](){
-        _canvas->update();
-    });
-    _timer->start(10);
+    setFocusPolicy(Qt::StrongFocus);
 }
 
 MainWindow::~MainWindow()
@@ -45,13 +54,34 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
-void MainWindow::focusOutEvent(QFocusEvent *)
+void MainWindow::generateGraph(const GraphGeneratorOptions &options)
 {
-    _timer->stop();
+    waitForTypes();
+    GraphGenerator(_nodeTypeManager, _pinTypeManager).populate(_canvas, options);
 }
 
-void MainWindow::focusInEvent(QFocusEvent *)
+bool MainWindow::exportGraph(const QString &path, const ExportOptions &options)
 {
-    _timer->start();
+    waitForTypes();
+    if (path.endsWith(".svg", Qt::CaseInsensitive))
+        return _canvas->exportSvg(path, options);
+    return _canvas->exportPng(path, options);
 }
 
+void MainWindow::waitForTypes()
+{
+    _pinCatalogWatcher->waitForFinished();
+    _nodeCatalogWatcher->waitForFinished();
+}
+
+void MainWindow::findNode()
+{
+    bool bIsAccepted = false;
+    const QString query = QInputDialog::getText(this, "Find node", "Name or type:", QLineEdit::Normal, QString(), &bIsAccepted);
+    if (!bIsAccepted)
+        return;
+
+    const QVector<int> found = _canvas->findNodes(query, 1);
+    if (!found.isEmpty())
+        _canvas->jumpToNode(found.first());
+}
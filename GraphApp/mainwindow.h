@@ -2,10 +2,11 @@
 
 #include <QMainWindow>
 #include <QObject>
-#include <QTimer>
 
 #include "GraphLib_global.h"
 #include "GraphWidgets/canvas.h"
+#include "Generators/graphgenerator.h"
+#include "TypeManagers/typecatalogwatcher.h"
 
 
 QT_BEGIN_NAMESPACE
@@ -21,14 +22,21 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
-protected:
-    void focusOutEvent(QFocusEvent *) override;
-    void focusInEvent(QFocusEvent *) override;
+    void generateGraph(const GraphLib::GraphGeneratorOptions &options);
+    // The format is chosen by the file's suffix, PNG unless it's .svg
+    bool exportGraph(const QString &path, const GraphLib::ExportOptions &options);
+    // Asks for a node's name or type and jumps to the best match
+    void findNode();
+    // Finishes loading the catalogs, for what needs the types right away
+    void waitForTypes();
 
 private:
     Ui::MainWindow *ui;
     GraphLib::Canvas *_canvas;
-    QTimer *_timer;
+    GraphLib::NodeTypeManager *_nodeTypeManager;
+    GraphLib::PinTypeManager *_pinTypeManager;
+    GraphLib::TypeCatalogWatcher *_nodeCatalogWatcher;
+    GraphLib::TypeCatalogWatcher *_pinCatalogWatcher;
 
 };
 
@@ -0,0 +1,24 @@
+include(benchmark_dependency.pri)
+
+QT += core gui widgets
+
+TEMPLATE = app
+CONFIG += console c++latest
+CONFIG -= app_bundle
+CONFIG += thread
+
+SOURCES += \
+        main.cpp \
+        benchmarkgraph.cpp \
+        bench_canvas.cpp \
+        bench_data.cpp
+
+HEADERS += \
+        benchmarkgraph.h
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../GraphLib/release/ -lGraphLib
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../GraphLib/debug/ -lGraphLib
+else:unix: LIBS += -L$$OUT_PWD/../GraphLib/ -lGraphLib
+
+INCLUDEPATH += $$PWD/../GraphLib
+DEPENDPATH += $$PWD/../GraphLib
@@ -0,0 +1,182 @@
+#include <QCoreApplication>
+#include <QImage>
+#include <QMouseEvent>
+#include <benchmark/benchmark.h>
+#include <memory>
+
+#include "benchmarkgraph.h"
+#include "Generators/graphgenerator.h"
+
+using namespace GraphLib;
+using namespace GraphBenchmarks;
+
+namespace {
+
+void graphSizes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+}
+
+void sendMouseEvent(Canvas &canvas, QEvent::Type type, QPointF position, Qt::MouseButton button, Qt::MouseButtons buttons)
+{
+    QMouseEvent event(type, position, canvas.mapToGlobal(position), button, buttons, Qt::NoModifier);
+    QCoreApplication::sendEvent(&canvas, &event);
+}
+
+}
+
+static void BM_AddBaseNodes(benchmark::State &state)
+{
+    const int nodeCount = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto graph = std::make_unique<BenchmarkGraph>();
+        state.ResumeTiming();
+
+        for (int i = 0; i < nodeCount; i++)
+            graph->canvas().addBaseNode(QPoint(i * 10, 0), "Node");
+
+        // destroying the canvas isn't a part of insertion
+        state.PauseTiming();
+        graph.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * nodeCount);
+}
+BENCHMARK(BM_AddBaseNodes)->Apply(graphSizes);
+
+static void BM_AddTypedNodes(benchmark::State &state)
+{
+    const int nodeCount = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto graph = std::make_unique<BenchmarkGraph>();
+        state.ResumeTiming();
+
+        for (int i = 0; i < nodeCount; i++)
+            graph->canvas().addTypedNode(QPoint(i * 10, 0), i % BenchmarkGraph::nodeTypes());
+
+        state.PauseTiming();
+        graph.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * nodeCount);
+}
+BENCHMARK(BM_AddTypedNodes)->Apply(graphSizes);
+
+static void BM_AddTypedNodesBulk(benchmark::State &state)
+{
+    const int nodeCount = static_cast<int>(state.range(0));
+
+    QVector<QPair<QPoint, int>> spawns;
+    for (int i = 0; i < nodeCount; i++)
+        spawns.append({ QPoint(i * 10, 0), i % BenchmarkGraph::nodeTypes() });
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto graph = std::make_unique<BenchmarkGraph>();
+        state.ResumeTiming();
+
+        graph->canvas().addTypedNodes(spawns);
+
+        state.PauseTiming();
+        graph.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * nodeCount);
+}
+BENCHMARK(BM_AddTypedNodesBulk)->Apply(graphSizes);
+
+static void BM_GenerateGraph(benchmark::State &state)
+{
+    BenchmarkGraph graph;
+    GraphGenerator generator(&graph.nodeTypeManager(), &graph.pinTypeManager());
+
+    GraphGeneratorOptions options;
+    options.nodeCount = static_cast<int>(state.range(0));
+    options.fanOutDistribution = DegreeDistribution::PowerLaw;
+    options.maxFanOut = 8;
+    options.clusterCount = 20;
+
+    for (auto _ : state)
+    {
+        GeneratedGraph generated = generator.generate(options);
+        benchmark::DoNotOptimize(generated.edges.size());
+    }
+    state.SetItemsProcessed(state.iterations() * options.nodeCount);
+}
+BENCHMARK(BM_GenerateGraph)->Apply(graphSizes);
+
+static void BM_RemoveHighDegreeNode(benchmark::State &state)
+{
+    const int degree = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto graph = std::make_unique<BenchmarkGraph>();
+        int hub = graph->addHub(degree);
+        state.ResumeTiming();
+
+        graph->canvas().removeNode(hub);
+
+        state.PauseTiming();
+        graph.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * degree);
+}
+BENCHMARK(BM_RemoveHighDegreeNode)->Apply(graphSizes);
+
+static void BM_SelectionArea(benchmark::State &state)
+{
+    BenchmarkGraph graph;
+    graph.populate(static_cast<int>(state.range(0)));
+    Canvas &canvas = graph.canvas();
+
+    // zoomed out, so the rubber band covers thousands of nodes
+    canvas.setZoom(c_minZoomMultiplier, canvas.rect().center());
+
+    // the rubber band alternates between the whole viewport and its quarter,
+    // so every move both selects and deselects nodes
+    QPointF corner(1, 1);
+    QPointF far(canvas.width() - 1, canvas.height() - 1);
+    QPointF near = corner + (far - corner) / 2;
+    sendMouseEvent(canvas, QEvent::MouseButtonPress, corner, Qt::LeftButton, Qt::LeftButton);
+
+    bool bIsFar = false;
+    for (auto _ : state)
+    {
+        bIsFar = !bIsFar;
+        sendMouseEvent(canvas, QEvent::MouseMove, bIsFar ? far : near, Qt::NoButton, Qt::LeftButton);
+        // moves are only handled on the next frame
+        canvas.frameClock()->flush();
+    }
+
+    sendMouseEvent(canvas, QEvent::MouseButtonRelease, near, Qt::LeftButton, Qt::NoButton);
+}
+BENCHMARK(BM_SelectionArea)->Apply(graphSizes);
+
+static void BM_OffscreenPaint(benchmark::State &state)
+{
+    BenchmarkGraph graph;
+    graph.populate(static_cast<int>(state.range(0)));
+    Canvas &canvas = graph.canvas();
+    canvas.setZoom(state.range(1) / 100.0f, canvas.rect().center());
+
+    QImage image(canvas.size(), QImage::Format_ARGB32_Premultiplied);
+    for (auto _ : state)
+    {
+        canvas.render(&image);
+        benchmark::DoNotOptimize(image.constBits());
+    }
+
+    const FrameStats &stats = canvas.frameStats();
+    state.counters["nodesDrawn"] = stats.nodesDrawn;
+    state.counters["edgesDrawn"] = stats.edgesDrawn;
+    state.counters["allocations"] = static_cast<double>(stats.allocations);
+}
+// the second argument is the zoom in percent: the default one, the simplified tier and the overview
+BENCHMARK(BM_OffscreenPaint)->ArgsProduct({ { 1000, 10000, 100000 }, { 100, 40, 10 } })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,167 @@
+#include <QFileInfo>
+#include <QPainterPath>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+#include "benchmarkgraph.h"
+#include "DataClasses/pindata.h"
+#include "GraphWidgets/Abstracts/abstractpin.h"
+#include "utility.h"
+#include "Search/nodesearchindex.h"
+
+using namespace GraphLib;
+using namespace GraphBenchmarks;
+
+static void BM_StandardPath(benchmark::State &state)
+{
+    const int pathCount = static_cast<int>(state.range(0));
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> coordinate(-2000, 2000);
+    std::vector<std::pair<QPoint, QPoint>> ends(pathCount);
+    for (auto &[origin, target] : ends)
+    {
+        origin = QPoint(coordinate(random), coordinate(random));
+        target = QPoint(coordinate(random), coordinate(random));
+    }
+
+    QPainterPath path;
+    for (auto _ : state)
+    {
+        for (const auto &[origin, target] : ends)
+        {
+            standardPath(path, origin, target, 1.0f);
+            benchmark::DoNotOptimize(path.elementCount());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * pathCount);
+}
+BENCHMARK(BM_StandardPath)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_PinDataToByteArray(benchmark::State &state)
+{
+    const int count = static_cast<int>(state.range(0));
+    for (auto _ : state)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            QByteArray array = PinData(PinDirection::Out, i, i * 4, i % 8).toByteArray();
+            benchmark::DoNotOptimize(array.constData());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PinDataToByteArray)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_PinDataFromByteArray(benchmark::State &state)
+{
+    const int count = static_cast<int>(state.range(0));
+
+    std::vector<QByteArray> arrays;
+    arrays.reserve(count);
+    for (int i = 0; i < count; i++)
+        arrays.push_back(PinData(PinDirection::In, i, i * 4, i % 8).toByteArray());
+
+    for (auto _ : state)
+    {
+        for (const QByteArray &array : arrays)
+        {
+            PinData data = PinData::fromByteArray(array);
+            benchmark::DoNotOptimize(data.pinID);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PinDataFromByteArray)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_LoadNodeTypes(benchmark::State &state)
+{
+    QTemporaryDir dir;
+    const QString nodes = writeTypeFiles(dir, static_cast<int>(state.range(0))).second;
+
+    for (auto _ : state)
+    {
+        NodeTypeManager manager;
+        if (!manager.loadTypes(nodes))
+            state.SkipWithError("Failed to load generated node types");
+        benchmark::DoNotOptimize(manager.typesCount());
+    }
+    state.SetBytesProcessed(state.iterations() * QFileInfo(nodes).size());
+}
+BENCHMARK(BM_LoadNodeTypes)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadCachedNodeTypes(benchmark::State &state)
+{
+    QTemporaryDir dir;
+    const QString nodes = writeTypeFiles(dir, static_cast<int>(state.range(0))).second;
+    const TypeCatalogCache cache(dir.filePath("cache"));
+    if (!cache.load(nodes))
+        state.SkipWithError("Failed to compile generated node types");
+
+    for (auto _ : state)
+    {
+        NodeTypeManager manager;
+        manager.setCatalogCache(cache);
+        if (!manager.loadTypes(nodes))
+            state.SkipWithError("Failed to load cached node types");
+        benchmark::DoNotOptimize(manager.typesCount());
+    }
+    state.SetBytesProcessed(state.iterations() * QFileInfo(nodes).size());
+}
+BENCHMARK(BM_LoadCachedNodeTypes)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+namespace {
+
+// Names made of two common words and a number, typed by a few dozen types, like in a large graph
+NodeSearchIndex generatedSearchIndex(int nodeCount)
+{
+    const QStringList words = { "Audio", "Video", "Input", "Output", "Mixer", "Filter", "Buffer", "Clock",
+                                "Signal", "Sensor", "Power", "Network", "Storage", "Display", "Control", "Render" };
+    std::mt19937 random(42);
+    std::uniform_int_distribution<qsizetype> word(0, words.size() - 1);
+
+    NodeSearchIndex index;
+    for (int i = 0; i < nodeCount; i++)
+    {
+        const QString name = words[word(random)] + words[word(random)] + " " + QString::number(i);
+        index.insert(i, name, words[i % words.size()] + "Node");
+    }
+    return index;
+}
+
+}
+
+static void BM_SearchFind(benchmark::State &state)
+{
+    const NodeSearchIndex index = generatedSearchIndex(static_cast<int>(state.range(0)));
+    // prefixes matching many nodes, a single one and none, so the fuzzy lookup runs as well
+    const QStringList queries = { "audio", "videofilter 4", "sensorpower 99", "netwrk storge" };
+
+    qsizetype i = 0;
+    for (auto _ : state)
+    {
+        QVector<int> found = index.find(queries[i++ % queries.size()]);
+        benchmark::DoNotOptimize(found.constData());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SearchFind)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_SearchFindFuzzy(benchmark::State &state)
+{
+    const NodeSearchIndex index = generatedSearchIndex(static_cast<int>(state.range(0)));
+    // misspelled words, their trigrams are shared by thousands of terms
+    const QStringList queries = { "audoi mixer", "vidoefilter", "contrl signl", "displya render" };
+
+    qsizetype i = 0;
+    for (auto _ : state)
+    {
+        QVector<int> found = index.findFuzzy(queries[i++ % queries.size()]);
+        benchmark::DoNotOptimize(found.constData());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SearchFindFuzzy)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
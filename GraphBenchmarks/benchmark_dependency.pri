@@ -0,0 +1,18 @@
+isEmpty(BENCHMARK_DIR):BENCHMARK_DIR=$$(BENCHMARK_DIR)
+
+# BENCHMARK_DIR is an install prefix of Google Benchmark (include/ and lib/),
+# otherwise the system-wide installation is used
+!isEmpty(BENCHMARK_DIR) {
+    INCLUDEPATH *= $$BENCHMARK_DIR/include
+    LIBS += -L$$BENCHMARK_DIR/lib
+} else: unix {
+    exists(/usr/include/benchmark/benchmark.h):BENCHMARK_INCLUDEDIR=/usr/include
+    exists(/usr/local/include/benchmark/benchmark.h):BENCHMARK_INCLUDEDIR=/usr/local/include
+    !isEmpty(BENCHMARK_INCLUDEDIR): message("Using Google Benchmark from system")
+    BENCHMARK_DIR = $$dirname(BENCHMARK_INCLUDEDIR)
+}
+
+requires(exists($$BENCHMARK_DIR/include/benchmark/benchmark.h))
+
+LIBS += -lbenchmark
+win32: LIBS += -lshlwapi
@@ -0,0 +1,110 @@
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <cmath>
+
+#include "benchmarkgraph.h"
+#include "Generators/graphgenerator.h"
+
+using namespace GraphLib;
+
+namespace GraphBenchmarks {
+
+namespace {
+
+const int c_pinTypes = 8;
+const int c_nodeTypes = 16;
+const int c_gridColumns = 100;
+const int c_gridStep = 200;
+const quint32 c_seed = 20240601;
+
+// Returns data of the first (in-pin, out-pin) of the node
+std::pair<PinData, PinData> firstPins(const BaseNode *node)
+{
+    const AbstractPin *in = nullptr, *out = nullptr;
+    for (const AbstractPin *pin : node->pins())
+    {
+        if (pin->getDirection() == PinDirection::In && !in)
+            in = pin;
+        if (pin->getDirection() == PinDirection::Out && !out)
+            out = pin;
+    }
+    return { in->getData(), out->getData() };
+}
+
+}
+
+std::pair<QString, QString> writeTypeFiles(const QTemporaryDir &dir, int nodeTypes)
+{
+    QJsonArray pins;
+    for (int i = 0; i < c_pinTypes; i++)
+        pins.append(QJsonObject{ { "name", QString("pin%1").arg(i) },
+                                 { "color", QString("%1").arg(0x202020 * (i + 1) % 0xFFFFFF, 6, 16, QChar('0')) } });
+
+    QJsonArray nodes;
+    for (int i = 0; i < nodeTypes; i++)
+    {
+        QJsonArray inPins, outPins;
+        for (int pin = 0; pin <= i % 4; pin++)
+        {
+            inPins.append(QJsonObject{ { "type", QString("pin%1").arg((i + pin) % c_pinTypes) } });
+            outPins.append(QJsonObject{ { "type", QString("pin%1").arg((i + pin + 1) % c_pinTypes) } });
+        }
+        nodes.append(QJsonObject{ { "name", QString("Node %1").arg(i) }, { "in-pins", inPins }, { "out-pins", outPins } });
+    }
+
+    auto write = [&](const QString &name, const QJsonArray &types) {
+        QString path = dir.filePath(name);
+        QFile file(path);
+        file.open(QIODevice::WriteOnly);
+        file.write(QJsonDocument(QJsonObject{ { "types", types } }).toJson());
+        return path;
+    };
+
+    return { write("pins.json", pins), write(QString("nodes%1.json").arg(nodeTypes), nodes) };
+}
+
+int BenchmarkGraph::nodeTypes() { return c_nodeTypes; }
+
+BenchmarkGraph::BenchmarkGraph()
+    : _canvas{ std::make_unique<Canvas>() }
+{
+    auto [pins, nodes] = writeTypeFiles(_dir, c_nodeTypes);
+    _pinTypeManager.loadTypes(pins);
+    _nodeTypeManager.loadTypes(nodes);
+
+    _canvas->setTypeManagers(&_pinTypeManager, &_nodeTypeManager);
+    _canvas->resize(1920, 1080);
+}
+
+void BenchmarkGraph::populate(int nodeCount)
+{
+    GraphGeneratorOptions options;
+    options.nodeCount = nodeCount;
+    options.layerCount = std::max(10, static_cast<int>(std::sqrt(nodeCount)));
+    options.seed = c_seed;
+
+    GraphGenerator(&_nodeTypeManager, &_pinTypeManager).populate(_canvas.get(), options);
+}
+
+int BenchmarkGraph::addHub(int degree)
+{
+    auto hub = _canvas->addTypedNode(QPoint(0, -c_gridStep), 0).toStrongRef();
+    PinData hubOut = firstPins(hub.get()).second;
+
+    QVector<QPair<QPoint, int>> spawns;
+    for (int i = 0; i < degree; i++)
+        spawns.append({ QPoint((i % c_gridColumns) * c_gridStep, (i / c_gridColumns) * c_gridStep), i % c_nodeTypes });
+
+    QVector<QPair<PinData, PinData>> connections;
+    std::ranges::for_each(_canvas->addTypedNodes(spawns), [&](const QWeakPointer<BaseNode> &node) {
+        connections.append({ hubOut, firstPins(node.toStrongRef().get()).first });
+    });
+    _canvas->connectPins(connections);
+
+    return hub->ID();
+}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QTemporaryDir>
+#include <QString>
+#include <memory>
+
+#include "GraphWidgets/canvas.h"
+#include "TypeManagers/nodetypemanager.h"
+#include "TypeManagers/pintypemanager.h"
+
+namespace GraphBenchmarks {
+
+// Writes synthetic type files with the given number of node types
+// and returns their paths as (pins, nodes)
+std::pair<QString, QString> writeTypeFiles(const QTemporaryDir &dir, int nodeTypes);
+
+// A canvas of benchmark's viewport size with synthetic types loaded
+class BenchmarkGraph
+{
+public:
+    BenchmarkGraph();
+
+    GraphLib::Canvas &canvas() { return *_canvas; }
+    const GraphLib::NodeTypeManager &nodeTypeManager() const { return _nodeTypeManager; }
+    const GraphLib::PinTypeManager &pinTypeManager() const { return _pinTypeManager; }
+    static int nodeTypes();
+
+    // Adds a layered graph made by GraphGenerator with a fixed seed
+    void populate(int nodeCount);
+
+    // Adds a node with one out-pin connected to `degree` other nodes, returns its ID
+    int addHub(int degree);
+
+private:
+    QTemporaryDir _dir;
+    GraphLib::NodeTypeManager _nodeTypeManager;
+    GraphLib::PinTypeManager _pinTypeManager;
+    std::unique_ptr<GraphLib::Canvas> _canvas;
+};
+
+}
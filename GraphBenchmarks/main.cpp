@@ -0,0 +1,37 @@
+#include <QApplication>
+#include <QByteArray>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+int main(int argc, char *argv[])
+{
+    // canvases are painted into images, no window system is needed
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    // results are always written as JSON as well, so runs can be compared
+    std::vector<char *> args(argv, argv + argc);
+    char outArg[] = "--benchmark_out=graph_benchmarks.json";
+    char outFormatArg[] = "--benchmark_out_format=json";
+    bool bHasOut = std::ranges::any_of(args, [](const char *arg) {
+        return std::string_view(arg).starts_with("--benchmark_out=");
+    });
+    if (!bHasOut)
+    {
+        args.push_back(outArg);
+        args.push_back(outFormatArg);
+    }
+
+    int benchmarkArgc = static_cast<int>(args.size());
+    ::benchmark::Initialize(&benchmarkArgc, args.data());
+    if (::benchmark::ReportUnrecognizedArguments(benchmarkArgc, args.data()))
+        return 1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <numeric>
+
+#include "csrgraph.h"
+
+namespace GraphLib {
+
+namespace {
+
+// Fills one direction of the adjacency from (from, to) index pairs
+void fillRows(int nodeCount, const QVector<QPair<int, int>> &pairs, QVector<int> &start, QVector<int> &targets)
+{
+    start.fill(0, nodeCount + 1);
+    std::ranges::for_each(pairs, [&](const QPair<int, int> &pair) { start[pair.first + 1]++; });
+    std::partial_sum(start.begin(), start.end(), start.begin());
+
+    targets.resize(pairs.size());
+    QVector<int> filled(start.begin(), start.end() - 1);
+    std::ranges::for_each(pairs, [&](const QPair<int, int> &pair) { targets[filled[pair.first]++] = pair.second; });
+}
+
+}
+
+CsrGraph CsrGraph::build(const QVector<int> &nodeIDs, const QVector<QPair<int, int>> &edges)
+{
+    CsrGraph graph;
+    graph.nodeIDs = nodeIDs;
+    graph.indices.reserve(nodeIDs.size());
+    for (int i = 0; i < nodeIDs.size(); i++)
+        graph.indices.insert(nodeIDs[i], i);
+
+    QVector<QPair<int, int>> forward, backward;
+    forward.reserve(edges.size());
+    std::ranges::for_each(edges, [&](const QPair<int, int> &edge) {
+        const int from = graph.index(edge.first), to = graph.index(edge.second);
+        if (from >= 0 && to >= 0)
+            forward.append({ from, to });
+    });
+
+    // several pins may connect the same nodes
+    std::ranges::sort(forward);
+    forward.erase(std::unique(forward.begin(), forward.end()), forward.end());
+
+    backward.reserve(forward.size());
+    std::ranges::for_each(forward, [&](const QPair<int, int> &edge) { backward.append({ edge.second, edge.first }); });
+
+    fillRows(graph.nodeCount(), forward, graph.successorStart, graph.successors);
+    fillRows(graph.nodeCount(), backward, graph.predecessorStart, graph.predecessors);
+    return graph;
+}
+
+QVector<int> CsrGraph::reachable(int nodeID, bool bIsForward) const
+{
+    const int start = index(nodeID);
+    if (start < 0)
+        return {};
+
+    const QVector<int> &rowStart = bIsForward ? successorStart : predecessorStart;
+    const QVector<int> &targets = bIsForward ? successors : predecessors;
+
+    QVector<bool> visited(nodeCount(), false);
+    QVector<int> stack{ start };
+    QVector<int> found;
+    while (!stack.isEmpty())
+    {
+        const int node = stack.takeLast();
+        for (int i = rowStart[node]; i < rowStart[node + 1]; i++)
+        {
+            const int next = targets[i];
+            if (visited[next])
+                continue;
+            visited[next] = true;
+            found.append(nodeIDs[next]);
+            stack.append(next);
+        }
+    }
+
+    std::ranges::sort(found);
+    return found;
+}
+
+QVector<QVector<int>> CsrGraph::stronglyConnectedComponents() const
+{
+    // Tarjan's algorithm with an explicit stack, deep chains would overflow the call stack
+    const int count = nodeCount();
+    QVector<int> order(count, -1), lowLink(count, 0);
+    QVector<bool> bIsOnStack(count, false);
+    QVector<int> stack;
+    QVector<QPair<int, int>> calls;
+    QVector<QVector<int>> components;
+    int nextOrder = 0;
+
+    for (int root = 0; root < count; root++)
+    {
+        if (order[root] >= 0)
+            continue;
+
+        calls.append({ root, successorStart[root] });
+        order[root] = lowLink[root] = nextOrder++;
+        stack.append(root);
+        bIsOnStack[root] = true;
+
+        while (!calls.isEmpty())
+        {
+            auto &[node, edge] = calls.last();
+            if (edge < successorStart[node + 1])
+            {
+                const int next = successors[edge++];
+                if (order[next] < 0)
+                {
+                    order[next] = lowLink[next] = nextOrder++;
+                    stack.append(next);
+                    bIsOnStack[next] = true;
+                    calls.append({ next, successorStart[next] });
+                }
+                else if (bIsOnStack[next])
+                    lowLink[node] = std::min(lowLink[node], order[next]);
+                continue;
+            }
+
+            const int finished = node;
+            calls.removeLast();
+            if (!calls.isEmpty())
+                lowLink[calls.last().first] = std::min(lowLink[calls.last().first], lowLink[finished]);
+
+            if (lowLink[finished] != order[finished])
+                continue;
+
+            QVector<int> component;
+            int member;
+            do
+            {
+                member = stack.takeLast();
+                bIsOnStack[member] = false;
+                component.append(nodeIDs[member]);
+            } while (member != finished);
+            std::ranges::sort(component);
+            components.append(std::move(component));
+        }
+    }
+    return components;
+}
+
+std::optional<QVector<int>> CsrGraph::topologicalOrder() const
+{
+    // Kahn's algorithm, nodes left with incoming edges are on a cycle
+    const int count = nodeCount();
+    QVector<int> inDegree(count);
+    for (int i = 0; i < count; i++)
+        inDegree[i] = predecessorStart[i + 1] - predecessorStart[i];
+
+    QVector<int> ready;
+    for (int i = 0; i < count; i++)
+        if (inDegree[i] == 0)
+            ready.append(i);
+
+    QVector<int> order;
+    order.reserve(count);
+    for (int next = 0; next < ready.size(); next++)
+    {
+        const int node = ready[next];
+        order.append(nodeIDs[node]);
+        for (int i = successorStart[node]; i < successorStart[node + 1]; i++)
+            if (--inDegree[successors[i]] == 0)
+                ready.append(successors[i]);
+    }
+
+    if (order.size() != count)
+        return std::nullopt;
+    return order;
+}
+
+}
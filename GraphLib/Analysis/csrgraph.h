@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <optional>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Compact copy of a graph's node-level structure in compressed sparse row form: successors of
+// the node at index i are successors[successorStart[i] .. successorStart[i + 1]), predecessors
+// likewise. Nodes are dense indices in the order of nodeIDs, parallel edges are kept once
+struct GRAPHLIB_EXPORT CsrGraph
+{
+    QVector<int> nodeIDs;
+    QHash<int, int> indices;
+    QVector<int> successorStart, successors;
+    QVector<int> predecessorStart, predecessors;
+
+    // Edges are (from node ID, to node ID), the ones with unknown nodes are skipped
+    static CsrGraph build(const QVector<int> &nodeIDs, const QVector<QPair<int, int>> &edges);
+
+    int nodeCount() const { return nodeIDs.size(); }
+    int index(int nodeID) const { return indices.value(nodeID, -1); }
+
+    // IDs of the nodes reachable from the node forward (downstream) or backward (upstream),
+    // the node itself only if it's on a cycle. Sorted
+    QVector<int> reachable(int nodeID, bool bIsForward) const;
+    // Components as node IDs, listed so that edges between them go from later to earlier ones
+    QVector<QVector<int>> stronglyConnectedComponents() const;
+    // Node IDs ordered so that every edge goes forward, nothing if there's a cycle
+    std::optional<QVector<int>> topologicalOrder() const;
+};
+
+}
@@ -0,0 +1,177 @@
+#include <QSet>
+#include <algorithm>
+
+#include "graphquery.h"
+
+namespace GraphLib {
+
+GraphQuery::GraphQuery()
+    : _successors{ QHash<int, QHash<int, int>>() }
+    , _predecessors{ QHash<int, QSet<int>>() }
+    , _snapshot{ std::nullopt }
+    , _downstream{ QHash<int, QVector<int>>() }
+    , _upstream{ QHash<int, QVector<int>>() }
+    , _components{ std::nullopt }
+    , _topologicalOrder{ std::nullopt }
+{}
+
+void GraphQuery::addNode(int nodeID)
+{
+    if (_successors.contains(nodeID))
+        return;
+
+    _successors.insert(nodeID, {});
+    _predecessors.insert(nodeID, {});
+    invalidate();
+}
+
+void GraphQuery::removeNode(int nodeID)
+{
+    auto node = _successors.find(nodeID);
+    if (node == _successors.end())
+        return;
+
+    const QHash<int, int> successors = std::move(node.value());
+    _successors.erase(node);
+    const QSet<int> predecessors = _predecessors.take(nodeID);
+
+    // a self-loop's other end is already gone
+    for (auto it = successors.cbegin(); it != successors.cend(); it++)
+    {
+        auto successor = _predecessors.find(it.key());
+        if (successor != _predecessors.end())
+            successor.value().remove(nodeID);
+    }
+    std::ranges::for_each(predecessors, [&](int predecessorID) {
+        auto predecessor = _successors.find(predecessorID);
+        if (predecessor != _successors.end())
+            predecessor.value().remove(nodeID);
+    });
+    invalidate();
+}
+
+void GraphQuery::addEdge(int fromNodeID, int toNodeID)
+{
+    if (!_successors.contains(fromNodeID) || !_successors.contains(toNodeID))
+        return;
+
+    if (_successors[fromNodeID][toNodeID]++ == 0)
+        _predecessors[toNodeID].insert(fromNodeID);
+    invalidate();
+}
+
+void GraphQuery::removeEdge(int fromNodeID, int toNodeID)
+{
+    auto node = _successors.find(fromNodeID);
+    if (node == _successors.end())
+        return;
+
+    auto edge = node.value().find(toNodeID);
+    if (edge == node.value().end())
+        return;
+
+    if (--edge.value() == 0)
+    {
+        node.value().erase(edge);
+        _predecessors[toNodeID].remove(fromNodeID);
+    }
+    invalidate();
+}
+
+void GraphQuery::clear()
+{
+    _successors.clear();
+    _predecessors.clear();
+    invalidate();
+}
+
+void GraphQuery::invalidate()
+{
+    _snapshot = std::nullopt;
+    _downstream.clear();
+    _upstream.clear();
+    _components = std::nullopt;
+    _topologicalOrder = std::nullopt;
+}
+
+bool GraphQuery::wouldCreateCycle(int fromNodeID, int toNodeID) const
+{
+    if (fromNodeID == toNodeID)
+        return true;
+
+    // a cached cone answers at once
+    auto cached = _downstream.constFind(toNodeID);
+    if (cached != _downstream.cend())
+        return std::ranges::binary_search(cached.value(), fromNodeID);
+
+    // otherwise the search stops at the from-node and never leaves what the to-node reaches
+    QSet<int> visited{ toNodeID };
+    QVector<int> stack{ toNodeID };
+    while (!stack.isEmpty())
+    {
+        auto node = _successors.constFind(stack.takeLast());
+        if (node == _successors.cend())
+            continue;
+
+        for (auto it = node.value().cbegin(); it != node.value().cend(); it++)
+        {
+            if (it.key() == fromNodeID)
+                return true;
+            if (!visited.contains(it.key()))
+            {
+                visited.insert(it.key());
+                stack.append(it.key());
+            }
+        }
+    }
+    return false;
+}
+
+const CsrGraph &GraphQuery::snapshot() const
+{
+    if (!_snapshot)
+    {
+        QVector<int> nodeIDs = _successors.keys();
+        std::ranges::sort(nodeIDs);
+
+        QVector<QPair<int, int>> edges;
+        for (auto node = _successors.cbegin(); node != _successors.cend(); node++)
+            for (auto it = node.value().cbegin(); it != node.value().cend(); it++)
+                edges.append({ node.key(), it.key() });
+
+        _snapshot = CsrGraph::build(nodeIDs, edges);
+    }
+    return *_snapshot;
+}
+
+QVector<int> GraphQuery::downstream(int nodeID) const
+{
+    auto it = _downstream.constFind(nodeID);
+    if (it == _downstream.cend())
+        it = _downstream.insert(nodeID, snapshot().reachable(nodeID, true));
+    return it.value();
+}
+
+QVector<int> GraphQuery::upstream(int nodeID) const
+{
+    auto it = _upstream.constFind(nodeID);
+    if (it == _upstream.cend())
+        it = _upstream.insert(nodeID, snapshot().reachable(nodeID, false));
+    return it.value();
+}
+
+const QVector<QVector<int>> &GraphQuery::stronglyConnectedComponents() const
+{
+    if (!_components)
+        _components = snapshot().stronglyConnectedComponents();
+    return *_components;
+}
+
+const std::optional<QVector<int>> &GraphQuery::topologicalOrder() const
+{
+    if (!_topologicalOrder)
+        _topologicalOrder = snapshot().topologicalOrder();
+    return *_topologicalOrder;
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <optional>
+
+#include "csrgraph.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Structural queries over the nodes of a canvas and the connections between them. Edits are
+// mirrored into node-level adjacency, so a connection can be checked for a cycle by searching
+// only the nodes reachable from it. Whole-graph queries run over a CsrGraph snapshot built
+// on demand; the snapshot and every result are cached until the next edit
+class GRAPHLIB_EXPORT GraphQuery
+{
+public:
+    GraphQuery();
+
+    void addNode(int nodeID);
+    // Removes the node's edges as well
+    void removeNode(int nodeID);
+    // Parallel edges are counted, the nodes stay connected until every one of them is removed
+    void addEdge(int fromNodeID, int toNodeID);
+    void removeEdge(int fromNodeID, int toNodeID);
+    void clear();
+
+    // Whether adding the edge would close a cycle, i.e. the from-node is downstream of the to-node
+    bool wouldCreateCycle(int fromNodeID, int toNodeID) const;
+    bool hasCycle() const { return !topologicalOrder().has_value(); }
+
+    // Nodes the node's outputs reach, and the nodes reaching its inputs; sorted IDs
+    QVector<int> downstream(int nodeID) const;
+    QVector<int> upstream(int nodeID) const;
+    const QVector<QVector<int>> &stronglyConnectedComponents() const;
+    // Nothing if there's a cycle
+    const std::optional<QVector<int>> &topologicalOrder() const;
+    const CsrGraph &snapshot() const;
+
+private:
+    void invalidate();
+
+    // Node -> its successor -> number of edges between them
+    QHash<int, QHash<int, int>> _successors;
+    // Node -> nodes with an edge to it, so a node is removed touching only its neighbours
+    QHash<int, QSet<int>> _predecessors;
+
+    mutable std::optional<CsrGraph> _snapshot;
+    mutable QHash<int, QVector<int>> _downstream;
+    mutable QHash<int, QVector<int>> _upstream;
+    mutable std::optional<QVector<QVector<int>>> _components;
+    mutable std::optional<std::optional<QVector<int>>> _topologicalOrder;
+};
+
+}
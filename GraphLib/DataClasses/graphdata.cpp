@@ -0,0 +1,114 @@
+#include <QDataStream>
+#include <QIODevice>
+
+#include "graphdata.h"
+#include "GraphWidgets/Abstracts/abstractpin.h"
+
+namespace GraphLib {
+
+namespace {
+
+const quint32 c_subgraphMagic = 0x474C5347; // "GLSG"
+const quint16 c_subgraphVersion = 1;
+
+}
+
+QByteArray Subgraph::toByteArray() const
+{
+    QByteArray output;
+    QDataStream stream(&output, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    stream << c_subgraphMagic << c_subgraphVersion;
+
+    stream << static_cast<quint32>(nodes.size());
+    for (const NodeRecord &node : nodes)
+    {
+        stream << static_cast<qint32>(node.nodeID) << static_cast<qint32>(node.typeID)
+               << node.canvasPosition.x() << node.canvasPosition.y();
+
+        // typed nodes are recreated from their type
+        if (node.typeID >= 0)
+            continue;
+
+        stream << node.name << static_cast<quint32>(node.pins.size());
+        for (const PinRecord &pin : node.pins)
+            stream << pin.text << static_cast<quint8>(pin.direction == PinDirection::In) << static_cast<quint32>(pin.color.rgba());
+    }
+
+    stream << static_cast<quint32>(edges.size());
+    for (const EdgeRecord &edge : edges)
+    {
+        stream << static_cast<qint32>(edge.outNodeID) << static_cast<qint32>(edge.outPinIndex)
+               << static_cast<qint32>(edge.inNodeID) << static_cast<qint32>(edge.inPinIndex);
+    }
+
+    return output;
+}
+
+Subgraph Subgraph::fromByteArray(const QByteArray &byteArray)
+{
+    QDataStream stream(byteArray);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+    if (magic != c_subgraphMagic || version != c_subgraphVersion)
+        return Subgraph();
+
+    // counts are checked against the data left, so a malformed header can't cause huge reservations
+    auto readCount = [&](qsizetype minRecordSize) -> qsizetype {
+        quint32 count = 0;
+        stream >> count;
+        qsizetype left = byteArray.size() - stream.device()->pos();
+        return count * minRecordSize <= left ? count : -1;
+    };
+
+    Subgraph subgraph;
+    qsizetype nodeCount = readCount(2 * sizeof(qint32) + 2 * sizeof(double));
+    if (nodeCount < 0)
+        return Subgraph();
+
+    subgraph.nodes.reserve(nodeCount);
+    for (qsizetype i = 0; i < nodeCount && stream.status() == QDataStream::Ok; i++)
+    {
+        qint32 nodeID, typeID;
+        double x, y;
+        stream >> nodeID >> typeID >> x >> y;
+        NodeRecord node{ nodeID, typeID, QPointF(x, y), QString(), QVector<PinRecord>() };
+
+        if (typeID < 0)
+        {
+            quint32 pinCount = 0;
+            stream >> node.name >> pinCount;
+            for (quint32 pin = 0; pin < pinCount && stream.status() == QDataStream::Ok; pin++)
+            {
+                QString text;
+                quint8 bIsIn;
+                quint32 rgba;
+                stream >> text >> bIsIn >> rgba;
+                node.pins.append({ text, bIsIn ? PinDirection::In : PinDirection::Out, QColor::fromRgba(rgba) });
+            }
+        }
+        subgraph.nodes.append(node);
+    }
+
+    qsizetype edgeCount = stream.status() == QDataStream::Ok ? readCount(4 * sizeof(qint32)) : -1;
+    if (edgeCount < 0)
+        return Subgraph();
+
+    subgraph.edges.reserve(edgeCount);
+    for (qsizetype i = 0; i < edgeCount; i++)
+    {
+        qint32 outNodeID, outPinIndex, inNodeID, inPinIndex;
+        stream >> outNodeID >> outPinIndex >> inNodeID >> inPinIndex;
+        subgraph.edges.append({ outNodeID, outPinIndex, inNodeID, inPinIndex });
+    }
+
+    if (stream.status() != QDataStream::Ok)
+        return Subgraph();
+    return subgraph;
+}
+
+}
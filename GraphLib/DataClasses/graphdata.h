@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QByteArray>
+#include <QColor>
+#include <QPointF>
+#include <QString>
+#include <QVector>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+enum class PinDirection;
+
+// Records describe graph contents independently of widgets, so removed parts of
+// a graph can be recreated. Pin IDs change when a node is recreated, so pins are
+// referred to by their index in the node (the order they were added in)
+
+struct GRAPHLIB_EXPORT PinRecord
+{
+    QString text;
+    PinDirection direction;
+    QColor color;
+
+    bool operator==(const PinRecord &other) const = default;
+};
+
+struct GRAPHLIB_EXPORT NodeRecord
+{
+    int nodeID;
+    // Typed nodes are recreated from their type, so name and pins are kept only for
+    // the nodes without a type (typeID is -1)
+    int typeID;
+    QPointF canvasPosition;
+    QString name;
+    QVector<PinRecord> pins;
+
+    bool operator==(const NodeRecord &other) const = default;
+};
+
+struct GRAPHLIB_EXPORT EdgeRecord
+{
+    int outNodeID, outPinIndex;
+    int inNodeID, inPinIndex;
+
+    bool operator==(const EdgeRecord &other) const = default;
+};
+
+// Nodes with the connections between them, e.g. a copied selection
+struct GRAPHLIB_EXPORT Subgraph
+{
+    QVector<NodeRecord> nodes;
+    QVector<EdgeRecord> edges;
+
+    QByteArray toByteArray() const;
+    // Returns an empty subgraph if the data is malformed
+    static Subgraph fromByteArray(const QByteArray &byteArray);
+
+    bool operator==(const Subgraph &other) const = default;
+};
+
+}
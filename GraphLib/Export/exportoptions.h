@@ -0,0 +1,20 @@
+#pragma once
+
+#include "constants.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+struct GRAPHLIB_EXPORT ExportOptions
+{
+    // Output pixels per canvas unit. Nodes are drawn with the detail the canvas
+    // would use at this zoom, so small scales give overview rects
+    double scale = 1.0;
+    // Empty canvas space around the graph, in canvas units
+    double margin = 40.0;
+    bool bDrawBackground = true;
+    // Raster exports render and keep at most this much of the image at once
+    qsizetype memoryBudgetBytes = c_exportMemoryBudgetBytes;
+};
+
+}
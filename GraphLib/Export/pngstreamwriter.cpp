@@ -0,0 +1,139 @@
+#include <QtEndian>
+#include <cstring>
+#include <zlib.h>
+
+#include "pngstreamwriter.h"
+#include "constants.h"
+
+namespace GraphLib {
+
+struct PngStreamWriter::Deflater
+{
+    z_stream stream{};
+    bool bIsInitialized = false;
+};
+
+PngStreamWriter::PngStreamWriter(QIODevice *device, QSize size)
+    : _device{ device }
+    , _size{ size }
+    , _rowsWritten{ 0 }
+    , _bIsValid{ false }
+    , _bIsFinished{ false }
+    , _deflater{ std::make_unique<Deflater>() }
+    , _compressed{ QByteArray() }
+    , _row{ QByteArray() }
+{
+    if (!device || !device->isWritable() || size.isEmpty())
+        return;
+
+    _deflater->bIsInitialized = deflateInit(&_deflater->stream, Z_DEFAULT_COMPRESSION) == Z_OK;
+    if (!_deflater->bIsInitialized)
+        return;
+
+    const char signature[] = { '\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n' };
+
+    // 8 bits per channel RGBA, no interlacing
+    QByteArray header(13, 0);
+    qToBigEndian<quint32>(size.width(), header.data());
+    qToBigEndian<quint32>(size.height(), header.data() + 4);
+    header[8] = 8;
+    header[9] = 6;
+
+    _bIsValid = device->write(signature, sizeof(signature)) == sizeof(signature) && writeChunk("IHDR", header);
+}
+
+PngStreamWriter::~PngStreamWriter()
+{
+    if (_deflater->bIsInitialized)
+        deflateEnd(&_deflater->stream);
+}
+
+bool PngStreamWriter::writeRows(const QImage &strip)
+{
+    if (!_bIsValid || _bIsFinished || strip.width() != _size.width() || _rowsWritten + strip.height() > _size.height())
+        return false;
+
+    const QImage rgba = strip.convertToFormat(QImage::Format_RGBA8888);
+    const qsizetype rowBytes = static_cast<qsizetype>(_size.width()) * 4;
+
+    // every row starts with its filter type, 0 means the bytes are as is
+    _row.resize(rowBytes + 1);
+    _row[0] = 0;
+    for (int y = 0; y < rgba.height(); y++)
+    {
+        std::memcpy(_row.data() + 1, rgba.constScanLine(y), rowBytes);
+        if (!deflate(reinterpret_cast<const uchar*>(_row.constData()), _row.size(), false))
+        {
+            _bIsValid = false;
+            return false;
+        }
+    }
+
+    _rowsWritten += rgba.height();
+    return true;
+}
+
+bool PngStreamWriter::finish()
+{
+    if (!_bIsValid || _bIsFinished)
+        return false;
+
+    _bIsFinished = true;
+    if (_rowsWritten != _size.height())
+        return false;
+
+    if (!deflate(nullptr, 0, true))
+        return false;
+    if (!_compressed.isEmpty() && !writeChunk("IDAT", _compressed))
+        return false;
+    return writeChunk("IEND", QByteArray());
+}
+
+bool PngStreamWriter::deflate(const uchar *data, qsizetype size, bool bIsLast)
+{
+    z_stream &stream = _deflater->stream;
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = static_cast<uInt>(size);
+
+    while (true)
+    {
+        // compressed data is collected into chunks of a fixed size
+        const qsizetype used = _compressed.size();
+        _compressed.resize(c_pngChunkBytes);
+        stream.next_out = reinterpret_cast<Bytef*>(_compressed.data() + used);
+        stream.avail_out = static_cast<uInt>(c_pngChunkBytes - used);
+
+        int result = ::deflate(&stream, bIsLast ? Z_FINISH : Z_NO_FLUSH);
+        _compressed.resize(c_pngChunkBytes - stream.avail_out);
+        if (result == Z_STREAM_ERROR)
+            return false;
+
+        bool bIsChunkFull = stream.avail_out == 0;
+        if (bIsChunkFull)
+        {
+            if (!writeChunk("IDAT", _compressed))
+                return false;
+            _compressed.resize(0);
+        }
+
+        if (bIsLast ? result == Z_STREAM_END : stream.avail_in == 0 && !bIsChunkFull)
+            return true;
+    }
+}
+
+bool PngStreamWriter::writeChunk(const char *type, const QByteArray &data)
+{
+    char length[4], crc[4];
+    qToBigEndian<quint32>(data.size(), length);
+
+    uLong checksum = crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+    checksum = crc32(checksum, reinterpret_cast<const Bytef*>(data.constData()), static_cast<uInt>(data.size()));
+    qToBigEndian<quint32>(checksum, crc);
+
+    return _device->write(length, 4) == 4
+        && _device->write(type, 4) == 4
+        && _device->write(data) == data.size()
+        && _device->write(crc, 4) == 4;
+}
+
+}
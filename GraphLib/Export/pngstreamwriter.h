@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QIODevice>
+#include <QSize>
+#include <memory>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Writes an RGBA PNG whose rows come in strips from top to bottom, so the whole
+// image never has to be in memory. The rows are deflated as they arrive
+class GRAPHLIB_EXPORT PngStreamWriter
+{
+public:
+    // Writes the header right away
+    PngStreamWriter(QIODevice *device, QSize size);
+    ~PngStreamWriter();
+
+    bool isValid() const { return _bIsValid; }
+    int rowsWritten() const { return _rowsWritten; }
+
+    // The strip must be as wide as the image. Returns false on an I/O error
+    // or if the strip doesn't fit into the rest of the image
+    bool writeRows(const QImage &strip);
+    // Returns false if some rows are missing or on an I/O error
+    bool finish();
+
+private:
+    struct Deflater;
+
+    bool deflate(const uchar *data, qsizetype size, bool bIsLast);
+    bool writeChunk(const char *type, const QByteArray &data);
+
+    QIODevice *_device;
+    QSize _size;
+    int _rowsWritten;
+    bool _bIsValid;
+    bool _bIsFinished;
+    std::unique_ptr<Deflater> _deflater;
+    QByteArray _compressed;
+    QByteArray _row;
+};
+
+}
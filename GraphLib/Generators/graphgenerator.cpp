@@ -0,0 +1,267 @@
+#include <QJsonArray>
+#include <QSet>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <random>
+
+#include "graphgenerator.h"
+#include "GraphWidgets/canvas.h"
+
+namespace GraphLib {
+
+namespace {
+
+// Standard distributions are implementation-defined, so values are derived
+// from the engine's output directly to keep graphs identical across platforms
+class Random
+{
+public:
+    explicit Random(quint32 seed) : _engine{ seed } {}
+
+    // In [0, bound)
+    int below(int bound) { return static_cast<int>((static_cast<quint64>(_engine()) * bound) >> 32); }
+    int between(int min, int max) { return min + below(max - min + 1); }
+    // In [0, 1)
+    double unit() { return _engine() / 4294967296.0; }
+
+private:
+    std::mt19937 _engine;
+};
+
+// Prefix sums of weights that change, so a weighted draw and an update are both O(log n)
+class FenwickTree
+{
+public:
+    explicit FenwickTree(qsizetype size) : _tree(size + 1, 0) {}
+
+    void add(qsizetype index, qint64 value)
+    {
+        for (qsizetype i = index + 1; i < _tree.size(); i += i & -i)
+            _tree[i] += value;
+    }
+
+    // Sum of the weights in [0, end)
+    qint64 prefix(qsizetype end) const
+    {
+        qint64 sum = 0;
+        for (qsizetype i = end; i > 0; i -= i & -i)
+            sum += _tree[i];
+        return sum;
+    }
+
+    // Index of the weight the value falls into, for a value in [0, total weight)
+    qsizetype find(qint64 value) const
+    {
+        qsizetype position = 0;
+        for (qsizetype step = std::bit_floor(static_cast<size_t>(_tree.size() - 1)); step > 0; step >>= 1)
+        {
+            if (position + step < _tree.size() && _tree[position + step] <= value)
+            {
+                position += step;
+                value -= _tree[position];
+            }
+        }
+        return position;
+    }
+
+private:
+    QVector<qint64> _tree;
+};
+
+// Cumulative weights of the degrees from 0 to maxDegree
+QVector<double> degreeWeights(DegreeDistribution distribution, int maxDegree)
+{
+    QVector<double> weights;
+    for (int k = 0; k <= maxDegree; k++)
+        weights.append(distribution == DegreeDistribution::PowerLaw ? 1.0 / ((k + 1) * (k + 1)) : 1.0);
+    std::partial_sum(weights.begin(), weights.end(), weights.begin());
+    return weights;
+}
+
+int drawDegree(Random &random, const QVector<double> &weights)
+{
+    double value = random.unit() * weights.last();
+    return static_cast<int>(std::ranges::upper_bound(weights, value) - weights.begin());
+}
+
+}
+
+GraphGenerator::GraphGenerator(const NodeTypeManager *nodeTypeManager, const PinTypeManager *pinTypeManager)
+{
+    auto pinTypes = [&](const QJsonValue &pins) {
+        QVector<int> result;
+        std::ranges::for_each(pins.toArray(), [&](const QJsonValue &pin) {
+            result.append(pinTypeManager->TypeNames().value(pin.toObject().value("type").toString(), -1));
+        });
+        return result;
+    };
+
+    _typePins.reserve(nodeTypeManager->Types().size());
+    std::ranges::for_each(nodeTypeManager->Types(), [&](const QJsonObject &type) {
+        _typePins.append({ pinTypes(type.value("in-pins")), pinTypes(type.value("out-pins")) });
+    });
+}
+
+GeneratedGraph GraphGenerator::generate(const GraphGeneratorOptions &options) const
+{
+    GeneratedGraph graph;
+    const int nodeCount = options.nodeCount;
+    if (nodeCount <= 0 || _typePins.isEmpty())
+        return graph;
+
+    Random random(options.seed);
+
+    // layers are contiguous ranges of node indices, a random graph is a single layer
+    const int layerCount = options.topology == GraphTopology::LayeredDag
+                               ? std::clamp(options.layerCount, 1, nodeCount) : 1;
+    auto layerOf = [&](int node) { return static_cast<int>(static_cast<qint64>(node) * layerCount / nodeCount); };
+    auto layerBegin = [&](int layer) {
+        return static_cast<int>((static_cast<qint64>(layer) * nodeCount + layerCount - 1) / layerCount);
+    };
+
+
+    // NODES
+
+    const int side = static_cast<int>(std::ceil(std::sqrt(nodeCount)));
+    struct Cluster { double x, y, radius; };
+    QVector<Cluster> clusters;
+    for (int i = 0; i < options.clusterCount; i++)
+    {
+        // clusters of the same size together take about the area of the grid
+        double radius = options.spacing * side / std::sqrt(options.clusterCount * std::numbers::pi);
+        clusters.append({ random.unit() * side * options.spacing, random.unit() * side * options.spacing, radius });
+    }
+
+    graph.nodes.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; i++)
+    {
+        QPoint position;
+        if (!clusters.isEmpty())
+        {
+            const Cluster &cluster = clusters[random.below(clusters.size())];
+            double distance = cluster.radius * std::sqrt(random.unit());
+            double angle = 2 * std::numbers::pi * random.unit();
+            position = QPoint(cluster.x + distance * std::cos(angle), cluster.y + distance * std::sin(angle));
+        }
+        else if (layerCount > 1)
+        {
+            int layer = layerOf(i);
+            position = QPoint(layer * options.spacing * 2, (i - layerBegin(layer)) * options.spacing);
+        }
+        else
+            position = QPoint(i % side * options.spacing, i / side * options.spacing);
+
+        graph.nodes.append({ random.below(_typePins.size()), position });
+    }
+
+
+    // EDGES
+
+    const QVector<double> fanOutWeights = degreeWeights(options.fanOutDistribution, std::max(options.maxFanOut, 0));
+
+    // pins of all nodes are numbered as pinsOffset[node] + pin index
+    QVector<int> inPinsOffset(nodeCount + 1, 0), outPinsOffset(nodeCount + 1, 0);
+    for (int i = 0; i < nodeCount; i++)
+    {
+        inPinsOffset[i + 1] = inPinsOffset[i] + _typePins[graph.nodes[i].typeID].in.size();
+        outPinsOffset[i + 1] = outPinsOffset[i] + _typePins[graph.nodes[i].typeID].out.size();
+    }
+    // connections every in-pin still accepts, drawn from 1 to maxFanIn
+    const qsizetype inPinsCount = inPinsOffset.last();
+    FenwickTree freeInPins(inPinsCount);
+    if (options.maxFanIn > 0)
+    {
+        const QVector<double> fanInWeights = degreeWeights(options.fanInDistribution, options.maxFanIn - 1);
+        for (qsizetype pin = 0; pin < inPinsCount; pin++)
+            freeInPins.add(pin, options.maxFanIn > 1 ? drawDegree(random, fanInWeights) + 1 : 1);
+    }
+
+    QSet<QPair<int, int>> usedPinPairs;
+    const int attempts = 8;
+
+    for (int source = 0; source < nodeCount; source++)
+    {
+        const QVector<int> &out = _typePins[graph.nodes[source].typeID].out;
+        if (out.isEmpty())
+            continue;
+
+        // targets are taken from the following layers only, which keeps a layered graph acyclic
+        const int targetsBegin = layerCount > 1 ? layerBegin(layerOf(source) + 1) : 0;
+        if (targetsBegin >= nodeCount)
+            continue;
+        const qint64 targetsWeightBegin = freeInPins.prefix(inPinsOffset[targetsBegin]);
+
+        for (int connections = drawDegree(random, fanOutWeights); connections > 0; connections--)
+        {
+            const qint64 targetsWeight = freeInPins.prefix(inPinsCount) - targetsWeightBegin;
+            if (targetsWeight <= 0)
+                break;
+
+            int outPin = random.below(out.size());
+            for (int attempt = 0; attempt < attempts; attempt++)
+            {
+                // an in-pin is drawn in proportion to the connections it still accepts
+                const qint64 value = targetsWeightBegin + std::min(static_cast<qint64>(random.unit() * targetsWeight), targetsWeight - 1);
+                const int pin = static_cast<int>(freeInPins.find(value));
+                const int target = static_cast<int>(std::ranges::upper_bound(inPinsOffset, pin) - inPinsOffset.begin()) - 1;
+                if (target == source)
+                    continue;
+
+                const int inPin = pin - inPinsOffset[target];
+                if (options.bMatchPinTypes && _typePins[graph.nodes[target].typeID].in[inPin] != out[outPin])
+                    continue;
+
+                QPair<int, int> pinPair(outPinsOffset[source] + outPin, pin);
+                if (usedPinPairs.contains(pinPair))
+                    continue;
+
+                usedPinPairs.insert(pinPair);
+                freeInPins.add(pin, -1);
+                graph.edges.append({ source, outPin, target, inPin });
+                break;
+            }
+        }
+    }
+
+    return graph;
+}
+
+QVector<int> GraphGenerator::populate(Canvas *canvas, const GeneratedGraph &graph) const
+{
+    QVector<QPair<QPoint, int>> spawns;
+    spawns.reserve(graph.nodes.size());
+    std::ranges::for_each(graph.nodes, [&](const GeneratedGraph::Node &node) {
+        spawns.append({ node.canvasPosition, node.typeID });
+    });
+
+    const QVector<QWeakPointer<BaseNode>> nodes = canvas->addTypedNodes(spawns);
+
+    // the factory creates in-pins and then out-pins in the order of the type,
+    // and pin IDs only grow, so the order of node's pins is the order of the type
+    auto pinData = [&](int node, PinDirection direction, int index) {
+        for (const AbstractPin *pin : nodes[node].toStrongRef()->pins())
+        {
+            if (pin->getDirection() == direction && index-- == 0)
+                return pin->getData();
+        }
+        return PinData();
+    };
+
+    QVector<QPair<PinData, PinData>> connections;
+    connections.reserve(graph.edges.size());
+    std::ranges::for_each(graph.edges, [&](const GeneratedGraph::Edge &edge) {
+        connections.append({ pinData(edge.outNode, PinDirection::Out, edge.outPin),
+                             pinData(edge.inNode, PinDirection::In, edge.inPin) });
+    });
+    canvas->connectPins(connections);
+
+    QVector<int> ids;
+    ids.reserve(nodes.size());
+    std::ranges::for_each(nodes, [&](const QWeakPointer<BaseNode> &node) { ids.append(node.toStrongRef()->ID()); });
+    return ids;
+}
+
+}
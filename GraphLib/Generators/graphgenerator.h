@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QPoint>
+#include <QVector>
+
+#include "TypeManagers/nodetypemanager.h"
+#include "TypeManagers/pintypemanager.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+class Canvas;
+
+enum class GraphTopology
+{
+    // Nodes are split into layers and connect only to the following ones
+    LayeredDag,
+    Random
+};
+
+enum class DegreeDistribution
+{
+    Uniform,
+    // Most nodes have few connections and a few have many, P(k) ~ 1 / (k + 1)^2
+    PowerLaw
+};
+
+struct GRAPHLIB_EXPORT GraphGeneratorOptions
+{
+    int nodeCount = 1000;
+    GraphTopology topology = GraphTopology::LayeredDag;
+    int layerCount = 10;
+
+    // Number of connections started by each node, from 0 to maxFanOut
+    DegreeDistribution fanOutDistribution = DegreeDistribution::Uniform;
+    int maxFanOut = 2;
+    // Number of connections each in-pin accepts, from 1 to maxFanIn. Targets are drawn in proportion
+    // to the connections their in-pins still accept, so the nodes' fan-in follows the distribution
+    DegreeDistribution fanInDistribution = DegreeDistribution::Uniform;
+    int maxFanIn = 1;
+    // Connect only pins of the same type
+    bool bMatchPinTypes = false;
+
+    // With no clusters nodes are placed on a grid, or in columns for a layered graph
+    int clusterCount = 0;
+    int spacing = 250;
+
+    quint32 seed = 0;
+};
+
+struct GRAPHLIB_EXPORT GeneratedGraph
+{
+    struct Node
+    {
+        int typeID;
+        QPoint canvasPosition;
+
+        bool operator==(const Node &other) const = default;
+    };
+
+    // Pins are referred to by their index among the in- or out-pins of the node's type
+    struct Edge
+    {
+        int outNode, outPin;
+        int inNode, inPin;
+
+        bool operator==(const Edge &other) const = default;
+    };
+
+    QVector<Node> nodes;
+    QVector<Edge> edges;
+};
+
+// Builds synthetic graphs from the loaded types. Output depends only on the options
+// and the types, the same seed gives the same graph on every platform
+class GRAPHLIB_EXPORT GraphGenerator
+{
+public:
+    GraphGenerator(const NodeTypeManager *nodeTypeManager, const PinTypeManager *pinTypeManager);
+
+    GeneratedGraph generate(const GraphGeneratorOptions &options) const;
+
+    // Adds the graph to the canvas using the bulk insertion path. Returns IDs of the added nodes
+    QVector<int> populate(Canvas *canvas, const GeneratedGraph &graph) const;
+    QVector<int> populate(Canvas *canvas, const GraphGeneratorOptions &options) const { return populate(canvas, generate(options)); }
+
+private:
+    // Pin type IDs of in- and out-pins of a node type, -1 for unknown pin types
+    struct TypePins
+    {
+        QVector<int> in, out;
+    };
+
+    QVector<TypePins> _typePins;
+};
+
+}
@@ -1,4 +1,4 @@
-QT += core gui widgets
+QT += core gui widgets concurrent svg
 
 TEMPLATE = lib
 DEFINES += GRAPHLIB_LIBRARY
@@ -9,34 +9,85 @@ CONFIG += c++latest
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Counts global heap allocations, so Canvas can check that steady-state repaints don't allocate
+graphlib_track_allocations: DEFINES += GRAPHLIB_TRACK_ALLOCATIONS
+
+# PNG export deflates its rows with zlib as they are rendered
+unix: LIBS += -lz
+win32: LIBS += -lzlib
+
 SOURCES += \
+    Analysis/csrgraph.cpp \
+    Analysis/graphquery.cpp \
+    DataClasses/graphdata.cpp \
     DataClasses/nodespawndata.cpp \
+    Export/pngstreamwriter.cpp \
     GraphWidgets/Abstracts/abstractpin.cpp \
     GraphWidgets/Abstracts/basenode.cpp \
+    Generators/graphgenerator.cpp \
+    History/commandjournal.cpp \
+    Layout/layeredlayout.cpp \
+    Layout/forcelayout.cpp \
+    Layout/edgerouter.cpp \
     NodeFactoryModule/nfbuttonminimize.cpp \
     NodeFactoryModule/nodefactory.cpp \
     NodeFactoryModule/nodefactorywidget.cpp \
+    NodeFactoryModule/palettemodel.cpp \
     GraphWidgets/canvas.cpp \
+    GraphWidgets/groupnode.cpp \
+    GraphWidgets/minimap.cpp \
     NodeFactoryModule/typednodeimage.cpp \
     TypeManagers/nodetypemanager.cpp \
+    TypeManagers/typecatalog.cpp \
+    TypeManagers/typecatalogcache.cpp \
+    TypeManagers/typecatalogwatcher.cpp \
+    TypeManagers/typemanager.cpp \
     GraphWidgets/pin.cpp \
     DataClasses/pindata.cpp \
     DataClasses/pindragsignal.cpp \
     TypeManagers/pintypemanager.cpp \
     GraphWidgets/typednode.cpp \
+    Render/allocationcounter.cpp \
+    Render/framearena.cpp \
+    Render/frameclock.cpp \
+    Render/frameprofiler.cpp \
+    Render/kineticpan.cpp \
+    Render/minimapraster.cpp \
+    Render/noderendercache.cpp \
+    Render/tilerenderer.cpp \
+    Search/nodesearchindex.cpp \
+    Selection/selectionset.cpp \
+    Spatial/spatialindex.cpp \
     utility.cpp
 
 HEADERS += \
+    Analysis/csrgraph.h \
+    Analysis/graphquery.h \
+    DataClasses/graphdata.h \
     DataClasses/nodespawndata.h \
+    Export/exportoptions.h \
+    Export/pngstreamwriter.h \
     GraphLib.h \
     GraphLib_global.h \
     GraphWidgets/Abstracts/abstractpin.h \
     GraphWidgets/Abstracts/basenode.h \
+    Generators/graphgenerator.h \
+    History/commandjournal.h \
+    Layout/layeredlayout.h \
+    Layout/forcelayout.h \
+    Layout/edgerouter.h \
+    Layout/layoutgraph.h \
     NodeFactoryModule/nfbuttonminimize.h \
     NodeFactoryModule/nodefactory.h \
     NodeFactoryModule/nodefactorywidget.h \
+    NodeFactoryModule/palettemodel.h \
     GraphWidgets/canvas.h \
+    GraphWidgets/groupnode.h \
+    GraphWidgets/minimap.h \
     NodeFactoryModule/typednodeimage.h \
+    TypeManagers/typecatalog.h \
+    TypeManagers/typecatalogcache.h \
+    TypeManagers/typecatalogwatcher.h \
     TypeManagers/typemanager.h \
     constants.h \
     TypeManagers/nodetypemanager.h \
@@ -45,6 +96,19 @@ HEADERS += \
     DataClasses/pindragsignal.h \
     TypeManagers/pintypemanager.h \
     GraphWidgets/typednode.h \
+    Render/allocationcounter.h \
+    Render/framearena.h \
+    Render/frameclock.h \
+    Render/frameprofiler.h \
+    Render/kineticpan.h \
+    Render/minimapraster.h \
+    Render/noderendercache.h \
+    Render/renderdetail.h \
+    Render/tilerenderer.h \
+    Render/zoomlevel.h \
+    Search/nodesearchindex.h \
+    Selection/selectionset.h \
+    Spatial/spatialindex.h \
     utility.h
 
 # Default rules for deployment.
@@ -8,6 +8,7 @@
 #include "constants.h"
 #include "utility.h"
 #include "GraphWidgets/canvas.h"
+#include "Render/renderdetail.h"
 
 namespace GraphLib {
 
@@ -22,15 +23,16 @@ AbstractPin::AbstractPin(int ID, BaseNode *parent)
     , _normalD{ c_normalPinD }
     , _bIsConnected{ false }
     , _text{ QString("") }
+    , _staticText{ cachedText() }
     , _connectedPins{ QMap<int, PinData>() }
     , _breakConnectionActions{ QMap<int, QAction*>() }
+    , _textWidths{ QHash<int, int>() }
     , _contextMenu{ QMenu(this) }
-    , _painter{ new QPainter() }
 {
     setAcceptDrops(true);
 }
 
-AbstractPin::~AbstractPin() { delete _painter; }
+AbstractPin::~AbstractPin() {}
 
 
 // ------------------- GENERAL ---------------------
@@ -44,6 +46,22 @@ void AbstractPin::setConnected(bool isConnected)
         _bIsConnected = true;
 }
 
+void AbstractPin::setColor(QColor color)
+{
+    _color = color;
+    if (_parentNode)
+        _parentNode->invalidateRender();
+}
+
+void AbstractPin::setText(QString text)
+{
+    _text = text;
+    _staticText.setText(text);
+    _textWidths.clear();
+    if (_parentNode)
+        _parentNode->invalidateRender();
+}
+
 void AbstractPin::addConnectedPin(PinData pin)
 {
     if (pin.pinDirection == _direction)
@@ -87,15 +105,24 @@ PinData AbstractPin::getData() const
 
 int AbstractPin::getDesiredWidth(float zoom) const
 {
-    if (_text == "" || zoom <= c_changeRenderZoomMultiplier)
+    if (_text == "" || renderDetailForZoom(zoom) <= RenderDetail::Simplified)
         return _normalD * zoom;
 
-    QFont font = standardFont(static_cast<int>(_normalD * zoom * c_pinFontSizeCoef));
-    QFontMetrics metrics(font);
-    int textWidth = metrics.size(Qt::TextSingleLine, _text).width();
+    int textWidth = getTextWidth(static_cast<int>(_normalD * zoom * c_pinFontSizeCoef));
     return static_cast<int>(textWidth + _normalD * 2 * zoom);
 }
 
+int AbstractPin::getTextWidth(int fontSize) const
+{
+    auto it = _textWidths.constFind(fontSize);
+    if (it == _textWidths.cend())
+    {
+        QFontMetrics metrics(standardFont(fontSize));
+        it = _textWidths.insert(fontSize, metrics.size(Qt::TextSingleLine, _text).width());
+    }
+    return it.value();
+}
+
 void AbstractPin::startDrag()
 {
     QDrag *drag = new QDrag(this);
@@ -198,53 +225,56 @@ void AbstractPin::dragLeaveEvent(QDragLeaveEvent *)
 // -------------------- PAINT ---------------------
 
 
-void AbstractPin::paintEvent(QPaintEvent *event)
+QRect AbstractPin::circleRect(float zoom) const
 {
-    _painter->begin(this);
-    _painter->setRenderHint(QPainter::Antialiasing, true);
-    paint(_painter, event);
-    _painter->end();
+    // D stands for diameter
+    int desiredD = _normalD * zoom;
+    QRect rectangle = QRect(0, 0, desiredD, desiredD);
+
+    if (_direction == PinDirection::Out && renderDetailForZoom(zoom) > RenderDetail::Simplified)
+    {
+        rectangle.setX(this->width() - desiredD);
+        rectangle.setWidth(desiredD);
+    }
+
+    return rectangle;
+}
+
+void AbstractPin::updateLayout(float zoom)
+{
+    setFixedSize(getDesiredWidth(zoom), _normalD * zoom);
+    _center = circleRect(zoom).center();
 }
 
-void AbstractPin::paint(QPainter *painter, QPaintEvent *)
+void AbstractPin::paintTo(QPainter *painter)
 {
 
-    float canvasZoom = _parentNode->getParentCanvasZoomMultiplier();
+    // drawn into the node's layout, which is made for a zoom level
+    float canvasZoom = _parentNode->layoutZoomMultiplier();
+    RenderDetail detail = renderDetailForZoom(canvasZoom);
+    bool bShouldSimplifyRender = detail <= RenderDetail::Simplified;
 
     // D stands for diameter
     int desiredD = _normalD * canvasZoom;
+    int fontSize = desiredD * c_pinFontSizeCoef;
 
     QPen pen(Qt::NoPen);
     painter->setPen(pen);
-    QFont font = standardFont(desiredD * c_pinFontSizeCoef);
-    painter->setFont(font);
+    painter->setFont(standardFont(fontSize));
     painter->setBrush(_color);
 
     int outlineWidth = c_globalOutlineWidth * canvasZoom;
 
-    QPoint desiredOrigin = mapFromParent(QPoint(this->pos()));
-    QPoint textOrigin = QPoint(desiredOrigin.x() + desiredD * 2, desiredOrigin.y());
-
-    QRect rectangle = QRect(desiredOrigin.x(), desiredOrigin.y(), desiredD, desiredD);
+    QPoint textOrigin = QPoint(desiredD * 2, 0);
 
-    QSize textBounding = painter->fontMetrics().size(Qt::TextSingleLine, _text);
-
-
-
-    if (_direction == PinDirection::Out && !(canvasZoom <= c_changeRenderZoomMultiplier))
-    {
-        rectangle.setX(this->width() - desiredD);
-        rectangle.setWidth(desiredD);
-    }
-
-    _center = rectangle.center();
+    QRect rectangle = circleRect(canvasZoom);
 
 
     // Drawing main circle
     painter->drawEllipse(rectangle);
 
     // If needed, draw inner circle the color of the background
-    if (!(_bIsConnected || canvasZoom <= c_changeRenderZoomMultiplier))
+    if (!(_bIsConnected || bShouldSimplifyRender))
     {
         painter->setBrush(c_nodesBackgroundColor);
         QRect innerRect = QRect(rectangle.x() + outlineWidth
@@ -257,17 +287,21 @@ void AbstractPin::paint(QPainter *painter, QPaintEvent *)
 
 
     // Text-related stuff
-    if (_text != "" && !(canvasZoom <= c_changeRenderZoomMultiplier))
+    if (_text != "" && !bShouldSimplifyRender)
     {
         pen.setStyle(Qt::SolidLine);
         pen.setColor(_color);
         painter->setPen(pen);
 
+        int textWidth = getTextWidth(fontSize);
         if (_direction == PinDirection::Out)
-            textOrigin.setX(this->width() - desiredD * 2 - textBounding.width());
+            textOrigin.setX(this->width() - desiredD * 2 - textWidth);
 
-        painter->drawText(QRect(textOrigin.x(), textOrigin.y(), textBounding.width(), rectangle.height())
-                          , Qt::AlignVCenter, _text);
+        QRect textRect(textOrigin.x(), textOrigin.y(), textWidth, rectangle.height());
+        if (detail == RenderDetail::Reduced)
+            drawCachedText(painter, textRect, _staticText);
+        else
+            painter->drawText(textRect, Qt::AlignVCenter, _text);
     }
 }
 
@@ -14,6 +14,8 @@
 #include <QByteArray>
 #include <QDropEvent>
 #include <QMenu>
+#include <QHash>
+#include <QStaticText>
 
 #include "GraphLib_global.h"
 #include "DataClasses/pindata.h"
@@ -40,9 +42,10 @@ public:
 
     void setID(int newID) { _ID = newID; }
     void setConnected(bool isConnected);
-    void setColor(QColor color) { _color = color; }
+    // Both redraw the node's cached image
+    void setColor(QColor color);
     void setNormalD(float newD) { _normalD = newD; }
-    void setText(QString text) { _text = text; }
+    void setText(QString text);
     void setDirection(PinDirection dir) { _direction = dir; }
     void addConnectedPin(PinData pin);
     void removeConnectedPinByID(int ID);
@@ -60,8 +63,14 @@ public:
     QPixmap getPixmap() const;
     PinData getData() const;
 
+    // Resizes the pin for the zoom and places its circle. Called by the node's layout
+    void updateLayout(float zoom);
+    // Pins are drawn into their node's cached image, so they don't paint themselves
+    void paintTo(QPainter *painter);
+
     // int here is pinID of connected pin
     QVector<PinData> getConnectedPins() const { return _connectedPins.values(); }
+    const QMap<int, PinData> &connectedPins() const { return _connectedPins; }
 
     static bool static_isInPin(const AbstractPin *pin) { return pin->getDirection() == PinDirection::In; }
 
@@ -71,14 +80,14 @@ signals:
     void onConnectionBreak(PinData outPin, PinData Pin);
 
 protected:
-    void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void dropEvent(QDropEvent *event) override;
     void dragEnterEvent(QDragEnterEvent *event) override;
     void dragLeaveEvent(QDragLeaveEvent *event) override;
 
 private:
-    void paint(QPainter *painter, QPaintEvent *event);
+    QRect circleRect(float zoom) const;
+    int getTextWidth(int fontSize) const;
     void startDrag();
     void showContextMenu(const QMouseEvent *event);
 
@@ -88,15 +97,17 @@ private:
     float _normalD;
     bool _bIsConnected;
     QString _text;
+    // Glyph run of the text used at RenderDetail::Reduced
+    QStaticText _staticText;
     PinDirection _direction;
     QPoint _center;
     // int here is pinID of connected pin
     QMap<int, PinData> _connectedPins;
     QMap<int, QAction*> _breakConnectionActions;
+    // Text width by font size, so the layout doesn't measure the text every frame
+    mutable QHash<int, int> _textWidths;
 
     QMenu _contextMenu;
-
-    QPainter *_painter;
 };
 
 }
@@ -9,6 +9,7 @@
 #include "utility.h"
 #include "constants.h"
 #include "GraphWidgets/pin.h"
+#include "Render/renderdetail.h"
 
 namespace GraphLib {
 
@@ -19,25 +20,28 @@ BaseNode::BaseNode(int ID, Canvas *canvas)
     : QWidget{ canvas }
     , _parentCanvas{ canvas }
     , _ID{ ID }
-    , _zoom{ _parentCanvas->getZoomMultiplier() }
+    , _zoom{ _parentCanvas->getLevelZoomMultiplier() }
     , _painter{ new QPainter() }
     , _canvasPosition{ QPointF(0, 0) }
     , _hiddenPosition{ QPointF() }
-    , _bIsSelected{ false }
     , _lastMouseDownPosition{ QPointF(0, 0) }
     , _mousePressPosition{ QPointF(0, 0) }
+    , _bIsDragged{ false }
     , _name{ QString("") }
+    , _nameStaticText{ cachedText() }
     , _pinsOutlineCoords{ QMap<int, QPoint>() }
+    , _pinsLayoutPositions{ QMap<int, QPoint>() }
+    , _pinsPlacementZoom{ 0.0f }
     , _pins{ QMap<int, AbstractPin*>() }
+    , _bIsLayoutDirty{ true }
+    , _layoutZoomLevel{ 0 }
+    , _layoutSize{ QSize() }
+    , _renderGeneration{ newRenderGeneration() }
 {
     _normalSize.setWidth(200);
     _normalSize.setHeight(150);
 
     this->setFixedSize(_normalSize);
-
-    connect(this, &BaseNode::onSelect, this, [this](){
-        _bIsSelected = true;
-    });
 }
 
 BaseNode::~BaseNode()
@@ -47,6 +51,7 @@ BaseNode::~BaseNode()
 }
 
 unsigned int BaseNode::IDgenerator = 0;
+quint64 BaseNode::renderGenerator = 0;
 
 
 // ------------------- GENERAL --------------------
@@ -68,12 +73,22 @@ float BaseNode::getParentCanvasZoomMultiplier() const
     return _parentCanvas->getZoomMultiplier();
 }
 
+bool BaseNode::isSelected() const
+{
+    return _parentCanvas->isNodeSelected(_ID);
+}
+
+QPoint BaseNode::getOutlineCoordinateForPinID(int pinID) const
+{
+    return _parentCanvas->mapFromCanvas(getCanvasOutlineCoordinateForPinID(pinID)).toPoint();
+}
+
 QRect BaseNode::getMappedRect() const
 {
-    QRect nodeRect = this->rect();
-    QPoint mappedTopLeft = this->mapToParent(nodeRect.topLeft());
-    QRect mapped(mappedTopLeft.x(), mappedTopLeft.y(), nodeRect.width(), nodeRect.height());
-    return mapped;
+    // computed from the canvas position, so it stays valid while the widget is hidden
+    // (e.g. at RenderDetail::Overview) and its geometry isn't updated
+    QPoint mappedTopLeft = _parentCanvas->mapFromCanvas(_canvasPosition).toPoint();
+    return QRect(mappedTopLeft, _normalSize * getParentCanvasZoomMultiplier());
 }
 
 bool BaseNode::hasPinConnections() const
@@ -83,11 +98,13 @@ bool BaseNode::hasPinConnections() const
     });
 }
 
-QSharedPointer< QMap<int, QVector<PinData> > > BaseNode::getPinConnections() const
+std::pmr::vector<std::pair<int, PinData>> BaseNode::getPinConnections(std::pmr::memory_resource *resource) const
 {
-    auto out = QSharedPointer<QMap<int, QVector<PinData> >>(new QMap<int, QVector<PinData> >());
+    std::pmr::vector<std::pair<int, PinData>> out(resource);
     std::ranges::for_each(_pins, [&](AbstractPin *pin){
-        out->insert(pin->ID(), pin->getConnectedPins());
+        std::ranges::for_each(pin->connectedPins(), [&](const PinData &connected){
+            out.emplace_back(pin->ID(), connected);
+        });
     });
     return out;
 }
@@ -97,6 +114,29 @@ void BaseNode::removePinConnection(int pinID, int connectedPinID)
     _pins[pinID]->removeConnectedPinByID(connectedPinID);
 }
 
+void BaseNode::invalidateRender()
+{
+    _renderGeneration = newRenderGeneration();
+    _bIsLayoutDirty = true;
+    update();
+}
+
+std::optional<NodeRenderKey> BaseNode::renderKey() const
+{
+    if (_pins.size() > c_nodeRenderCacheMaxPins)
+        return std::nullopt;
+
+    quint64 connectedPins = 0;
+    int i = 0;
+    std::ranges::for_each(_pins, [&](const AbstractPin *pin){
+        if (pin->isConnected())
+            connectedPins |= quint64(1) << i;
+        i++;
+    });
+
+    return NodeRenderKey{ _ID, _renderGeneration, _layoutZoomLevel, isSelected(), connectedPins };
+}
+
 
 // -------------------- SLOTS ---------------------
 
@@ -109,6 +149,7 @@ void BaseNode::addPin(AbstractPin *pin)
     connect(pin, &AbstractPin::onConnect, this, &BaseNode::slot_onPinConnect);
     connect(pin, &AbstractPin::onConnectionBreak, this, &BaseNode::slot_onPinConnectionBreak);
     pin->show();
+    invalidateRender();
 }
 
 void BaseNode::addPin(QString text, PinDirection direction, QColor color)
@@ -122,6 +163,17 @@ void BaseNode::addPin(QString text, PinDirection direction, QColor color)
     addPin(newPin);
 }
 
+void BaseNode::removePin(int pinID)
+{
+    AbstractPin *pin = _pins.take(pinID);
+    if (!pin)
+        return;
+    _pinsOutlineCoords.remove(pinID);
+    _pinsLayoutPositions.remove(pinID);
+    delete pin;
+    invalidateRender();
+}
+
 void BaseNode::slot_onPinDrag(PinDragSignal signal)
 {
     switch (signal.type())
@@ -154,13 +206,18 @@ void BaseNode::mousePressEvent(QMouseEvent *event)
         _lastMouseDownPosition = mapToParent(event->position());
         _mousePressPosition = event->position();
         _hiddenPosition = _canvasPosition;
+        _bIsDragged = false;
     }
 }
 
 void BaseNode::mouseReleaseEvent(QMouseEvent *event)
 {
     this->setCursor(QCursor(Qt::CursorShape::ArrowCursor));
-    onSelect(event->modifiers() & c_multiSelectionModifier, _ID);
+    // a dragged selection stays selected as a whole
+    if (!_bIsDragged)
+        onSelect(event->modifiers() & c_multiSelectionModifier, _ID);
+    _bIsDragged = false;
+    onMoveFinished(_ID);
 }
 
 void BaseNode::mouseMoveEvent(QMouseEvent *event)
@@ -170,19 +227,27 @@ void BaseNode::mouseMoveEvent(QMouseEvent *event)
         if ((event->position() - _mousePressPosition).manhattanLength()
             > QApplication::startDragDistance())
         {
+            _bIsDragged = true;
             this->setCursor(QCursor(Qt::CursorShape::OpenHandCursor));
-            if (!_bIsSelected)
+            if (!isSelected())
                 onSelect(event->modifiers() & c_multiSelectionModifier, _ID);
         }
 
+        // the node is moved by the canvas on its next frame, so the position
+        // the drag has reached is kept here and only the dragged node is snapped
         QPointF offset = mapToParent(event->position()) - _lastMouseDownPosition;
+        float zoomMult = getParentCanvasZoomMultiplier();
+        _hiddenPosition += (offset / zoomMult);
+
+        QPointF target = _hiddenPosition;
         if (_parentCanvas->getSnappingEnabled())
+            target = snap(_hiddenPosition, _parentCanvas->getSnappingInterval());
+
+        if (target != _canvasPosition)
         {
-            _hiddenPosition += (offset / _zoom);
-            _canvasPosition = snap(_hiddenPosition, _parentCanvas->getSnappingInterval());
+            _bIsDragged = true;
+            onDrag(_ID, target);
         }
-        else
-            _canvasPosition += (offset / _zoom);
 
         _lastMouseDownPosition = mapToParent(event->position());
     }
@@ -213,20 +278,19 @@ void BaseNode::paintSimplifiedName(QPainter *painter, int desiredWidth, QPoint t
 
 int BaseNode::calculateRowsOffset(QPainter *painter) const
 {
-    QFont font = standardFont(c_nodeNameSize * _zoom);
-    painter->setFont(font);
-    QSize nameBounding = painter->fontMetrics().size(Qt::TextSingleLine, _name);
-    return nameBounding.height() * 1.5 + c_normalPinD * _zoom;
+    painter->setFont(standardFont(c_nodeNameSize * _zoom));
+    return painter->fontMetrics().height() * 1.5 + c_normalPinD * _zoom;
 }
 
 void BaseNode::paintName(QPainter *painter, int desiredWidth, QPoint textOrigin)
 {
-    QSize nameBounding = painter->fontMetrics().size(Qt::TextSingleLine, _name);
-    QFont font = standardFont(c_nodeNameSize * _zoom);
-    painter->setFont(font);
+    painter->setFont(standardFont(c_nodeNameSize * _zoom));
+    QRect nameRect(textOrigin.x(), textOrigin.y(), desiredWidth, painter->fontMetrics().height() * 2);
 
-    painter->drawText(QRect(textOrigin.x(), textOrigin.y(), desiredWidth, nameBounding.height() * 2),
-                      (Qt::AlignVCenter | Qt::AlignHCenter), _name);
+    if (renderDetailForZoom(_zoom) == RenderDetail::Reduced)
+        drawCachedText(painter, nameRect, _nameStaticText);
+    else
+        painter->drawText(nameRect, (Qt::AlignVCenter | Qt::AlignHCenter), _name);
 }
 
 
@@ -235,16 +299,80 @@ void BaseNode::paintName(QPainter *painter, int desiredWidth, QPoint textOrigin)
 
 void BaseNode::paintEvent(QPaintEvent *event)
 {
+    FrameProfiler::ScopedPhase phase(_parentCanvas->frameProfiler(), FramePhase::WidgetCompositing);
+
     _painter->begin(this);
     _painter->setRenderHint(QPainter::Antialiasing, true);
     paint(_painter, event);
     _painter->end();
 }
 
+void BaseNode::ensureLayout(QPainter *painter)
+{
+    if (_bIsLayoutDirty || _layoutZoomLevel != _parentCanvas->getZoomLevel())
+        updateLayout(painter);
+}
+
+void BaseNode::placePins(float zoomMult)
+{
+    if (_pinsPlacementZoom == zoomMult)
+        return;
+
+    _pinsPlacementZoom = zoomMult;
+    const float scale = zoomMult / _zoom;
+    std::ranges::for_each(_pins, [&](AbstractPin *pin){
+        pin->move((QPointF(_pinsLayoutPositions.value(pin->ID())) * scale).toPoint());
+    });
+}
+
 void BaseNode::paint(QPainter *painter, QPaintEvent *)
 {
-    _zoom = _parentCanvas->getZoomMultiplier();
-    bool bShouldSimplifyRender = _zoom <= c_changeRenderZoomMultiplier;
+    ensureLayout(painter);
+
+    // the layout is made for the zoom level, the node is scaled to the exact zoom
+    const qreal scale = getParentCanvasZoomMultiplier() / _zoom;
+    if (scale != 1.0)
+    {
+        painter->scale(scale, scale);
+        painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    }
+
+    std::optional<NodeRenderKey> key = renderKey();
+    if (!key)
+    {
+        render(painter);
+        return;
+    }
+
+    NodeRenderCache &cache = _parentCanvas->nodeRenderCache();
+    if (const QPixmap *cached = cache.find(*key))
+    {
+        painter->drawPixmap(0, 0, *cached);
+        return;
+    }
+
+    qreal pixelRatio = devicePixelRatioF();
+    QPixmap pixmap(_layoutSize * pixelRatio);
+    pixmap.setDevicePixelRatio(pixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter pixmapPainter(&pixmap);
+    pixmapPainter.setRenderHint(QPainter::Antialiasing, true);
+    render(&pixmapPainter);
+    pixmapPainter.end();
+
+    painter->drawPixmap(0, 0, pixmap);
+    cache.insert(*key, pixmap);
+}
+
+void BaseNode::updateLayout(QPainter *painter)
+{
+    _zoom = _parentCanvas->getLevelZoomMultiplier();
+    _layoutZoomLevel = _parentCanvas->getZoomLevel();
+    _bIsLayoutDirty = false;
+    _pinsPlacementZoom = _zoom;
+
+    bool bShouldSimplifyRender = renderDetailForZoom(_zoom) <= RenderDetail::Simplified;
     int normalPinDZoomed = c_normalPinD * _zoom;
 
     auto calculateWidth = [&](){
@@ -269,29 +397,60 @@ void BaseNode::paint(QPainter *painter, QPaintEvent *)
     int inPins = std::ranges::count_if(_pins, &AbstractPin::static_isInPin);
     int pinRows = std::max(inPins, static_cast<int>(_pins.size() - inPins));
 
-    QPen pen(Qt::NoPen);
-    painter->setPen(pen);
-
     int pinsOffsetY = calculateRowsOffset(painter);
 
     int desiredWidth = calculateWidth();
     int desiredHeight = pinsOffsetY + pinRows * normalPinDZoomed * 2;
+    _layoutSize = QSize(desiredWidth, desiredHeight);
 
     _normalSize.setWidth(desiredWidth / _zoom);
     _normalSize.setHeight(desiredHeight / _zoom);
 
+    // place PINS
+    int inPinsOffsetY = pinsOffsetY;
+    int outPinsOffsetY = pinsOffsetY;
+
+    std::ranges::for_each(_pins, [&](AbstractPin *pin){
+        switch (pin->getDirection())
+        {
+        case PinDirection::In:
+            pin->move(QPoint(normalPinDZoomed, inPinsOffsetY));
+            inPinsOffsetY += 2 * normalPinDZoomed;
+            break;
+        case PinDirection::Out:
+            pin->move(QPoint(desiredWidth - normalPinDZoomed - pin->getDesiredWidth(_zoom), outPinsOffsetY));
+            outPinsOffsetY += 2 * normalPinDZoomed;
+            break;
+        default:;
+        }
+
+        pin->updateLayout(_zoom);
+        _pinsLayoutPositions[pin->ID()] = pin->pos();
+        _pinsOutlineCoords[pin->ID()] = QPoint(pin->isInPin() ? 0 : desiredWidth, pin->getCenter().y());
+    });
+}
+
+void BaseNode::render(QPainter *painter)
+{
+    bool bShouldSimplifyRender = renderDetailForZoom(_zoom) <= RenderDetail::Simplified;
+    int desiredWidth = _layoutSize.width();
+    int desiredHeight = _layoutSize.height();
+
+    QPen pen(Qt::NoPen);
+    painter->setPen(pen);
+
     int outlineWidth = static_cast<int>(std::min(c_globalOutlineWidth * _zoom, c_nodeMaxOutlineWidth));
     int innerWidth = desiredWidth - outlineWidth * 2;
     int innerHeight = desiredHeight - outlineWidth * 2;
 
     float innerRoundingRadius = _zoom * c_nodeRoundingRadius;
 
-    QPoint desiredOrigin = mapFromParent(QPoint(this->pos()));
+    QPoint desiredOrigin(0, 0);
 
     QPainterPath path;
 
     // paint OUTER
-    if (_bIsSelected)
+    if (isSelected())
     {
         QPen pen(Qt::SolidLine);
         pen.setColor(c_selectionColor);
@@ -319,6 +478,8 @@ void BaseNode::paint(QPainter *painter, QPaintEvent *)
 
         const QPoint &textOrigin = desiredOrigin;
 
+        painter->setFont(standardFont(c_nodeNameSize * _zoom));
+
         if (bShouldSimplifyRender)
             paintSimplifiedName(painter, desiredWidth, textOrigin);
         else
@@ -326,39 +487,25 @@ void BaseNode::paint(QPainter *painter, QPaintEvent *)
     }
 
 
-    // manage PINS
+    // paint PINS
     {
         pen.setWidth(c_pinConnectLineWidth * _zoom);
 
-        int inPinsOffsetY = pinsOffsetY;
-        int outPinsOffsetY = pinsOffsetY;
-
-        auto manage = [&](AbstractPin *pin){
-            switch (pin->getDirection())
-            {
-            case PinDirection::In:
-                pin->move(QPoint(normalPinDZoomed, inPinsOffsetY));
-                inPinsOffsetY += 2 * normalPinDZoomed;
-                break;
-            case PinDirection::Out:
-                pin->move(QPoint(desiredWidth - normalPinDZoomed - pin->getDesiredWidth(_zoom), outPinsOffsetY));
-                outPinsOffsetY += 2 * normalPinDZoomed;
-                break;
-            default:;
-            }
-
-            pin->setFixedSize(pin->getDesiredWidth(_zoom), pin->getNormalD() * _zoom);
-            _pinsOutlineCoords[pin->ID()] = QPoint(pin->isInPin() ? 0 : desiredWidth, pin->getCenter().y());
-
+        std::ranges::for_each(_pins, [&](AbstractPin *pin){
             if (pin->isConnected())
             {
                 pen.setColor(pin->getColor());
                 painter->setPen(pen);
                 painter->drawLine(_pinsOutlineCoords[pin->ID()], pin->getCenter());
             }
-        };
+        });
 
-        std::ranges::for_each(_pins, manage);
+        std::ranges::for_each(_pins, [&](AbstractPin *pin){
+            painter->save();
+            painter->translate(pin->pos());
+            pin->paintTo(painter);
+            painter->restore();
+        });
     }
 }
 
@@ -8,9 +8,15 @@
 #include <QPaintEvent>
 #include <QFont>
 #include <QFontMetrics>
+#include <QStaticText>
 #include <QMap>
+#include <memory_resource>
+#include <vector>
+#include <iterator>
+#include <optional>
 
 #include "abstractpin.h"
+#include "Render/noderendercache.h"
 #include "GraphLib_global.h"
 
 namespace GraphLib {
@@ -30,31 +36,64 @@ public:
     int ID() const { return _ID; }
     const QSize &normalSize() const { return _normalSize; }
     float getParentCanvasZoomMultiplier() const;
+    // Zoom multiplier the node was last laid out for, it's the multiplier of a zoom level.
+    // The node is scaled from it to the canvas' exact zoom when painted
+    float layoutZoomMultiplier() const { return _zoom; }
     const QString &name() const { return _name; }
-    QPoint getOutlineCoordinateForPinID(int pinID) const { return mapToParent(_pinsOutlineCoords[pinID]); }
+    QPoint getOutlineCoordinateForPinID(int pinID) const;
+    // Same point in canvas coordinates, valid once the node has been laid out
+    QPointF getCanvasOutlineCoordinateForPinID(int pinID) const { return _canvasPosition + QPointF(_pinsOutlineCoords.value(pinID)) / _zoom; }
     bool hasPinConnections() const;
-    QSharedPointer< QMap<int, QVector<PinData> > > getPinConnections() const;
+    // Pairs of (pinID, connected pin). Pass a FrameArena resource for temporaries
+    std::pmr::vector<std::pair<int, PinData>> getPinConnections(std::pmr::memory_resource *resource = std::pmr::get_default_resource()) const;
     const AbstractPin *getPinByID(int pinID) const { return _pins[pinID]; }
+    const QMap<int, AbstractPin*> &pins() const { return _pins; }
+    // Index of the pin in the order the pins were added
+    int getPinIndex(int pinID) const { return static_cast<int>(std::distance(_pins.cbegin(), _pins.constFind(pinID))); }
+    // nullptr if the node has no pin with the index
+    const AbstractPin *getPinByIndex(int index) const { return index >= 0 && index < _pins.size() ? *std::next(_pins.cbegin(), index) : nullptr; }
     QRect getMappedRect() const;
     const Canvas *getParentCanvas() const { return _parentCanvas; }
     const QString &getName() const { return _name; }
+    // The canvas keeps the selection, see SelectionSet
+    bool isSelected() const;
 
     void setCanvasPosition(QPointF newCanvasPosition) { _canvasPosition = newCanvasPosition; }
     void setID(int ID) { _ID = ID; }
     void setNormalSize(QSize newSize) { _normalSize = newSize; }
-    void setName(QString name) { _name = name; }
+    void setName(QString name) { _name = name; _nameStaticText.setText(name); invalidateRender(); onRename(_ID, _name); }
     void removePinConnection(int pinID, int connectedPinID);
     void setPinConnection(int pinID, PinData connectedPin);
     void setPinConnected(int pinID, bool isConnected);
-    void setSelected(bool b, bool bIsMultiSelectionModifierDown = false) { _bIsSelected = b; if (b) onSelect(bIsMultiSelectionModifierDown, _ID); }
+    void setSelected(bool b, bool bIsMultiSelectionModifierDown = false) { if (b) onSelect(bIsMultiSelectionModifierDown, _ID); else onDeselect(_ID); }
 
     void moveCanvasPosition(QPointF vector) { _canvasPosition += vector; }
 
+    // Drops the cached image and the layout of the node, call it after changing anything
+    // its appearance depends on besides zoom, selection and pins connection
+    void invalidateRender();
+    // Changes with every invalidateRender, the cached images of older generations aren't used
+    quint64 renderGeneration() const { return _renderGeneration; }
+
+    // Lays the node out for the canvas' current zoom level if it isn't already
+    void ensureLayout(QPainter *painter);
+    // Moves the pins' widgets to where they are drawn at the zoom, so they're hit there
+    void placePins(float zoomMult);
+    // Draws the node at its layout zoom with the origin at its top-left corner,
+    // bypassing the render cache. Used to paint the node outside of its widget, e.g. for export
+    void renderTo(QPainter *painter) { render(painter); }
+
 signals:
     void onSelect(bool bIsMultiSelectionModifierDown, int nodeID);
+    void onDeselect(int nodeID);
     void onPinDrag(PinDragSignal signal);
     void onPinConnect(PinData outPin, PinData inPin);
     void onPinConnectionBreak(PinData outPin, PinData inPin);
+    // Where the node is dragged to, emitted for every step of a drag. The canvas moves the node
+    // and the rest of the selection along with it. The other one is emitted once the drag is finished
+    void onDrag(int nodeID, QPointF canvasPosition);
+    void onMoveFinished(int nodeID);
+    void onRename(int nodeID, const QString &name);
 
 public slots:
     void addPin(AbstractPin *pin);
@@ -76,6 +115,9 @@ private:
 // -------------------- RENDER HELPERS -----------------------
 
     void paint(QPainter *painter, QPaintEvent *event);
+    void updateLayout(QPainter *painter);
+    void render(QPainter *painter);
+    std::optional<NodeRenderKey> renderKey() const;
     virtual void paintSimplifiedName(QPainter *painter, int desiredWidth, QPoint textOrigin);
     virtual void paintName(QPainter *painter, int desiredWidth, QPoint textOrigin);
     virtual int calculateRowsOffset(QPainter *painter) const;
@@ -85,6 +127,11 @@ private:
 protected:
     static unsigned int newID() { return IDgenerator++; }
     static unsigned int IDgenerator;
+    static quint64 newRenderGeneration() { return ++renderGenerator; }
+    static quint64 renderGenerator;
+
+    // Deletes the pin, it's expected to have no connections left
+    void removePin(int pinID);
 
     const Canvas *_parentCanvas;
     int _ID;
@@ -94,13 +141,25 @@ protected:
     QPointF _canvasPosition;
     // Hidden position is used when the node is being moved for snapping
     QPointF _hiddenPosition;
-    bool _bIsSelected;
     QPointF _lastMouseDownPosition;
     QPointF _mousePressPosition;
+    // The press has turned into a drag, its release doesn't select the node
+    bool _bIsDragged;
     QString _name;
+    // Glyph run of the name used at RenderDetail::Reduced
+    QStaticText _nameStaticText;
     QMap<int, QPoint> _pinsOutlineCoords;
+    // Pins' positions at the layout zoom and the zoom the widgets are placed for
+    QMap<int, QPoint> _pinsLayoutPositions;
+    float _pinsPlacementZoom;
 
     QMap<int, AbstractPin*> _pins;
+
+    // Layout is recalculated only when zoom level changes or it's invalidated
+    bool _bIsLayoutDirty;
+    short _layoutZoomLevel;
+    QSize _layoutSize;
+    quint64 _renderGeneration;
 };
 
 }
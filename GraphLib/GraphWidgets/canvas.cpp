@@ -5,7 +5,18 @@
 #include <QMimeData>
 #include <QLinearGradient>
 #include <QPainterPath>
+#include <QtDebug>
+#include <QScopeGuard>
+#include <QScopedValueRollback>
+#include <QKeySequence>
+#include <QLineF>
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QFile>
+#include <QSvgGenerator>
 #include <cmath>
+#include <cstdio>
+#include <limits>
 
 #include "canvas.h"
 #include "utility.h"
@@ -14,14 +25,41 @@
 #include "typednode.h"
 #include "TypeManagers/nodetypemanager.h"
 #include "TypeManagers/pintypemanager.h"
+#include "Render/allocationcounter.h"
+#include "Export/pngstreamwriter.h"
 
 namespace GraphLib {
 
 using namespace NodeFactoryModule;
 
+namespace {
+
+// Floating widgets (NodeFactoryWidget, Minimap) can't be dragged out of the canvas
+template<typename Widget>
+void keepInside(Widget *widget, QSize canvasSize)
+{
+    QSize desiredWidgetSize = widget->getDesiredSize();
+
+    if (widget->getPosition().x() + desiredWidgetSize.width() > canvasSize.width())
+        widget->setX(canvasSize.width() - desiredWidgetSize.width());
+
+    if (widget->getPosition().y() + desiredWidgetSize.height() > canvasSize.height())
+        widget->setY(canvasSize.height() - desiredWidgetSize.height());
+
+    if (widget->getPosition().x() < 0)
+        widget->setX(0);
+
+    if (widget->getPosition().y() < 0)
+        widget->setY(0);
+}
+
+}
+
 Canvas::Canvas(QWidget *parent)
     : QWidget{ parent }
     , _factory{ QSharedPointer<NodeFactory>(new NodeFactory()) }
+    , _nodeTypeManager{ nullptr }
+    , _pinTypeManager{ nullptr }
     , _painter{ new QPainter() }
     , _dotPaintGap{ 40 }
     , _draggedPin{ std::nullopt }
@@ -30,16 +68,59 @@ Canvas::Canvas(QWidget *parent)
     , _offset{ QPointF(0, 0) }
     , _lastMouseDownPosition{ QPointF() }
     , _mousePosition{ QPointF(0, 0) }
-    , _zoom{ -4 }
+    , _zoom{ 1.0f }
+    , _zoomTarget{ 1.0f }
+    , _zoomAnchor{ QPointF() }
+    , _zoomAnimation{ new QVariantAnimation(this) }
     , _lastResizedSize{ nullptr }
+    , _frameClock{ new FrameClock(this) }
+    , _pendingPan{ QPointF() }
+    , _pendingZoomSteps{ 0 }
+    , _pendingZoomAnchor{ QPointF() }
+    , _pendingSelectionPoint{ std::nullopt }
+    , _pendingDrag{ std::nullopt }
+    , _kineticPan{ KineticPan() }
+    , _bIsKineticPanningEnabled{ true }
     , _snappingInterval{ 20 }
     , _bIsSnappingEnabled{ true }
     , _selectionRect{ std::nullopt }
-    , _selectionAreaPreviousNodes{ QSet<int>() }
+    , _selectionArea{ std::nullopt }
     , _nodes{ QMap<int, QSharedPointer<BaseNode>>() }
     , _connectedPins{ QMultiMap<PinData, PinData>() }
     , _nfWidget{ new NodeFactoryWidget(this) }
-    , _selectedNodes{ QMap<int, QSharedPointer<BaseNode>>() }
+    , _minimap{ new Minimap(this) }
+    , _selection{ SelectionSet() }
+    , _groupOfNode{ QHash<int, int>() }
+    , _groups{ QHash<int, GroupNode*>() }
+    , _searchIndex{ NodeSearchIndex() }
+    , _frameArena{ c_frameArenaCapacity }
+    , _edgePath{ QPainterPath() }
+    , _edgePens{ QHash<QPair<quint64, int>, QPen>() }
+    , _edgePensZoom{ 0.0f }
+    , _frameProfiler{ FrameProfiler() }
+    , _bIsProfilerOverlayVisible{ false }
+    , _overlayLines{}
+    , _lastFrameInputs{ std::nullopt }
+    , _steadyFrames{ 0 }
+    , _renderDetail{ renderDetailForZoom(getLevelZoomMultiplier()) }
+    , _overviewEdges{ QVector<QPair<int, int>>() }
+    , _bIsOverviewEdgesDirty{ true }
+    , _nodeRenderCache{ c_nodeRenderCacheBudgetKb }
+    , _journal{ c_commandJournalMemoryCapBytes }
+    , _bIsJournalPaused{ false }
+    , _layoutWatcher{ new QFutureWatcher<LayoutPositions>(this) }
+    , _bIsLayoutAnimated{ true }
+    , _layoutAnimation{ new QVariantAnimation(this) }
+    , _animatedMoves{ QVector<NodeMove>() }
+    , _nodeIndex{ SpatialIndex() }
+    , _graphQuery{ GraphQuery() }
+    , _bAreCyclesAllowed{ true }
+    , _edgeRouter{ &_nodeIndex }
+    , _bIsEdgeRoutingEnabled{ true }
+    , _bIsTiledRenderingEnabled{ false }
+    , _tileScene{ TileScene() }
+    , _tileRenderer{ c_tileSize }
+    , _bIsTileSceneDirty{ true }
 {
     setMouseTracking(true);
     setAutoFillBackground(true);
@@ -53,42 +134,63 @@ Canvas::Canvas(QWidget *parent)
 
     connect(_nfWidget, &NodeFactoryWidget::onMove, this, &Canvas::onNFWidgetMove);
 
-    connect(this, &Canvas::onNodesRemoved, this, [&](){
-        if (_nodes.isEmpty()) IDgenerator = 0;
+    _minimap->show();
+    connect(_minimap, &Minimap::onMove, this, &Canvas::onMinimapMove);
+    connect(_minimap, &Minimap::onViewportMove, this, [&](QPointF canvasCenter){
+        _kineticPan.stop();
+        _offset = canvasCenter;
+        update();
     });
 
-    _timer = new QTimer(this);
-    connect(_timer, &QTimer::timeout, this, &Canvas::tick);
-    _timer->start(30);
+    connect(_layoutWatcher, &QFutureWatcher<LayoutPositions>::progressValueChanged, this, &Canvas::onLayoutProgress);
+    connect(_layoutWatcher, &QFutureWatcher<LayoutPositions>::finished, this, [&](){
+        if (!_layoutWatcher->isCanceled() && _layoutWatcher->future().resultCount() > 0)
+            applyLayout(_layoutWatcher->result(), _bIsLayoutAnimated);
+        onLayoutFinished();
+    });
+
+    _layoutAnimation->setStartValue(0.0);
+    _layoutAnimation->setEndValue(1.0);
+    _layoutAnimation->setDuration(c_layoutAnimationDurationMs);
+    _layoutAnimation->setEasingCurve(QEasingCurve::InOutCubic);
+    connect(_layoutAnimation, &QVariantAnimation::valueChanged, this, [&](const QVariant &value){
+        const float t = value.toFloat();
+        std::ranges::for_each(_animatedMoves, [&](const NodeMove &move) {
+            auto it = _nodes.constFind(move.nodeID);
+            if (it != _nodes.cend())
+            {
+                it.value()->setCanvasPosition(move.from + (move.to - move.from) * t);
+                updateNodeBounds(it.value().get());
+            }
+        });
+        placeGroups(_animatedMoves);
+        update();
+    });
+    connect(_layoutAnimation, &QVariantAnimation::finished, this, &Canvas::finishLayoutAnimation);
+
+    // steps through the zoom every animation frame, nodes are only laid out again when the level changes
+    _zoomAnimation->setDuration(c_zoomAnimationDurationMs);
+    _zoomAnimation->setEasingCurve(QEasingCurve::OutCubic);
+    connect(_zoomAnimation, &QVariantAnimation::valueChanged, this, [&](const QVariant &value){
+        setZoom(value.toFloat(), _zoomAnchor);
+        update();
+    });
+    // pins are placed where they're drawn once the zoom settles
+    connect(_zoomAnimation, &QVariantAnimation::finished, this, qOverload<>(&QWidget::update));
+
+    connect(_frameClock, &FrameClock::onFrame, this, &Canvas::onFrame);
 }
 
 Canvas::~Canvas()
 {
     delete _painter;
-    delete _timer;
     delete _nfWidget;
+    delete _minimap;
     delete _lastResizedSize;
 }
 
 unsigned int Canvas::IDgenerator = 0;
 
-const QMap<short, float> Canvas::_zoomMultipliers =
-{
-    {   0, 2.0f  },
-    {  -1, 1.75f  },
-    {  -2, 1.5f  },
-    {  -3, 1.25f  },
-    {  -4, 1.0f },
-    {  -5, 0.9f },
-    {  -6, 0.8f  },
-    {  -7, 0.7f  },
-    {  -8, 0.6f  },
-    {  -9, 0.5f  },
-    { -10, 0.4f  },
-    { -11, 0.3f  },
-    { -12, 0.2f  },
-    { -13, 0.1f  },
-};
 
 
 
@@ -104,10 +206,12 @@ QString Canvas::getNodeName(int nodeID) const
     return _nodes[nodeID]->getName();
 }
 
-void Canvas::moveCanvasOnPinDragNearEdge(QPointF mousePosition)
+bool Canvas::moveCanvasOnPinDragNearEdge(QPointF mousePosition, qint64 elapsedNs)
 {
+    // the speed doesn't depend on how often frames come
+    const float maxMove = c_pinDragEdgeCanvasMoveSpeed * (elapsedNs / 1e9f);
     auto lerp = [&](float actual, float max) {
-        return std::lerp(0, c_standardPinDragEdgeCanvasMoveValue, actual / max);
+        return std::lerp(0, maxMove, actual / max);
     };
 
     QRect rect = this->rect();
@@ -133,18 +237,48 @@ void Canvas::moveCanvasOnPinDragNearEdge(QPointF mousePosition)
 
     if (right.contains(mousePosition))
         moveViewRight(lerp(mousePosition.x() - right.left(), right.width()));
+
+    return top.contains(mousePosition) || bottom.contains(mousePosition)
+        || left.contains(mousePosition) || right.contains(mousePosition);
 }
 
-void Canvas::moveCanvas(QPointF offset) { _offset -= offset / _zoomMultipliers[_zoom]; }
+void Canvas::moveCanvas(QPointF offset) { _offset -= offset / _zoom; }
 
 QPointF Canvas::mapToCanvas(QPointF point) const
 {
-    return (point - this->rect().center()) / _zoomMultipliers[_zoom] + _offset;
+    return (point - this->rect().center()) / _zoom + _offset;
 }
 
 QPoint Canvas::mapToCanvas(QPoint point) const
 {
-    return ((point - this->rect().center()) / _zoomMultipliers[_zoom] + _offset.toPoint());
+    return ((point - this->rect().center()) / _zoom + _offset.toPoint());
+}
+
+QPointF Canvas::mapFromCanvas(QPointF point) const
+{
+    return _zoom * (point - _offset) + this->rect().center();
+}
+
+QTransform Canvas::canvasTransform() const
+{
+    const float zoomMult = _zoom;
+    const QPointF translation = QPointF(this->rect().center()) - zoomMult * _offset;
+    return QTransform(zoomMult, 0, 0, zoomMult, translation.x(), translation.y());
+}
+
+void Canvas::setRenderDetail(RenderDetail detail)
+{
+    if (detail == _renderDetail)
+        return;
+
+    bool bWasOverview = _renderDetail == RenderDetail::Overview;
+    bool bIsOverview = detail == RenderDetail::Overview;
+    _renderDetail = detail;
+
+    // at overview the canvas draws the nodes itself, so their widgets are hidden
+    if (bWasOverview != bIsOverview)
+        std::ranges::for_each(_nodes, [&](QSharedPointer<BaseNode> &node){ node->setVisible(!bIsOverview && !isCollapsed(node->ID())); });
+    _bIsTileSceneDirty = true;
 }
 
 void Canvas::zoom(int times, QPointF where)
@@ -152,210 +286,1449 @@ void Canvas::zoom(int times, QPointF where)
     if (times == 0) return;
     if (where.x() < 0 || where.y() < 0) where = _mousePosition;
 
-    QPointF initialWhereOnCanvas = mapToCanvas(where);
+    // steps made during the animation add up to its target
+    if (_zoomAnimation->state() != QAbstractAnimation::Running)
+        _zoomTarget = _zoom;
+    _zoomTarget = clampZoomMultiplier(_zoomTarget * std::pow(c_zoomStepRatio, static_cast<float>(times)));
+    _zoomAnchor = where;
 
-    _zoom += times;
+    _zoomAnimation->stop();
+    _zoomAnimation->setStartValue(_zoom);
+    _zoomAnimation->setEndValue(_zoomTarget);
+    _zoomAnimation->start();
+}
 
-    if (times < 0)
-        _zoom = std::max(_zoom, _zoomMultipliers.firstKey());
-    else
-        _zoom = std::min(_zoom, _zoomMultipliers.lastKey());
+void Canvas::setZoom(float zoomMult, QPointF where)
+{
+    if (where.x() < 0 || where.y() < 0) where = _mousePosition;
+
+    const short previousLevel = getZoomLevel();
+    QPointF initialWhereOnCanvas = mapToCanvas(where);
+
+    _zoom = clampZoomMultiplier(zoomMult);
 
     QPointF whereOffset = mapToCanvas(where) - initialWhereOnCanvas;
     _offset -= whereOffset;
+
+    if (getZoomLevel() != previousLevel)
+        onZoomLevelChanged(previousLevel, getZoomLevel());
+}
+
+void Canvas::onZoomLevelChanged(short previousLevel, short level)
+{
+    setRenderDetail(renderDetailForZoom(getLevelZoomMultiplier()));
+
+    _nodeRenderCache.retainLevels(level - c_zoomCachedLevels, level + c_zoomCachedLevels);
+    _tileRenderer.setLevel(level);
+
+    // the next levels are likely to come, so their fonts are prepared after this frame
+    const int direction = level > previousLevel ? 1 : -1;
+    QMetaObject::invokeMethod(this, [this, level, direction](){ prefetchZoomLevels(level, direction); }, Qt::QueuedConnection);
+}
+
+void Canvas::prefetchZoomLevels(short level, int direction)
+{
+    // only nodes around the viewport, the rest is prepared when it's scrolled to
+    const QRectF viewport(mapToCanvas(QPointF(this->rect().topLeft())), mapToCanvas(QPointF(this->rect().bottomRight())));
+    const QVector<int> nodeIDs = _nodeIndex.query(viewport);
+
+    for (int i = 1; i <= c_zoomPrefetchedLevels; i++)
+    {
+        const float zoomMult = zoomMultiplierForLevel(level + direction * i);
+        if (zoomMult != clampZoomMultiplier(zoomMult))
+            break;
+
+        // loading a font's engine and measuring text is the slow part of a node's layout
+        QFontMetrics(standardFont(c_nodeNameSize * zoomMult)).height();
+        QFontMetrics(standardFont(c_nodeNameSize * 0.75f * zoomMult)).height();
+        std::ranges::for_each(nodeIDs, [&](int nodeID) {
+            std::ranges::for_each(_nodes[nodeID]->pins(), [&](const AbstractPin *pin) { pin->getDesiredWidth(zoomMult); });
+        });
+    }
+}
+
+void Canvas::setEdgeRoutingEnabled(bool bEnabled)
+{
+    _bIsEdgeRoutingEnabled = bEnabled;
+    if (!bEnabled)
+        _edgeRouter.clear();
+    _bIsTileSceneDirty = true;
+    update();
+}
+
+void Canvas::setTiledRenderingEnabled(bool bEnabled)
+{
+    _bIsTiledRenderingEnabled = bEnabled;
+    _bIsTileSceneDirty = true;
+    if (!bEnabled)
+    {
+        _tileScene.clear();
+        _tileRenderer.invalidate();
+    }
+    update();
+}
+
+void Canvas::setKineticPanningEnabled(bool bEnabled)
+{
+    _bIsKineticPanningEnabled = bEnabled;
+    if (!bEnabled)
+        _kineticPan.stop();
+}
+
+void Canvas::setProfilerOverlayVisible(bool bVisible)
+{
+    _bIsProfilerOverlayVisible = bVisible;
+    update();
 }
 
 void Canvas::zoomIn(int times, QPointF where) { zoom(times, where); }
 
 void Canvas::zoomOut(int times, QPointF where) { zoom(-times, where); }
 
-void Canvas::processSelectionArea(const QMouseEvent *event)
+void Canvas::processSelectionArea(QPointF mousePosition)
+{
+    _selectionRect = QRect(_lastMouseDownPosition.toPoint(), mousePosition.toPoint());
+    const QRectF area = QRectF(mapToCanvas(_lastMouseDownPosition), mapToCanvas(mousePosition)).normalized();
+
+    QVector<int> entered, left;
+    if (_selectionArea)
+        _nodeIndex.queryDifference(*_selectionArea, area, entered, left);
+    else
+        _nodeIndex.query(area, entered);
+    _selectionArea = area;
+
+    std::ranges::for_each(left, [&](int nodeID) { _selection.deselect(nodeID); });
+    std::ranges::for_each(entered, [&](int nodeID) { _selection.select(nodeID); });
+
+    if (!entered.isEmpty() || !left.isEmpty())
+        onSelectionChanged();
+}
+
+void Canvas::selectAll()
+{
+    _selection.selectAll();
+    onSelectionChanged();
+}
+
+void Canvas::invertSelection()
+{
+    _selection.invert();
+    onSelectionChanged();
+}
+
+void Canvas::clearSelection()
+{
+    if (_selection.isEmpty())
+        return;
+
+    _selection.clear();
+    onSelectionChanged();
+}
+
+void Canvas::onSelectionChanged()
+{
+    // selected nodes have another color in the overview
+    _bIsTileSceneDirty = true;
+    _frameClock->requestFrame();
+}
+
+int Canvas::collapseSelection()
+{
+    // groups don't nest, the selected ones are expanded and merged into the new one
+    QVector<int> selectedGroups;
+    _selection.forEach([&](int nodeID) { if (isGroup(nodeID)) selectedGroups.append(nodeID); });
+    std::ranges::for_each(selectedGroups, [&](int groupID) { expandGroup(groupID); });
+
+    const QVector<int> members = _selection.ids();
+    if (members.size() < 2)
+        return -1;
+
+    GroupNode *group = new GroupNode(newID(), this, members);
+    group->setCanvasPosition(membersTopLeft(members));
+
+    // pins connected to anything outside of the group become the group's pins
+    const QSet<int> memberSet(members.begin(), members.end());
+    std::ranges::for_each(members, [&](int nodeID) {
+        const BaseNode *node = _nodes[nodeID].get();
+        std::ranges::for_each(node->pins(), [&](const AbstractPin *pin) {
+            const QVector<PinData> connectedPins = pin->getConnectedPins();
+            if (std::ranges::any_of(connectedPins, [&](const PinData &other) { return !memberSet.contains(other.nodeID); }))
+                group->addProxyPin(pin, node->getName());
+        });
+    });
+
+    // members are hit-tested, indexed, selected and drawn as the group from now on
+    std::ranges::for_each(members, [&](int nodeID) {
+        _nodes[nodeID]->setVisible(false);
+        _selection.removeNode(nodeID);
+        _groupOfNode.insert(nodeID, group->ID());
+        _edgeRouter.invalidate(_nodeIndex.rect(nodeID));
+        _nodeIndex.remove(nodeID);
+        _minimap->raster().removeNode(nodeID);
+    });
+
+    _groups.insert(group->ID(), group);
+    insertNode(group);
+
+    _selection.clear();
+    _selection.select(group->ID());
+    _bIsOverviewEdgesDirty = true;
+    onSelectionChanged();
+    return group->ID();
+}
+
+void Canvas::expandGroup(int groupID)
+{
+    auto it = _groups.constFind(groupID);
+    if (it == _groups.cend())
+        return;
+
+    const QVector<int> members = it.value()->members();
+    const bool bWasSelected = _selection.contains(groupID);
+
+    // routes are kept by the pins they're drawn between, the group's pins go away
+    std::ranges::for_each(members, [&](int nodeID) {
+        const BaseNode *node = _nodes[nodeID].get();
+        const auto connections = node->getPinConnections();
+        std::ranges::for_each(connections, [&](const std::pair<int, PinData> &connection) {
+            const PinData pin = node->getPinByID(connection.first)->getData();
+            const auto shown = pin.pinDirection == PinDirection::Out ? shownEdge(pin, connection.second)
+                                                                     : shownEdge(connection.second, pin);
+            if (shown)
+                _edgeRouter.remove(shown->first, shown->second);
+        });
+    });
+
+    std::ranges::for_each(members, [&](int nodeID) { _groupOfNode.remove(nodeID); });
+    _groups.erase(it);
+
+    // the group has no connections of its own
+    QSharedPointer<BaseNode> group = _nodes[groupID];
+    deleteNode(group);
+
+    std::ranges::for_each(members, [&](int nodeID) {
+        BaseNode *node = _nodes[nodeID].get();
+        node->setVisible(_renderDetail != RenderDetail::Overview);
+        updateNodeBounds(node);
+        _selection.addNode(nodeID);
+        if (bWasSelected)
+            _selection.select(nodeID);
+    });
+
+    _bIsOverviewEdgesDirty = true;
+    onSelectionChanged();
+}
+
+void Canvas::expandSelectedGroups()
+{
+    QVector<int> selectedGroups;
+    _selection.forEach([&](int nodeID) { if (isGroup(nodeID)) selectedGroups.append(nodeID); });
+    std::ranges::for_each(selectedGroups, [&](int groupID) { expandGroup(groupID); });
+}
+
+void Canvas::jumpToNode(int nodeID)
+{
+    const int shownID = _groupOfNode.value(nodeID, nodeID);
+    auto it = _nodes.constFind(shownID);
+    if (it == _nodes.cend())
+        return;
+
+    const BaseNode *node = it.value().get();
+    const QPointF center = node->canvasPosition() + QPointF(node->normalSize().width(), node->normalSize().height()) / 2.0;
+    _kineticPan.stop();
+    moveCanvas((_offset - center) * _zoom);
+
+    _selection.clear();
+    _selection.select(shownID);
+    onSelectionChanged();
+}
+
+QPointF Canvas::membersTopLeft(const QVector<int> &members) const
+{
+    QPointF topLeft = _nodes[members.first()]->canvasPosition();
+    std::ranges::for_each(members, [&](int nodeID) {
+        topLeft.setX(std::min(topLeft.x(), _nodes[nodeID]->canvasPosition().x()));
+        topLeft.setY(std::min(topLeft.y(), _nodes[nodeID]->canvasPosition().y()));
+    });
+    return topLeft;
+}
+
+void Canvas::placeGroups(const QVector<NodeMove> &moves)
+{
+    if (_groupOfNode.isEmpty())
+        return;
+
+    QSet<int> groupIDs;
+    std::ranges::for_each(moves, [&](const NodeMove &move) {
+        auto group = _groupOfNode.constFind(move.nodeID);
+        if (group != _groupOfNode.cend())
+            groupIDs.insert(group.value());
+    });
+    std::ranges::for_each(groupIDs, [&](int groupID) {
+        GroupNode *group = _groups[groupID];
+        group->setCanvasPosition(membersTopLeft(group->members()));
+        updateNodeBounds(group);
+    });
+}
+
+PinData Canvas::shownPin(const PinData &pin) const
+{
+    auto it = _groupOfNode.constFind(pin.nodeID);
+    if (it == _groupOfNode.cend())
+        return pin;
+    return _groups[it.value()]->proxyPin(pin);
+}
+
+std::optional<QPair<PinData, PinData>> Canvas::shownEdge(const PinData &outPin, const PinData &inPin) const
+{
+    if (_groupOfNode.isEmpty())
+        return QPair<PinData, PinData>(outPin, inPin);
+
+    const int outGroup = _groupOfNode.value(outPin.nodeID, -1);
+    const int inGroup = _groupOfNode.value(inPin.nodeID, -1);
+    if (outGroup >= 0 && outGroup == inGroup)
+        return std::nullopt;
+
+    // edges connected after the group was made have no pin of the group to be drawn to
+    const PinData out = shownPin(outPin), in = shownPin(inPin);
+    if (isCollapsed(out.nodeID) || isCollapsed(in.nodeID))
+        return std::nullopt;
+    return QPair<PinData, PinData>(out, in);
+}
+
+void Canvas::setNodeTypeManager(const NodeTypeManager *manager)
+{
+    _nodeTypeManager = manager;
+    _factory->setNodeTypeManager(manager);
+    _nfWidget->_nodeTypeManager = _nodeTypeManager;
+    _nfWidget->initTypes();
+}
+
+void Canvas::reloadTypes()
+{
+    // the palette keeps its filter and scrolls back to the top
+    _nfWidget->initTypes();
+    update();
+}
+
+void Canvas::reloadPinTypes(const QVector<int> &pinTypeIDs)
+{
+    if (!_pinTypeManager)
+        return;
+
+    // typed nodes' pins are named after their types
+    QSet<QString> typeNames;
+    std::ranges::for_each(pinTypeIDs, [&](int id) { typeNames.insert(_pinTypeManager->typeNameByID(id)); });
+    std::ranges::for_each(_nodes, [&](const QSharedPointer<BaseNode> &node) {
+        if (!qobject_cast<TypedNode*>(node.get()))
+            return;
+        std::ranges::for_each(node->pins(), [&](AbstractPin *pin) {
+            if (typeNames.contains(pin->getText()))
+                pin->setColor(_factory->pinColor(pin->getText()));
+        });
+    });
+
+    // group pins copied their members' colors
+    std::ranges::for_each(_groups, [&](GroupNode *group) {
+        std::ranges::for_each(group->pins(), [&](AbstractPin *pin) {
+            const PinData member = group->memberPin(pin->getData());
+            const QSharedPointer<BaseNode> memberNode = _nodes.value(member.nodeID);
+            const AbstractPin *memberPin = memberNode ? memberNode->getPinByID(member.pinID) : nullptr;
+            if (memberPin && memberPin->getColor() != pin->getColor())
+                pin->setColor(memberPin->getColor());
+        });
+    });
+
+    // edges are drawn in their pins' colors
+    _bIsTileSceneDirty = true;
+    _bIsOverviewEdgesDirty = true;
+    update();
+}
+
+void Canvas::setPinTypeManager(const PinTypeManager *manager)
+{
+    _pinTypeManager = manager;
+    _factory->setPinTypeManager(manager);
+    _nfWidget->_pinTypeManager = _pinTypeManager;
+}
+
+
+
+// ---------------------------- SLOTS --------------------------------
+
+
+void Canvas::onNFWidgetMove(QVector2D) { keepInside(_nfWidget, this->size()); }
+
+void Canvas::onMinimapMove(QVector2D) { keepInside(_minimap, this->size()); }
+
+void Canvas::onFrame(qint64 elapsedNs)
+{
+    // however many events came since the last frame, the view changes once
+    if (!_pendingPan.isNull())
+    {
+        moveCanvas(_pendingPan);
+        if (_bIsKineticPanningEnabled)
+            _kineticPan.track(_pendingPan, elapsedNs);
+        _pendingPan = QPointF();
+    }
+    else if (_kineticPan.isMoving())
+    {
+        moveCanvas(_kineticPan.step(elapsedNs));
+        if (_kineticPan.isMoving())
+            _frameClock->requestFrame();
+    }
+
+    applyPendingDrag();
+
+    if (_pendingSelectionPoint)
+    {
+        processSelectionArea(*_pendingSelectionPoint);
+        _pendingSelectionPoint = std::nullopt;
+    }
+
+    if (_pendingZoomSteps != 0)
+    {
+        zoom(_pendingZoomSteps, _pendingZoomAnchor);
+        _pendingZoomSteps = 0;
+    }
+
+    // scrolling goes on while a pin is dragged near an edge, even if the cursor stays still
+    if (_draggedPin && moveCanvasOnPinDragNearEdge(_mousePosition, elapsedNs))
+        _frameClock->requestFrame();
+
+    update();
+}
+
+void Canvas::onPinConnect(PinData outPin, PinData inPin)
+{
+    // connections to a group's pin are made to the member's pin it stands for
+    if (isGroup(outPin.nodeID))
+        outPin = _groups[outPin.nodeID]->memberPin(outPin);
+    if (isGroup(inPin.nodeID))
+        inPin = _groups[inPin.nodeID]->memberPin(inPin);
+
+    // only the nodes downstream of the in-pin are searched
+    if (!_bAreCyclesAllowed && _graphQuery.wouldCreateCycle(outPin.nodeID, inPin.nodeID))
+        return;
+
+    connectPins(outPin, inPin);
+}
+
+void Canvas::connectPins(PinData outPin, PinData inPin)
+{
+    if (!insertConnection(outPin, inPin))
+        return;
+
+    _bIsOverviewEdgesDirty = true;
+
+    _bIsTileSceneDirty = true;
+    recordCommand(ConnectPinsCommand{ { edgeRecord(outPin, inPin) } });
+}
+
+void Canvas::connectPins(const QVector<QPair<PinData, PinData>> &connections)
+{
+    ConnectPinsCommand command;
+    command.edges.reserve(connections.size());
+
+    std::ranges::for_each(connections, [&](const QPair<PinData, PinData> &connection) {
+        if (insertConnection(connection.first, connection.second))
+            command.edges.append(edgeRecord(connection.first, connection.second));
+    });
+    _bIsOverviewEdgesDirty = true;
+    _bIsTileSceneDirty = true;
+    update();
+
+    if (!command.edges.isEmpty())
+        recordCommand(std::move(command));
+}
+
+bool Canvas::insertConnection(const PinData &outPin, const PinData &inPin)
+{
+    if (_connectedPins.contains(outPin, inPin))
+        return false;
+
+    _connectedPins.insert(outPin, inPin);
+    _graphQuery.addEdge(outPin.nodeID, inPin.nodeID);
+    _nodes[outPin.nodeID]->setPinConnection(outPin.pinID, inPin);
+    _nodes[inPin.nodeID]->setPinConnection(inPin.pinID, outPin);
+    return true;
+}
+
+bool Canvas::eraseConnection(const PinData &outPin, const PinData &inPin)
+{
+    auto it = _connectedPins.find(outPin, inPin);
+    if (it == _connectedPins.end())
+        return false;
+
+    _connectedPins.erase(it);
+    _graphQuery.removeEdge(outPin.nodeID, inPin.nodeID);
+    _edgeRouter.remove(outPin, inPin);
+    _nodes[outPin.nodeID]->removePinConnection(outPin.pinID, inPin.pinID);
+    _nodes[inPin.nodeID]->removePinConnection(inPin.pinID, outPin.pinID);
+    return true;
+}
+
+void Canvas::onPinConnectionBreak(PinData outPin, PinData inPin)
+{
+    // the record is made while the pins are still connected
+    EdgeRecord edge = edgeRecord(outPin, inPin);
+    if (eraseConnection(outPin, inPin))
+    {
+        _bIsOverviewEdgesDirty = true;
+        _bIsTileSceneDirty = true;
+        recordCommand(DisconnectPinsCommand{ { edge } });
+    }
+}
+
+void Canvas::onNodeDrag(int nodeID, QPointF canvasPosition)
+{
+    // only the latest position matters, the whole selection moves there on the next frame
+    _pendingDrag = qMakePair(nodeID, canvasPosition);
+    _frameClock->requestFrame();
+}
+
+void Canvas::onNodeMoveFinished()
+{
+    applyPendingDrag();
+    _journal.seal();
+}
+
+void Canvas::onNodeRename(int nodeID, const QString &name) { _searchIndex.rename(nodeID, name); }
+
+void Canvas::applyPendingDrag()
+{
+    if (!_pendingDrag)
+        return;
+
+    const auto [anchorID, target] = *_pendingDrag;
+    _pendingDrag = std::nullopt;
+    // the drag goes on from where the layout puts the nodes
+    stopLayoutAnimation();
+
+    auto anchor = _nodes.constFind(anchorID);
+    if (anchor == _nodes.cend())
+        return;
+
+    const QPointF delta = target - anchor.value()->canvasPosition();
+    if (delta.isNull())
+        return;
+
+    MoveNodesCommand command;
+    auto translate = [&](int nodeID) {
+        BaseNode *node = _nodes[nodeID].get();
+        const QPointF from = node->canvasPosition();
+        node->setCanvasPosition(from + delta);
+        updateNodeBounds(node);
+
+        // the hidden members go along with their group and the moves are recorded for them,
+        // the group may be gone by the time they're undone
+        auto group = _groups.constFind(nodeID);
+        if (group == _groups.cend())
+        {
+            command.moves.append(NodeMove{ nodeID, from, from + delta });
+            return;
+        }
+        std::ranges::for_each(group.value()->members(), [&](int memberID) {
+            BaseNode *member = _nodes[memberID].get();
+            const QPointF memberFrom = member->canvasPosition();
+            member->setCanvasPosition(memberFrom + delta);
+            command.moves.append(NodeMove{ memberID, memberFrom, memberFrom + delta });
+        });
+    };
+
+    // the selection keeps its shape, the dragged node is the one snapped
+    if (_selection.contains(anchorID))
+    {
+        command.moves.reserve(_selection.size());
+        _selection.forEach(translate);
+    }
+    else
+        translate(anchorID);
+
+    // the same nodes moved again are merged into the previous command until the drag ends
+    recordCommand(std::move(command));
+}
+
+void Canvas::onPinDrag(PinDragSignal signal)
+{
+    switch (signal.type())
+    {
+    case PinDragSignalType::Enter:
+    {
+        _nodes[signal.source().nodeID]->setPinConnected(signal.source().pinID, true);
+        if (_draggedPinTargetInfo)
+            _draggedPinTargetInfo.value() = signal.source();
+        break;
+    }
+    case PinDragSignalType::Leave:
+    {
+        // group's pins always stand for connected pins
+        if (!isGroup(signal.source().nodeID))
+            _nodes[signal.source().nodeID]->setPinConnected(signal.source().pinID, false);
+        if (_draggedPinTargetInfo)
+            _draggedPinTargetInfo.value() = std::nullopt;
+        break;
+    }
+    case PinDragSignalType::Start:
+    {
+        _draggedPin = signal.source();
+        _draggedPinTargetInfo.emplace(std::nullopt);
+        break;
+    }
+    case PinDragSignalType::End:
+    {
+        _draggedPin = std::nullopt;
+        _draggedPinTargetInfo = std::nullopt;
+        break;
+    }
+    default:;
+    }
+    _frameClock->requestFrame();
+}
+
+void Canvas::onNodeSelect(bool bIsMultiSelectionModifierDown, int nodeID)
+{
+    if (!bIsMultiSelectionModifierDown)
+        _selection.clear();
+    _selection.select(nodeID);
+    onSelectionChanged();
+}
+
+void Canvas::onNodeDeselect(int nodeID)
+{
+    if (_selection.deselect(nodeID))
+        onSelectionChanged();
+}
+
+QWeakPointer<BaseNode> Canvas::addBaseNode(QPoint canvasPosition, QString name)
+{
+    BaseNode *node = new BaseNode(this);
+    node->setCanvasPosition(canvasPosition);
+    node->setName(name);
+    return addNode(node);
+}
+
+QWeakPointer<BaseNode> Canvas::addNode(BaseNode *node)
+{
+    node->setID(newID());
+    QWeakPointer<BaseNode> added = insertNode(node);
+
+    recordCommand(AddNodesCommand{ { nodeRecord(node) } });
+    return added;
+}
+
+QWeakPointer<BaseNode> Canvas::insertNode(BaseNode *node)
+{
+    // new IDs only grow, so the node usually goes to the end of the map
+    auto it = _nodes.insert(_nodes.cend(), node->ID(), QSharedPointer<BaseNode>(node));
+    _selection.addNode(node->ID());
+    // groups have no edges of their own and their members are found instead of them
+    if (!isGroup(node->ID()))
+    {
+        _graphQuery.addNode(node->ID());
+        _searchIndex.insert(node->ID(), node->name(), typeName(node));
+    }
+    node->setVisible(_renderDetail != RenderDetail::Overview);
+
+    connect(node, &BaseNode::onPinDrag, this, &Canvas::onPinDrag);
+    connect(node, &BaseNode::onPinConnect, this, &Canvas::onPinConnect);
+    connect(node, &BaseNode::onSelect, this, &Canvas::onNodeSelect);
+    connect(node, &BaseNode::onDeselect, this, &Canvas::onNodeDeselect);
+    connect(node, &BaseNode::onPinConnectionBreak, this, &Canvas::onPinConnectionBreak);
+    connect(node, &BaseNode::onDrag, this, &Canvas::onNodeDrag);
+    connect(node, &BaseNode::onMoveFinished, this, &Canvas::onNodeMoveFinished);
+    connect(node, &BaseNode::onRename, this, &Canvas::onNodeRename);
+
+    updateNodeBounds(node);
+    return QWeakPointer<BaseNode>(it.value());
+}
+
+void Canvas::updateNodeBounds(const BaseNode *node)
+{
+    // collapsed nodes are indexed as their group
+    if (isCollapsed(node->ID()))
+        return;
+
+    const QRectF bounds(node->canvasPosition(), QSizeF(node->normalSize()));
+    const bool bIsIndexed = _nodeIndex.contains(node->ID());
+    const QRectF previous = _nodeIndex.rect(node->ID());
+    if (bIsIndexed && previous == bounds)
+        return;
+
+    _nodeIndex.insert(node->ID(), bounds);
+    _minimap->raster().setNode(node->ID(), bounds);
+    _bIsTileSceneDirty = true;
+    // routes around both the old and the new place may change
+    if (bIsIndexed)
+        _edgeRouter.invalidate(previous);
+    _edgeRouter.invalidate(bounds);
+}
+
+QWeakPointer<BaseNode> Canvas::addTypedNode(QPoint canvasPosition, int typeID)
+{
+    TypedNode *node = _factory->getNodeOfType(typeID, this);
+    node->setCanvasPosition(canvasPosition);
+    return addNode(node);
+}
+
+QVector<QWeakPointer<BaseNode>> Canvas::addTypedNodes(const QVector<QPair<QPoint, int>> &nodes)
+{
+    QVector<QWeakPointer<BaseNode>> added;
+    added.reserve(nodes.size());
+    AddNodesCommand command;
+    command.nodes.reserve(nodes.size());
+
+    // every shown node widget would schedule its own repaint otherwise
+    setUpdatesEnabled(false);
+    std::ranges::for_each(nodes, [&](const QPair<QPoint, int> &spawn) {
+        TypedNode *node = _factory->getNodeOfType(spawn.second, this);
+        node->setCanvasPosition(spawn.first);
+        node->setID(newID());
+        added.append(insertNode(node));
+        command.nodes.append(nodeRecord(node));
+    });
+    setUpdatesEnabled(true);
+
+    recordCommand(std::move(command));
+    return added;
+}
+
+void Canvas::removeNode(int nodeID)
+{
+    if (_nodes.contains(nodeID))
+        removeNodes({ nodeID });
+}
+
+void Canvas::removeNodes(const QVector<int> &groupedNodeIDs)
+{
+    // groups go away with their members, which are recorded as any other nodes
+    QVector<int> nodeIDs;
+    nodeIDs.reserve(groupedNodeIDs.size());
+    std::ranges::for_each(groupedNodeIDs, [&](int id) {
+        if (!isGroup(id))
+        {
+            nodeIDs.append(id);
+            return;
+        }
+        nodeIDs.append(_groups[id]->members());
+        expandGroup(id);
+    });
+
+    RemoveNodesCommand command;
+    command.nodes.reserve(nodeIDs.size());
+
+    QSet<int> removed(nodeIDs.begin(), nodeIDs.end());
+    std::ranges::for_each(nodeIDs, [&](int id) {
+        const BaseNode *node = _nodes[id].get();
+        command.nodes.append(nodeRecord(node));
+
+        // connections between the removed nodes are recorded once, from the out-pin side.
+        // The arena is reset only per frame, so it isn't used outside of paint
+        const auto connections = node->getPinConnections();
+        std::ranges::for_each(connections, [&](const std::pair<int, PinData> &connection) {
+            const auto &[pinID, connectedPin] = connection;
+            if (node->getPinByID(pinID)->getDirection() == PinDirection::Out)
+                command.edges.append(edgeRecord(node->getPinByID(pinID)->getData(), connectedPin));
+            else if (!removed.contains(connectedPin.nodeID))
+                command.edges.append(edgeRecord(connectedPin, node->getPinByID(pinID)->getData()));
+        });
+    });
+
+    std::ranges::for_each(nodeIDs, [&](int id) {
+        // deleteNode removes the node from _nodes, so the pointer is held here
+        QSharedPointer<BaseNode> node = _nodes[id];
+        deleteNode(node);
+    });
+    onNodesRemoved();
+
+    recordCommand(std::move(command));
+}
+
+void Canvas::deleteNode(QSharedPointer<BaseNode> &ptr)
 {
-    _selectionRect = QRect(_lastMouseDownPosition.toPoint(), event->position().toPoint());
-    std::ranges::for_each(_nodes, [&](QSharedPointer<BaseNode> &node){
-        if (_selectionAreaPreviousNodes.contains(node->ID()))
+    int id = ptr->ID();
+
+    // e.g. undoing the addition of a collapsed node, an empty group goes with it
+    auto group = _groupOfNode.constFind(id);
+    if (group != _groupOfNode.cend())
+    {
+        // the member's edges are routed to the group's pins, which go away with the member
+        const auto connections = ptr->getPinConnections();
+        std::ranges::for_each(connections, [&](const std::pair<int, PinData> &connection) {
+            const PinData pin = ptr->getPinByID(connection.first)->getData();
+            const auto shown = pin.pinDirection == PinDirection::Out ? shownEdge(pin, connection.second)
+                                                                     : shownEdge(connection.second, pin);
+            if (shown)
+                _edgeRouter.remove(shown->first, shown->second);
+        });
+
+        GroupNode *groupNode = _groups[group.value()];
+        groupNode->removeMember(id);
+        _groupOfNode.erase(group);
+        if (groupNode->members().isEmpty())
         {
-            if (!node->getMappedRect().intersects(*_selectionRect))
+            _groups.remove(groupNode->ID());
+            QSharedPointer<BaseNode> emptyGroup = _nodes[groupNode->ID()];
+            deleteNode(emptyGroup);
+        }
+    }
+
+    if (ptr->hasPinConnections())
+    {
+        const auto connections = ptr->getPinConnections();
+        std::ranges::for_each(connections, [&](const std::pair<int, PinData> &connection){
+            const auto &[pinID, connectedPin] = connection;
+            _nodes[connectedPin.nodeID]->removePinConnection(connectedPin.pinID, pinID);
+
+            const AbstractPin *pin = ptr->getPinByID(pinID);
+            if (pin->getDirection() == PinDirection::Out)
             {
-                node->setSelected(false);
-                _selectionAreaPreviousNodes.remove(node->ID());
+                _connectedPins.remove(pin->getData(), connectedPin);
+                _edgeRouter.remove(pin->getData(), connectedPin);
             }
+            else
+            {
+                _connectedPins.remove(connectedPin, pin->getData());
+                _edgeRouter.remove(connectedPin, pin->getData());
+            }
+        });
+        _bIsOverviewEdgesDirty = true;
+        _bIsTileSceneDirty = true;
+    }
+    _edgeRouter.invalidate(_nodeIndex.rect(id));
+    _nodeIndex.remove(id);
+    _minimap->raster().removeNode(id);
+    _selection.removeNode(id);
+    _graphQuery.removeNode(id);
+    _searchIndex.remove(id);
+    _bIsTileSceneDirty = true;
+    _nodes.remove(id);
+}
+
+
+// --------------------------- HISTORY --------------------------------
+
+
+NodeRecord Canvas::nodeRecord(const BaseNode *node) const
+{
+    NodeRecord record{ node->ID(), -1, node->canvasPosition(), QString(), QVector<PinRecord>() };
+
+    if (const TypedNode *typed = qobject_cast<const TypedNode*>(node))
+        record.typeID = typed->getTypeID();
+    else
+    {
+        record.name = node->getName();
+        std::ranges::for_each(node->pins(), [&](const AbstractPin *pin) {
+            record.pins.append({ pin->getText(), pin->getDirection(), pin->getColor() });
+        });
+    }
+    return record;
+}
+
+QString Canvas::typeName(const BaseNode *node) const
+{
+    const TypedNode *typed = qobject_cast<const TypedNode*>(node);
+    if (!typed || !_nodeTypeManager || typed->getTypeID() < 0 || typed->getTypeID() >= _nodeTypeManager->typesCount())
+        return QString();
+    return _nodeTypeManager->typeNameByID(typed->getTypeID());
+}
+
+EdgeRecord Canvas::edgeRecord(const PinData &outPin, const PinData &inPin) const
+{
+    return { outPin.nodeID, _nodes[outPin.nodeID]->getPinIndex(outPin.pinID),
+             inPin.nodeID, _nodes[inPin.nodeID]->getPinIndex(inPin.pinID) };
+}
+
+std::optional<QPair<PinData, PinData>> Canvas::edgePins(const EdgeRecord &edge) const
+{
+    auto outNode = _nodes.constFind(edge.outNodeID);
+    auto inNode = _nodes.constFind(edge.inNodeID);
+    if (outNode == _nodes.cend() || inNode == _nodes.cend())
+        return std::nullopt;
+
+    const AbstractPin *outPin = outNode.value()->getPinByIndex(edge.outPinIndex);
+    const AbstractPin *inPin = inNode.value()->getPinByIndex(edge.inPinIndex);
+    if (!outPin || !inPin || outPin->getDirection() != PinDirection::Out || inPin->getDirection() != PinDirection::In)
+        return std::nullopt;
+    return QPair<PinData, PinData>(outPin->getData(), inPin->getData());
+}
+
+void Canvas::recordCommand(Command command)
+{
+    if (!_bIsJournalPaused)
+        _journal.record(std::move(command));
+}
+
+QVector<EdgeRecord> Canvas::restoreNodes(const QVector<NodeRecord> &nodes, const QVector<EdgeRecord> &edges)
+{
+    setUpdatesEnabled(false);
+
+    std::ranges::for_each(nodes, [&](const NodeRecord &record) {
+        BaseNode *node = nullptr;
+        if (record.typeID >= 0)
+            node = _factory->getNodeOfType(record.typeID, this);
+        else
+        {
+            node = new BaseNode(this);
+            node->setName(record.name);
+            std::ranges::for_each(record.pins, [&](const PinRecord &pin) { node->addPin(pin.text, pin.direction, pin.color); });
         }
-        if (node->getMappedRect().intersects(*_selectionRect))
+        node->setCanvasPosition(record.canvasPosition);
+        node->setID(record.nodeID);
+        insertNode(node);
+    });
+
+    QVector<EdgeRecord> restored;
+    restored.reserve(edges.size());
+    std::ranges::for_each(edges, [&](const EdgeRecord &edge) {
+        std::optional<QPair<PinData, PinData>> pins = edgePins(edge);
+        if (pins && insertConnection(pins->first, pins->second))
+            restored.append(edge);
+    });
+    _bIsOverviewEdgesDirty = true;
+    _bIsTileSceneDirty = true;
+
+    setUpdatesEnabled(true);
+    return restored;
+}
+
+Subgraph Canvas::selectedSubgraph() const
+{
+    Subgraph subgraph;
+    subgraph.nodes.reserve(_selection.size());
+
+    // selected groups are copied as their members
+    QVector<int> nodeIDs;
+    nodeIDs.reserve(_selection.size());
+    _selection.forEach([&](int nodeID) {
+        if (isGroup(nodeID))
+            nodeIDs.append(_groups[nodeID]->members());
+        else
+            nodeIDs.append(nodeID);
+    });
+    const QSet<int> copied(nodeIDs.begin(), nodeIDs.end());
+
+    std::ranges::for_each(nodeIDs, [&](int nodeID) {
+        const BaseNode *node = _nodes[nodeID].get();
+        subgraph.nodes.append(nodeRecord(node));
+
+        const auto connections = node->getPinConnections();
+        std::ranges::for_each(connections, [&](const std::pair<int, PinData> &connection) {
+            const auto &[pinID, connectedPin] = connection;
+            const AbstractPin *pin = node->getPinByID(pinID);
+            if (pin->getDirection() == PinDirection::Out && copied.contains(connectedPin.nodeID))
+                subgraph.edges.append(edgeRecord(pin->getData(), connectedPin));
+        });
+    });
+    return subgraph;
+}
+
+QVector<int> Canvas::addSubgraph(const Subgraph &subgraph, QPointF canvasPosition)
+{
+    if (subgraph.nodes.isEmpty())
+        return {};
+
+    QPointF topLeft = subgraph.nodes.first().canvasPosition;
+    std::ranges::for_each(subgraph.nodes, [&](const NodeRecord &node) {
+        topLeft.setX(std::min(topLeft.x(), node.canvasPosition.x()));
+        topLeft.setY(std::min(topLeft.y(), node.canvasPosition.y()));
+    });
+
+    AddNodesCommand command;
+    command.nodes.reserve(subgraph.nodes.size());
+    QHash<int, int> newIDs;
+    newIDs.reserve(subgraph.nodes.size());
+
+    // nodes of types this canvas doesn't know are skipped along with their connections
+    const qsizetype typesCount = _nodeTypeManager ? _nodeTypeManager->typesCount() : 0;
+    std::ranges::for_each(subgraph.nodes, [&](const NodeRecord &node) {
+        if (node.typeID >= typesCount)
+            return;
+
+        NodeRecord added = node;
+        added.nodeID = newID();
+        added.canvasPosition = node.canvasPosition - topLeft + canvasPosition;
+        newIDs.insert(node.nodeID, added.nodeID);
+        command.nodes.append(std::move(added));
+    });
+
+    std::ranges::for_each(subgraph.edges, [&](const EdgeRecord &edge) {
+        if (newIDs.contains(edge.outNodeID) && newIDs.contains(edge.inNodeID))
+            command.edges.append({ newIDs[edge.outNodeID], edge.outPinIndex, newIDs[edge.inNodeID], edge.inPinIndex });
+    });
+
+    // the clipboard may hold anything, so only the edges that could be restored are recorded
+    command.edges = restoreNodes(command.nodes, command.edges);
+
+    QVector<int> ids;
+    ids.reserve(command.nodes.size());
+    std::ranges::for_each(command.nodes, [&](const NodeRecord &node) { ids.append(node.nodeID); });
+
+    recordCommand(std::move(command));
+    return ids;
+}
+
+void Canvas::copySelection() const
+{
+    if (_selection.isEmpty())
+        return;
+
+    QMimeData *mimeData = new QMimeData();
+    mimeData->setData(c_mimeFormatForSubgraph, selectedSubgraph().toByteArray());
+    QGuiApplication::clipboard()->setMimeData(mimeData);
+}
+
+void Canvas::cutSelection()
+{
+    if (_selection.isEmpty())
+        return;
+
+    copySelection();
+    removeNodes(_selection.ids());
+}
+
+void Canvas::paste()
+{
+    const QMimeData *mimeData = QGuiApplication::clipboard()->mimeData();
+    if (!mimeData || !mimeData->hasFormat(c_mimeFormatForSubgraph))
+        return;
+
+    Subgraph subgraph = Subgraph::fromByteArray(mimeData->data(c_mimeFormatForSubgraph));
+    QVector<int> ids = addSubgraph(subgraph, mapToCanvas(_mousePosition));
+
+    _selection.clear();
+    std::ranges::for_each(ids, [&](int id) { _selection.select(id); });
+    onSelectionChanged();
+}
+
+LayoutGraph Canvas::layoutSnapshot() const
+{
+    LayoutGraph graph;
+    graph.nodes.reserve(_nodes.size());
+
+    QHash<int, int> indices;
+    indices.reserve(_nodes.size());
+    // the graph is laid out expanded, groups have no connections of their own
+    std::ranges::for_each(_nodes, [&](const QSharedPointer<BaseNode> &node) {
+        if (isGroup(node->ID()))
+            return;
+        indices.insert(node->ID(), graph.nodes.size());
+        graph.nodes.append({ node->ID(), node->canvasPosition(), QSizeF(node->normalSize()), static_cast<int>(node->pins().size()) });
+    });
+
+    graph.edges.reserve(_connectedPins.size());
+    std::ranges::for_each(_connectedPins.asKeyValueRange(), [&](std::pair<const PinData &, const PinData &> pair) {
+        const auto &[outPin, inPin] = pair;
+        graph.edges.append({ indices[outPin.nodeID], _nodes[outPin.nodeID]->getPinIndex(outPin.pinID),
+                             indices[inPin.nodeID], _nodes[inPin.nodeID]->getPinIndex(inPin.pinID) });
+    });
+    return graph;
+}
+
+void Canvas::applyLayout(const LayoutPositions &positions, bool bAnimate)
+{
+    stopLayoutAnimation();
+
+    MoveNodesCommand command;
+    command.moves.reserve(positions.size());
+    std::ranges::for_each(positions, [&](const QPair<int, QPointF> &position) {
+        auto it = _nodes.constFind(position.first);
+        if (it == _nodes.cend())
+            return;
+        QPointF target = _bIsSnappingEnabled ? QPointF(snap(position.second, _snappingInterval)) : position.second;
+        if (it.value()->canvasPosition() != target)
+            command.moves.append({ position.first, it.value()->canvasPosition(), target });
+    });
+    if (command.moves.isEmpty())
+        return;
+
+    // the layout is a single step of the history, never merged with a drag
+    _journal.seal();
+    recordCommand(command);
+    _journal.seal();
+
+    _animatedMoves = std::move(command.moves);
+    if (bAnimate)
+        _layoutAnimation->start();
+    else
+        finishLayoutAnimation();
+}
+
+void Canvas::stopLayoutAnimation()
+{
+    // the layout's move is already recorded, so the nodes jump to its end
+    if (_layoutAnimation->state() != QAbstractAnimation::Running)
+        return;
+    _layoutAnimation->stop();
+    finishLayoutAnimation();
+}
+
+void Canvas::finishLayoutAnimation()
+{
+    std::ranges::for_each(_animatedMoves, [&](const NodeMove &move) {
+        auto it = _nodes.constFind(move.nodeID);
+        if (it != _nodes.cend())
         {
-            node->setSelected(true, true);
-            _selectionAreaPreviousNodes.insert(node->ID());
+            it.value()->setCanvasPosition(move.to);
+            updateNodeBounds(it.value().get());
         }
     });
+    // layouts move the members, the graph is laid out expanded
+    placeGroups(_animatedMoves);
+    _animatedMoves.clear();
+    update();
 }
 
-void Canvas::setNodeTypeManager(const NodeTypeManager *manager)
+QFuture<LayoutPositions> Canvas::layoutLayered(const LayeredLayoutOptions &options)
 {
-    _nodeTypeManager = manager;
-    _factory->setNodeTypeManager(manager);
-    _nfWidget->_nodeTypeManager = _nodeTypeManager;
-    _nfWidget->initTypes();
+    QFuture<LayoutPositions> future = LayeredLayout::run(layoutSnapshot(), options);
+    watchLayout(future, options.bAnimate);
+    return future;
 }
 
-void Canvas::setPinTypeManager(const PinTypeManager *manager)
+QFuture<LayoutPositions> Canvas::layoutForceDirected(const ForceLayoutOptions &options, const QVector<int> &editedNodeIDs)
 {
-    _pinTypeManager = manager;
-    _factory->setPinTypeManager(manager);
-    _nfWidget->_pinTypeManager = _pinTypeManager;
+    LayoutGraph graph = layoutSnapshot();
+
+    QSet<int> edited(editedNodeIDs.cbegin(), editedNodeIDs.cend());
+    QVector<int> settledNodes;
+    for (int i = 0; i < graph.nodes.size(); i++)
+        if (edited.contains(graph.nodes[i].nodeID))
+            settledNodes.append(i);
+    // none of the edited nodes exist anymore, so there is nothing to settle
+    if (!edited.isEmpty() && settledNodes.isEmpty())
+        return QFuture<LayoutPositions>();
+
+    QFuture<LayoutPositions> future = ForceLayout::run(std::move(graph), options, std::move(settledNodes));
+    watchLayout(future, options.bAnimate);
+    return future;
 }
 
+void Canvas::watchLayout(QFuture<LayoutPositions> future, bool bAnimate)
+{
+    if (_layoutWatcher->isRunning())
+        _layoutWatcher->cancel();
 
+    _bIsLayoutAnimated = bAnimate;
+    _layoutWatcher->setFuture(future);
+}
 
-// ---------------------------- SLOTS --------------------------------
+void Canvas::undo()
+{
+    if (const Command *command = _journal.undo())
+        applyCommand(*command, true);
+}
 
+void Canvas::redo()
+{
+    if (const Command *command = _journal.redo())
+        applyCommand(*command, false);
+}
 
-void Canvas::onNFWidgetMove(QVector2D)
+void Canvas::applyCommand(const Command &command, bool bIsUndo)
 {
-    QSize desiredWidgetSize = _nfWidget->getDesiredSize();
+    // an animation still running would move the nodes back to where the command took them from
+    stopLayoutAnimation();
 
-    if (_nfWidget->getPosition().x() + desiredWidgetSize.width() > this->width())
-        _nfWidget->setX(this->width() - desiredWidgetSize.width());
+    // changes made while replaying the journal aren't recorded again
+    QScopedValueRollback<bool> pause(_bIsJournalPaused, true);
 
-    if (_nfWidget->getPosition().y() + desiredWidgetSize.height() > this->height())
-        _nfWidget->setY(this->height() - desiredWidgetSize.height());
+    auto removeRecorded = [&](const QVector<NodeRecord> &nodes) {
+        QVector<int> ids;
+        ids.reserve(nodes.size());
+        std::ranges::for_each(nodes, [&](const NodeRecord &record) { ids.append(record.nodeID); });
+        removeNodes(ids);
+    };
+
+    auto setConnected = [&](const QVector<EdgeRecord> &edges, bool bConnected) {
+        std::ranges::for_each(edges, [&](const EdgeRecord &edge) {
+            std::optional<QPair<PinData, PinData>> pins = edgePins(edge);
+            if (!pins)
+                return;
+            if (bConnected)
+                insertConnection(pins->first, pins->second);
+            else
+                eraseConnection(pins->first, pins->second);
+        });
+        _bIsOverviewEdgesDirty = true;
+        _bIsTileSceneDirty = true;
+    };
 
-    if (_nfWidget->getPosition().x() < 0)
-        _nfWidget->setX(0);
+    if (auto *move = std::get_if<MoveNodesCommand>(&command))
+    {
+        std::ranges::for_each(move->moves, [&](const NodeMove &nodeMove) {
+            _nodes[nodeMove.nodeID]->setCanvasPosition(bIsUndo ? nodeMove.from : nodeMove.to);
+            updateNodeBounds(_nodes[nodeMove.nodeID].get());
+        });
+        // only the members' moves are recorded
+        placeGroups(move->moves);
+    }
+    else if (auto *add = std::get_if<AddNodesCommand>(&command))
+    {
+        if (bIsUndo)
+        {
+            // pins may have been added to the nodes after they were, so the nodes are recorded again
+            AddNodesCommand current{ {}, add->edges };
+            current.nodes.reserve(add->nodes.size());
+            std::ranges::for_each(add->nodes, [&](const NodeRecord &record) {
+                auto it = _nodes.constFind(record.nodeID);
+                current.nodes.append(it != _nodes.cend() ? nodeRecord(it.value().get()) : record);
+            });
+            removeRecorded(add->nodes);
+            _journal.replaceUndone(std::move(current));
+        }
+        else
+            restoreNodes(add->nodes, add->edges);
+    }
+    else if (auto *remove = std::get_if<RemoveNodesCommand>(&command))
+    {
+        if (bIsUndo)
+            restoreNodes(remove->nodes, remove->edges);
+        else
+            removeRecorded(remove->nodes);
+    }
+    else if (auto *connect = std::get_if<ConnectPinsCommand>(&command))
+        setConnected(connect->edges, !bIsUndo);
+    else if (auto *disconnect = std::get_if<DisconnectPinsCommand>(&command))
+        setConnected(disconnect->edges, bIsUndo);
 
-    if (_nfWidget->getPosition().y() < 0)
-        _nfWidget->setY(0);
+    update();
 }
 
-void Canvas::tick()
+
+// --------------------------- EXPORT ----------------------------------
+
+
+QRectF Canvas::exportArea(const ExportOptions &options) const
 {
-    if (_draggedPin)
-        moveCanvasOnPinDragNearEdge(_mousePosition);
+    QRectF area;
+    std::ranges::for_each(_nodes, [&](const QSharedPointer<BaseNode> &node) {
+        if (!isCollapsed(node->ID()))
+            area |= QRectF(node->canvasPosition(), QSizeF(node->normalSize()));
+    });
+
+    if (area.isNull())
+        return area;
+    return area.adjusted(-options.margin, -options.margin, options.margin, options.margin);
 }
 
-void Canvas::onPinConnect(PinData outPin, PinData inPin)
+QSize Canvas::exportSize(const ExportOptions &options) const
 {
-    if (!_connectedPins.contains(outPin, inPin))
-    {
-        _connectedPins.insert(outPin, inPin);
-        _nodes[outPin.nodeID]->setPinConnection(outPin.pinID, inPin);
-        _nodes[inPin.nodeID]->setPinConnection(inPin.pinID, outPin);
-    }
+    const QRectF area = exportArea(options);
+    const double width = std::ceil(area.width() * options.scale);
+    const double height = std::ceil(area.height() * options.scale);
+    // written so that NaN of a non-finite scale is refused too
+    if (!(width > 0 && height > 0 && width <= c_exportMaxSide && height <= c_exportMaxSide))
+        return QSize();
+    return QSize(static_cast<int>(width), static_cast<int>(height));
 }
 
-void Canvas::onPinConnectionBreak(PinData outPin, PinData inPin)
+void Canvas::layoutNodes()
 {
-    auto it = _connectedPins.find(outPin, inPin);
-    if (it != _connectedPins.end())
-    {
-        _connectedPins.erase(it);
+    // node layout only needs the font metrics of a painter
+    QImage image(1, 1, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
 
-        _nodes[outPin.nodeID]->removePinConnection(outPin.pinID, inPin.pinID);
-        _nodes[inPin.nodeID]->removePinConnection(inPin.pinID, outPin.pinID);
-    }
+    std::ranges::for_each(_nodes, [&](QSharedPointer<BaseNode> &node) {
+        node->ensureLayout(&painter);
+        updateNodeBounds(node.get());
+    });
 }
 
-void Canvas::onPinDrag(PinDragSignal signal)
+void Canvas::renderGraph(QPainter *painter, const QRectF &canvasArea, const ExportOptions &options)
 {
-    switch (signal.type())
-    {
-    case PinDragSignalType::Enter:
-    {
-        _nodes[signal.source().nodeID]->setPinConnected(signal.source().pinID, true);
-        if (_draggedPinTargetInfo)
-            _draggedPinTargetInfo.value() = signal.source();
-        break;
-    }
-    case PinDragSignalType::Leave:
-    {
-        _nodes[signal.source().nodeID]->setPinConnected(signal.source().pinID, false);
-        if (_draggedPinTargetInfo)
-            _draggedPinTargetInfo.value() = std::nullopt;
-        break;
-    }
-    case PinDragSignalType::Start:
+    auto intersectsArea = [&](QPointF first, QPointF second, double margin) {
+        return std::max(first.x(), second.x()) + margin >= canvasArea.left() && std::min(first.x(), second.x()) - margin <= canvasArea.right()
+            && std::max(first.y(), second.y()) + margin >= canvasArea.top() && std::min(first.y(), second.y()) - margin <= canvasArea.bottom();
+    };
+
+    painter->save();
+
+    // BACKGROUND: the dots lie where they are on screen, sparser at far zooms
+    if (options.bDrawBackground)
     {
-        _draggedPin = signal.source();
-        _draggedPinTargetInfo.emplace(std::nullopt);
-        break;
+        painter->fillRect(canvasArea, c_paletteDefaultColor);
+
+        const int gap = options.scale * _dotPaintGap < _dotPaintGap / 2 ? _dotPaintGap * 6 : _dotPaintGap;
+        QPen pen(c_dotsColor);
+        pen.setCosmetic(true);
+        painter->setPen(pen);
+
+        QVector<QPointF> dots;
+        for (double x = std::ceil(canvasArea.left() / gap) * gap; x <= canvasArea.right(); x += gap)
+        {
+            dots.clear();
+            for (double y = std::ceil(canvasArea.top() / gap) * gap; y <= canvasArea.bottom(); y += gap)
+                dots.append(QPointF(x, y));
+            painter->drawPoints(dots.constData(), dots.size());
+        }
     }
-    case PinDragSignalType::End:
+
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    const QVector<int> nodeIDs = _nodeIndex.query(canvasArea);
+
+    if (renderDetailForZoom(options.scale) == RenderDetail::Overview)
     {
-        _draggedPin = std::nullopt;
-        _draggedPinTargetInfo = std::nullopt;
-        break;
-    }
-    default:;
+        // the same batches paintOverview draws
+        updateOverviewEdges();
+        QVector<QLineF> lines;
+        std::ranges::for_each(_overviewEdges, [&](const QPair<int, int> &pair) {
+            const BaseNode *outNode = _nodes[pair.first].get();
+            const BaseNode *inNode = _nodes[pair.second].get();
+
+            QPointF origin = outNode->canvasPosition() + QPointF(outNode->normalSize().width(), outNode->normalSize().height() / 2.0);
+            QPointF target = inNode->canvasPosition() + QPointF(0, inNode->normalSize().height() / 2.0);
+            if (intersectsArea(origin, target, c_pinConnectLineWidth))
+                lines.append(QLineF(origin, target));
+        });
+
+        QVector<QRectF> nodeRects, selectedNodeRects;
+        std::ranges::for_each(nodeIDs, [&](int nodeID) {
+            const BaseNode *node = _nodes[nodeID].get();
+            (node->isSelected() ? selectedNodeRects : nodeRects).append(QRectF(node->canvasPosition(), QSizeF(node->normalSize())));
+        });
+
+        QPen pen(c_highlightColor);
+        pen.setWidthF(std::max(1.0 / options.scale, static_cast<double>(c_pinConnectLineWidth)));
+        painter->setPen(pen);
+        painter->drawLines(lines.constData(), lines.size());
+
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(c_nodesBackgroundColor);
+        painter->drawRects(nodeRects.constData(), nodeRects.size());
+        painter->setBrush(c_selectionColor);
+        painter->drawRects(selectedNodeRects.constData(), selectedNodeRects.size());
+
+        painter->restore();
+        return;
     }
-}
 
-void Canvas::onNodeSelect(bool bIsMultiSelectionModifierDown, int nodeID)
-{
-    _selectedNodes.insert(nodeID, _nodes[nodeID]);
+    // EDGES: every stale route is recomputed, there is no frame to catch up in
+    if (_bIsEdgeRoutingEnabled)
+        _edgeRouter.beginFrame(std::numeric_limits<int>::max());
+
+    const double edgeMargin = c_maxDiffsSum + c_pinConnectLineWidth;
+    std::ranges::for_each(_connectedPins.asKeyValueRange(), [&](std::pair<const PinData &, const PinData &> pair) {
+        if (pair.first.pinDirection == PinDirection::In) return;
+
+        const auto shown = shownEdge(pair.first, pair.second);
+        if (!shown) return;
+        const auto &[outPin, inPin] = *shown;
 
-    if (bIsMultiSelectionModifierDown) return;
+        const BaseNode *outNode = _nodes[outPin.nodeID].get();
+        const BaseNode *inNode = _nodes[inPin.nodeID].get();
+        const QPointF origin = outNode->getCanvasOutlineCoordinateForPinID(outPin.pinID);
+        const QPointF target = inNode->getCanvasOutlineCoordinateForPinID(inPin.pinID);
 
-    std::ranges::for_each(_selectedNodes.values(), [&](QSharedPointer<BaseNode> &ptr){
-        if (ptr->ID() == nodeID)
+        const EdgeRoute *route = _bIsEdgeRoutingEnabled ? _edgeRouter.route(outPin, inPin, origin, target) : nullptr;
+        if (route ? !route->corridor.intersects(canvasArea) : !intersectsArea(origin, target, edgeMargin))
             return;
-        ptr->setSelected(false);
+
+        painter->setPen(standardEdgePen(outNode->getPinByID(outPin.pinID)->getColor(),
+                                        inNode->getPinByID(inPin.pinID)->getColor(), origin, target));
+        if (route)
+            routedPath(_edgePath, route->points, c_edgeRouteCornerRadius, QTransform());
+        else
+            standardPath(_edgePath, origin.toPoint(), target.toPoint());
+        painter->drawPath(_edgePath);
     });
 
-    _selectedNodes.removeIf([&](QMap<int, QSharedPointer<BaseNode>>::iterator &it){
-        return it.value()->ID() != nodeID;
+    // NODES go over the edges like their widgets do. They are drawn at their layout zoom
+    // and scaled back to canvas coordinates
+    std::ranges::for_each(nodeIDs, [&](int nodeID) {
+        BaseNode *node = _nodes[nodeID].get();
+        node->ensureLayout(painter);
+
+        painter->save();
+        painter->translate(node->canvasPosition());
+        painter->scale(1.0 / node->layoutZoomMultiplier(), 1.0 / node->layoutZoomMultiplier());
+        node->renderTo(painter);
+        painter->restore();
     });
-}
 
-QWeakPointer<BaseNode> Canvas::addBaseNode(QPoint canvasPosition, QString name)
-{
-    BaseNode *node = new BaseNode(this);
-    node->setCanvasPosition(canvasPosition);
-    node->setName(name);
-    return addNode(node);
+    painter->restore();
 }
 
-QWeakPointer<BaseNode> Canvas::addNode(BaseNode *node)
+bool Canvas::exportPng(QIODevice *device, const ExportOptions &options)
 {
-    int id = newID();
-    node->setID(id);
+    if (!std::isfinite(options.scale) || options.scale <= 0)
+        return false;
+
+    // whichever way the export ends, the nodes are laid out and indexed for the canvas' zoom again
+    const auto restoreLayout = qScopeGuard([this] { layoutNodes(); _bIsTileSceneDirty = true; update(); });
+    // nodes are laid out for the zoom level closest to the scale, their sizes depend on it
+    QScopedValueRollback<float> exportZoom(_zoom, clampZoomMultiplier(options.scale));
+    layoutNodes();
+
+    const QRectF area = exportArea(options);
+    const QSize size = exportSize(options);
+    if (size.isEmpty())
+        return false;
+
+    // a strip and its RGBA copy made by the writer fit into the budget
+    const qsizetype rowBytes = static_cast<qsizetype>(size.width()) * 4;
+    const int stripHeight = static_cast<int>(std::clamp<qsizetype>(options.memoryBudgetBytes / (rowBytes * 2), 1, size.height()));
 
-    _nodes.insert(id, QSharedPointer<BaseNode>(node));
-    _nodes[id]->show();
+    PngStreamWriter writer(device, size);
+    QImage strip(size.width(), stripHeight, QImage::Format_ARGB32_Premultiplied);
+    bool bIsWritten = writer.isValid() && !strip.isNull();
 
-    connect(_nodes[id].get(), &BaseNode::onPinDrag, this, &Canvas::onPinDrag);
-    connect(_nodes[id].get(), &BaseNode::onPinConnect, this, &Canvas::onPinConnect);
-    connect(_nodes[id].get(), &BaseNode::onSelect, this, &Canvas::onNodeSelect);
-    connect(_nodes[id].get(), &BaseNode::onPinConnectionBreak, this, &Canvas::onPinConnectionBreak);
+    for (int top = 0; bIsWritten && top < size.height(); top += stripHeight)
+    {
+        const int rows = std::min(stripHeight, size.height() - top);
+        strip.fill(Qt::transparent);
+
+        QPainter painter(&strip);
+        painter.translate(0, -top);
+        painter.scale(options.scale, options.scale);
+        painter.translate(-area.topLeft());
+        renderGraph(&painter, QRectF(area.left(), area.top() + top / options.scale, area.width(), rows / options.scale), options);
+        painter.end();
 
-    return QWeakPointer<BaseNode>(_nodes[id]);
+        bIsWritten = writer.writeRows(rows == stripHeight ? strip : strip.copy(0, 0, size.width(), rows));
+    }
+    return bIsWritten && writer.finish();
 }
 
-QWeakPointer<BaseNode> Canvas::addTypedNode(QPoint canvasPosition, int typeID)
+bool Canvas::exportPng(const QString &path, const ExportOptions &options)
 {
-    TypedNode *node = _factory->getNodeOfType(typeID, this);
-    node->setCanvasPosition(canvasPosition);
-    return addNode(node);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    return exportPng(&file, options);
 }
 
-void Canvas::deleteNode(QSharedPointer<BaseNode> &ptr)
+bool Canvas::exportSvg(const QString &path, const ExportOptions &options)
 {
-    int id = ptr->ID();
-    if (ptr->hasPinConnections())
+    if (!std::isfinite(options.scale) || options.scale <= 0)
+        return false;
+
+    // whichever way the export ends, the nodes are laid out and indexed for the canvas' zoom again
+    const auto restoreLayout = qScopeGuard([this] { layoutNodes(); _bIsTileSceneDirty = true; update(); });
+    // nodes are laid out for the zoom level closest to the scale, their sizes depend on it
+    QScopedValueRollback<float> exportZoom(_zoom, clampZoomMultiplier(options.scale));
+    layoutNodes();
+
+    const QRectF area = exportArea(options);
+    const QSize size = exportSize(options);
+    if (size.isEmpty())
+        return false;
+
+    QSvgGenerator generator;
+    generator.setFileName(path);
+    generator.setSize(size);
+    generator.setViewBox(QRect(QPoint(0, 0), size));
+
+    QPainter painter;
+    bool bIsWritten = painter.begin(&generator);
+    if (bIsWritten)
     {
-        QSharedPointer< QMap<int, QVector<PinData> > > connections = ptr->getPinConnections();
-        std::ranges::for_each(connections->asKeyValueRange(), [&](std::pair<const int&, QVector<PinData>&> pair){
-            int id = pair.first;
-            std::ranges::for_each(pair.second, [&](PinData connectedPin){
-                _nodes[connectedPin.nodeID]->removePinConnection(connectedPin.pinID, id);
-
-                const AbstractPin *pin = ptr->getPinByID(id);
-                if (pin->getDirection() == PinDirection::Out)
-                    _connectedPins.remove(pin->getData());
-                else
-                    _connectedPins.remove(connectedPin, pin->getData());
-            });
-        });
+        painter.scale(options.scale, options.scale);
+        painter.translate(-area.topLeft());
+        renderGraph(&painter, area, options);
+        bIsWritten = painter.end();
     }
-    _nodes.remove(id);
+    return bIsWritten;
 }
 
 
@@ -364,13 +1737,36 @@ void Canvas::deleteNode(QSharedPointer<BaseNode> &ptr)
 
 void Canvas::keyPressEvent(QKeyEvent *event)
 {
-    if (event->key() == Qt::Key_Delete && !_selectedNodes.isEmpty())
+    if (event->key() == c_profilerOverlayToggleKey)
+        setProfilerOverlayVisible(!_bIsProfilerOverlayVisible);
+
+    if (event->key() == Qt::Key_Delete && !_selection.isEmpty())
+        removeNodes(_selection.ids());
+
+    if (event->key() == c_invertSelectionKey && (event->modifiers() & Qt::ControlModifier))
+        invertSelection();
+
+    if (event->key() == c_groupKey && (event->modifiers() & Qt::ControlModifier))
     {
-        std::ranges::for_each(_selectedNodes, [&](QSharedPointer<BaseNode> &ptr){ deleteNode(ptr); });
-        _selectedNodes.clear();
-        onNodesRemoved();
+        if (event->modifiers() & Qt::ShiftModifier)
+            expandSelectedGroups();
+        else
+            collapseSelection();
     }
 
+    if (event->matches(QKeySequence::Undo))
+        undo();
+    else if (event->matches(QKeySequence::Redo))
+        redo();
+    else if (event->matches(QKeySequence::Copy))
+        copySelection();
+    else if (event->matches(QKeySequence::Cut))
+        cutSelection();
+    else if (event->matches(QKeySequence::Paste))
+        paste();
+    else if (event->matches(QKeySequence::SelectAll))
+        selectAll();
+
     QWidget::keyPressEvent(event);
 }
 
@@ -379,6 +1775,8 @@ void Canvas::mousePressEvent(QMouseEvent *event)
     switch (event->button())
     {
     case Qt::MouseButton::RightButton:
+        // grabbing the canvas stops it from moving on its own
+        _kineticPan.stop();
         _lastMouseDownPosition = event->position();
         this->setCursor(QCursor(Qt::CursorShape::OpenHandCursor));
         break;
@@ -387,11 +1785,7 @@ void Canvas::mousePressEvent(QMouseEvent *event)
         if (event->modifiers() & c_multiSelectionModifier)
             break;
 
-        std::ranges::for_each(_selectedNodes.values(), [&](QSharedPointer<BaseNode> &ptr){
-            ptr->setSelected(false);
-        });
-
-        _selectedNodes.clear();
+        clearSelection();
         break;
     default:;
     }
@@ -399,16 +1793,17 @@ void Canvas::mousePressEvent(QMouseEvent *event)
 
 void Canvas::mouseMoveEvent(QMouseEvent *event)
 {
-    QPointF offset;
+    // high-rate mice send many events per frame, they're only collected here
     switch (event->buttons())
     {
     case Qt::MouseButton::RightButton:
-        offset = event->position() - _lastMouseDownPosition;
-        moveCanvas(offset);
+        _pendingPan += event->position() - _lastMouseDownPosition;
         _lastMouseDownPosition = event->position();
+        _frameClock->requestFrame();
         break;
     case Qt::MouseButton::LeftButton:
-        processSelectionArea(event);
+        _pendingSelectionPoint = event->position();
+        _frameClock->requestFrame();
         break;
     default:;
     }
@@ -421,10 +1816,23 @@ void Canvas::mouseReleaseEvent(QMouseEvent *event)
     {
     case Qt::MouseButton::RightButton:
         this->setCursor(QCursor(Qt::CursorShape::ArrowCursor));
+        if (_bIsKineticPanningEnabled)
+        {
+            _kineticPan.release();
+            if (_kineticPan.isMoving())
+                _frameClock->requestFrame();
+        }
         break;
     case Qt::MouseButton::LeftButton:
+        // the selection ends where the mouse was released
+        if (_pendingSelectionPoint)
+        {
+            processSelectionArea(*_pendingSelectionPoint);
+            _pendingSelectionPoint = std::nullopt;
+        }
         _selectionRect = std::nullopt;
-        _selectionAreaPreviousNodes.clear();
+        _selectionArea = std::nullopt;
+        _frameClock->requestFrame();
         break;
     default:;
     }
@@ -432,6 +1840,10 @@ void Canvas::mouseReleaseEvent(QMouseEvent *event)
 
 void Canvas::resizeEvent(QResizeEvent *event)
 {
+    // the minimap starts in the bottom-right corner
+    if (!_lastResizedSize)
+        _minimap->setPosition(QPointF(event->size().width(), event->size().height()) - QPointF(_minimap->getDesiredSize().width(), _minimap->getDesiredSize().height()));
+
     QSize oldSize = _lastResizedSize ? *_lastResizedSize : event->oldSize();
 
     auto approxEqual = [](int x, int y){
@@ -439,44 +1851,50 @@ void Canvas::resizeEvent(QResizeEvent *event)
         return abs(x - y) < approximation;
     };
 
-    bool widgetBoundToRight = approxEqual(_nfWidget->getPosition().x() + _nfWidget->getDesiredSize().width(), oldSize.width());
-    bool widgetBoundToBottom = approxEqual(_nfWidget->getPosition().y() + _nfWidget->getDesiredSize().height(), oldSize.height());
-    bool widgetBoundToLeft = approxEqual(_nfWidget->getPosition().x(), 0);
-    bool widgetBoundToTop = approxEqual(_nfWidget->getPosition().y(), 0);
+    // floating widgets stick to the borders they're at, otherwise they keep their relative position
+    auto followResize = [&](auto *widget) {
+        bool widgetBoundToRight = approxEqual(widget->getPosition().x() + widget->getDesiredSize().width(), oldSize.width());
+        bool widgetBoundToBottom = approxEqual(widget->getPosition().y() + widget->getDesiredSize().height(), oldSize.height());
+        bool widgetBoundToLeft = approxEqual(widget->getPosition().x(), 0);
+        bool widgetBoundToTop = approxEqual(widget->getPosition().y(), 0);
 
-    // manage NFWidget position
-    if (widgetBoundToRight)
-        _nfWidget->setX(event->size().width() - _nfWidget->getDesiredSize().width());
-    if (widgetBoundToLeft)
-        _nfWidget->setX(0);
+        if (widgetBoundToRight)
+            widget->setX(event->size().width() - widget->getDesiredSize().width());
+        if (widgetBoundToLeft)
+            widget->setX(0);
 
-    if (!widgetBoundToLeft && !widgetBoundToRight)
-    {
-        float widthDiff = event->size().width() - oldSize.width();
-        if (widthDiff)
+        if (!widgetBoundToLeft && !widgetBoundToRight)
         {
-            float widthDiffCoeff = widthDiff / oldSize.width();
-            float xCenter = _nfWidget->getPosition().x() + _nfWidget->getDesiredSize().width() / 2.0f;
-            _nfWidget->adjustPosition(xCenter * widthDiffCoeff, 0);
+            float widthDiff = event->size().width() - oldSize.width();
+            if (widthDiff)
+            {
+                float widthDiffCoeff = widthDiff / oldSize.width();
+                float xCenter = widget->getPosition().x() + widget->getDesiredSize().width() / 2.0f;
+                widget->adjustPosition(xCenter * widthDiffCoeff, 0);
+            }
         }
-    }
 
 
-    if (widgetBoundToBottom)
-        _nfWidget->setY(event->size().height() - _nfWidget->getDesiredSize().height());
-    if (widgetBoundToTop)
-        _nfWidget->setY(0);
+        if (widgetBoundToBottom)
+            widget->setY(event->size().height() - widget->getDesiredSize().height());
+        if (widgetBoundToTop)
+            widget->setY(0);
 
-    if (!widgetBoundToTop && !widgetBoundToBottom)
-    {
-        float heightDiff = event->size().height() - oldSize.height();
-        if (heightDiff)
+        if (!widgetBoundToTop && !widgetBoundToBottom)
         {
-            float heightDiffCoeff = heightDiff / oldSize.height();
-            float yCenter = _nfWidget->getPosition().y() + _nfWidget->getDesiredSize().height() / 2.0f;
-            _nfWidget->adjustPosition(0, yCenter * heightDiffCoeff);
+            float heightDiff = event->size().height() - oldSize.height();
+            if (heightDiff)
+            {
+                float heightDiffCoeff = heightDiff / oldSize.height();
+                float yCenter = widget->getPosition().y() + widget->getDesiredSize().height() / 2.0f;
+                widget->adjustPosition(0, yCenter * heightDiffCoeff);
+            }
         }
-    }
+    };
+
+    // manage NFWidget and Minimap positions
+    followResize(_nfWidget);
+    followResize(_minimap);
 
     if (_lastResizedSize)
         *_lastResizedSize = event->size();
@@ -487,6 +1905,7 @@ void Canvas::resizeEvent(QResizeEvent *event)
 
 // accumulative zoom delta is used for mice with finer-resolution wheels
 // https://doc.qt.io/qt-6/qwheelevent.html#angleDelta
+// Steps are applied on the next frame, so a burst of wheel events is one zoom change
 void Canvas::wheelEvent(QWheelEvent *event)
 {
     static int _accumulativeZoomDelta = 0;
@@ -496,15 +1915,20 @@ void Canvas::wheelEvent(QWheelEvent *event)
         short zoomSteps = qFloor(_accumulativeZoomDelta / 120);
         _accumulativeZoomDelta = _accumulativeZoomDelta % 120;
 
-        zoomIn(zoomSteps, event->position());
+        _pendingZoomSteps += zoomSteps;
     }
     else if (_accumulativeZoomDelta <= -120)
     {
         short zoomSteps = qFloor(_accumulativeZoomDelta / -120);
         _accumulativeZoomDelta = _accumulativeZoomDelta % 120;
 
-        zoomOut(zoomSteps, event->position());
+        _pendingZoomSteps -= zoomSteps;
     }
+    else
+        return;
+
+    _pendingZoomAnchor = event->position();
+    _frameClock->requestFrame();
 }
 
 void Canvas::dropEvent(QDropEvent *event)
@@ -536,6 +1960,7 @@ void Canvas::dragMoveEvent(QDragMoveEvent *event)
     {
         QPoint mousePos = event->position().toPoint();
         _draggedPinTarget = mousePos;
+        _frameClock->requestFrame();
     }
     _mousePosition = event->position();
 }
@@ -546,19 +1971,64 @@ void Canvas::dragMoveEvent(QDragMoveEvent *event)
 
 void Canvas::paintEvent(QPaintEvent *event)
 {
+    // nothing allocated from the arena outlives the previous frame
+    _frameArena.reset();
+
+    // node widgets of the previous frame are painted by now, so it can be finalized
+    _frameProfiler.beginFrame();
+
     _painter->begin(this);
     _painter->setRenderHint(QPainter::Antialiasing, true);
     paint(_painter, event);
     _painter->end();
 }
 
+const QPen &Canvas::edgePen(const QColor &originColor, const QColor &targetColor, QPoint origin, QPoint target, float zoomMult)
+{
+    if (_edgePensZoom != zoomMult)
+    {
+        _edgePens.clear();
+        _edgePensZoom = zoomMult;
+    }
+
+    // bit 0 - origin is to the right of the target, bit 1 - origin is below the target
+    int orientation = (origin.x() > target.x() ? 1 : 0) | (origin.y() > target.y() ? 2 : 0);
+    QPair<quint64, int> key((static_cast<quint64>(originColor.rgba()) << 32) | targetColor.rgba(), orientation);
+
+    auto it = _edgePens.constFind(key);
+    if (it != _edgePens.cend())
+        return it.value();
+
+    return _edgePens.insert(key, standardEdgePen(originColor, targetColor, origin, target, zoomMult)).value();
+}
+
+void Canvas::checkFrameAllocations(const FrameInputs &inputs, quint64 allocations)
+{
+    if (_lastFrameInputs && *_lastFrameInputs == inputs)
+        _steadyFrames++;
+    else
+        _steadyFrames = 0;
+    _lastFrameInputs = inputs;
+
+    if (!AllocationCounter::isEnabled() || _steadyFrames < c_steadyStateFramesToCheckAllocations)
+        return;
+
+    if (allocations != 0)
+        qWarning() << "Canvas: steady-state repaint made" << allocations << "heap allocations";
+    Q_ASSERT_X(allocations == 0, "Canvas::paint", "steady-state repaint must not allocate");
+}
+
 void Canvas::paint(QPainter *painter, QPaintEvent *event)
 {
-    auto getColorOfPinByPinData = [&](const PinData &data){
+    const quint64 allocationsAtStart = AllocationCounter::count();
+
+    auto getColorOfPinByPinData = [&](const PinData &data) -> const QColor & {
         const AbstractPin *pin = _nodes[data.nodeID]->getPinByID(data.pinID);
         return pin->getColor();
     };
 
+    FrameStats &stats = _frameProfiler.current();
+
     QPen pen(Qt::SolidLine);
     pen.setColor(c_dotsColor);
     painter->setPen(pen);
@@ -570,37 +2040,85 @@ void Canvas::paint(QPainter *painter, QPaintEvent *event)
     int halfWidth = center.x();
     int halfHeight = center.y();
 
-    float zoomMult = _zoomMultipliers[_zoom];
+    float zoomMult = _zoom;
+    // node layouts and edge pens are made per zoom level
+    float levelZoomMult = getLevelZoomMultiplier();
     float dotPaintGapZoomedf = zoomMult * _dotPaintGap;
 
     // this line is responsible for increasing the dots' gap when it's too small
-    int dotPaintGapZoomed = static_cast<int>(dotPaintGapZoomedf < _dotPaintGap / 2 ? dotPaintGapZoomedf * 6 : dotPaintGapZoomedf);
+    float dotPaintGapZoomed = dotPaintGapZoomedf < _dotPaintGap / 2 ? dotPaintGapZoomedf * 6 : dotPaintGapZoomedf;
 
+    // zoom is continuous, so the dots are placed in floating point not to drift from the nodes
     auto calculateFirstDotCoord = [&](const int &half, const float &positionCoord) {
-        return static_cast<int>( (half % dotPaintGapZoomed) - zoomMult * positionCoord ) % dotPaintGapZoomed;
+        float first = std::fmod(half - zoomMult * positionCoord, dotPaintGapZoomed);
+        return first < 0 ? first + dotPaintGapZoomed : first;
     };
 
-    int leftDotCoordX = calculateFirstDotCoord(halfWidth, _offset.x());
-    int topDotCoordY = calculateFirstDotCoord(halfHeight, _offset.y());
+    float leftDotCoordX = calculateFirstDotCoord(halfWidth, _offset.x());
+    float topDotCoordY = calculateFirstDotCoord(halfHeight, _offset.y());
 
-    for (int x = leftDotCoordX; x < rectangle.width(); x += dotPaintGapZoomed)
+    // tiles have the background dots in them
+    if (!_bIsTiledRenderingEnabled)
     {
-        for (int y = topDotCoordY; y < rectangle.height(); y += dotPaintGapZoomed)
+        FrameProfiler::ScopedPhase phase(_frameProfiler, FramePhase::Background);
+
+        for (float x = leftDotCoordX; x < rectangle.width(); x += dotPaintGapZoomed)
         {
-            painter->drawPoint(x, y);
+            for (float y = topDotCoordY; y < rectangle.height(); y += dotPaintGapZoomed)
+            {
+                painter->drawPoint(QPointF(x, y));
+            }
         }
     }
 
-    // manage NODES
-    std::ranges::for_each(_nodes, [&](QSharedPointer<BaseNode> &node) {
+    FrameInputs inputs{ _offset, _mousePosition, QPointF(), rectangle.size(), _zoom,
+                        _nodes.size(), _connectedPins.size(), _selectionRect,
+                        _draggedPin.has_value(), _draggedPinTarget };
 
-        // this->rect()->center() is used instead of center purposefully
-        // in order to fix flicking and lagging of the nodes (dk why it fixes the problem)
-        const QPointF offset = zoomMult * (node->canvasPosition() - _offset) + this->rect().center();
+    bool bIsOverview = _renderDetail == RenderDetail::Overview;
 
-        node->move(offset.toPoint());
-        node->setFixedSize(node->normalSize() * zoomMult);
-    });
+    // manage NODES
+    if (bIsOverview)
+    {
+        FrameProfiler::ScopedPhase phase(_frameProfiler, FramePhase::NodeLayout);
+        if (!_bIsTiledRenderingEnabled)
+            paintOverview(painter, rectangle, zoomMult);
+    }
+    else
+    {
+        FrameProfiler::ScopedPhase phase(_frameProfiler, FramePhase::NodeLayout);
+
+        std::ranges::for_each(_nodes, [&](QSharedPointer<BaseNode> &node) {
+            if (isCollapsed(node->ID()))
+                return;
+
+            // this->rect()->center() is used instead of center purposefully
+            // in order to fix flicking and lagging of the nodes (dk why it fixes the problem)
+            const QPointF offset = zoomMult * (node->canvasPosition() - _offset) + this->rect().center();
+
+            node->move(offset.toPoint());
+            node->setFixedSize(node->normalSize() * zoomMult);
+            if (_zoomAnimation->state() != QAbstractAnimation::Running)
+                node->placePins(zoomMult);
+            // the size of a node is known only after it has been laid out
+            updateNodeBounds(node.get());
+
+            // widgets outside of the viewport aren't painted by Qt
+            if (node->geometry().intersects(rectangle))
+                stats.nodesDrawn++;
+            else
+                stats.nodesCulled++;
+
+            inputs.nodesPositionsSum += node->canvasPosition();
+        });
+    }
+
+    // edges use pins' positions, so tiles go after the node widgets have been moved
+    if (_bIsTiledRenderingEnabled)
+    {
+        FrameProfiler::ScopedPhase phase(_frameProfiler, FramePhase::Background);
+        paintTiles(painter, rectangle, zoomMult);
+    }
 
 
     // draw SELECTION RECT
@@ -617,12 +2135,13 @@ void Canvas::paint(QPainter *painter, QPaintEvent *event)
 
 
     // draw PINS CONNECTIONS
+    if (!bIsOverview)
     {
-        pen.setWidth(c_pinConnectLineWidth * zoomMult);
-        painter->setPen(pen);
         // manage currently dragged pin
         if (_draggedPin && _draggedPinTargetInfo)
         {
+            FrameProfiler::ScopedPhase phase(_frameProfiler, FramePhase::DragPreview);
+
             bool bThereIsTargetPin = static_cast<bool>(_draggedPinTargetInfo.value());
             QPoint origin = _nodes[_draggedPin->nodeID]->getOutlineCoordinateForPinID(_draggedPin->pinID);
             QPoint target = bThereIsTargetPin
@@ -634,73 +2153,315 @@ void Canvas::paint(QPainter *painter, QPaintEvent *event)
             if (_draggedPin->pinDirection != PinDirection::Out)
                 std::swap(origin, target);
 
-            QLinearGradient gradient(origin, target);
-
-
-
             QColor color0 = getColorOfPinByPinData(*_draggedPin);
             QColor color1 = bThereIsTargetPin ? getColorOfPinByPinData(*_draggedPinTargetInfo.value()) : color0;
 
             if (_draggedPin->pinDirection == PinDirection::In)
                 std::swap(color0, color1);
 
-            gradient.setColorAt(0, color0);
-            gradient.setColorAt(1, color1);
-            pen.setBrush(QBrush(gradient));
-            painter->setPen(pen);
+            painter->setPen(edgePen(color0, color1, origin, target, levelZoomMult));
 
-            painter->drawPath(standardPath(origin, target, zoomMult));
+            standardPath(_edgePath, origin, target, zoomMult);
+            painter->drawPath(_edgePath);
         }
+    }
+
+    if (!bIsOverview && !_bIsTiledRenderingEnabled)
+    {
+        FrameProfiler::ScopedPhase phase(_frameProfiler, FramePhase::Edges);
+
+        struct EdgeToPaint
+        {
+            QPoint origin, target;
+            const QColor *originColor, *targetColor;
+            const EdgeRoute *route;
+        };
+
+        if (_bIsEdgeRoutingEnabled)
+            _edgeRouter.beginFrame(c_edgeRoutesPerFrame);
+
+        auto edges = _frameArena.makeVector<EdgeToPaint>(_connectedPins.size());
+
+        // curve's control points lie between the ends horizontally or at most
+        // c_maxDiffsSum beyond them, so the curve stays within this margin
+        const float edgeMargin = (c_maxDiffsSum + c_pinConnectLineWidth) * zoomMult;
 
-        // draw all existing pins connections
-        std::ranges::for_each(_connectedPins.asKeyValueRange(), [&](std::pair<PinData, PinData> pair) {
+        // collect all existing pins connections
+        std::ranges::for_each(_connectedPins.asKeyValueRange(), [&](std::pair<const PinData &, const PinData &> pair) {
             // connections are being drawed from out- to in-pins only
             if (pair.first.pinDirection == PinDirection::In) return;
 
-            QPoint origin = _nodes[pair.first.nodeID]->getOutlineCoordinateForPinID(pair.first.pinID);
-            QPoint target = _nodes[pair.second.nodeID]->getOutlineCoordinateForPinID(pair.second.pinID);
+            // edges inside of a group aren't drawn, the ones leaving it go from the group's pins
+            const auto shown = shownEdge(pair.first, pair.second);
+            if (!shown) return;
+            const auto &[outPin, inPin] = *shown;
+
+            QPoint origin = _nodes[outPin.nodeID]->getOutlineCoordinateForPinID(outPin.pinID);
+            QPoint target = _nodes[inPin.nodeID]->getOutlineCoordinateForPinID(inPin.pinID);
+
+            bool bIsCulled = std::max(origin.x(), target.x()) + edgeMargin < rectangle.left()
+                || std::min(origin.x(), target.x()) - edgeMargin > rectangle.right()
+                || std::max(origin.y(), target.y()) + edgeMargin < rectangle.top()
+                || std::min(origin.y(), target.y()) - edgeMargin > rectangle.bottom();
+
+            // a routed edge may go farther than its curve would
+            const EdgeRoute *cached = _bIsEdgeRoutingEnabled ? _edgeRouter.cachedRoute(outPin, inPin) : nullptr;
+            if (bIsCulled && cached)
+                bIsCulled = !QRectF(mapFromCanvas(cached->corridor.topLeft()), mapFromCanvas(cached->corridor.bottomRight())).intersects(rectangle);
+
+            if (bIsCulled)
+            {
+                stats.edgesCulled++;
+                return;
+            }
+
+            const EdgeRoute *route = _bIsEdgeRoutingEnabled
+                ? _edgeRouter.route(outPin, inPin, mapToCanvas(QPointF(origin)), mapToCanvas(QPointF(target)))
+                : nullptr;
+            edges.push_back({ origin, target, &getColorOfPinByPinData(outPin), &getColorOfPinByPinData(inPin), route });
+        });
+        stats.edgesDrawn = static_cast<int>(edges.size());
 
-            QLinearGradient gradient(origin, target);
-            gradient.setColorAt(0, getColorOfPinByPinData(pair.first));
-            gradient.setColorAt(1, getColorOfPinByPinData(pair.second));
-            pen.setBrush(QBrush(gradient));
-            painter->setPen(pen);
+        std::ranges::for_each(edges, [&](const EdgeToPaint &edge) {
+            painter->setPen(edgePen(*edge.originColor, *edge.targetColor, edge.origin, edge.target, levelZoomMult));
 
-            painter->drawPath(standardPath(origin, target, zoomMult));
+            if (edge.route)
+                routedPath(_edgePath, edge.route->points, c_edgeRouteCornerRadius * zoomMult, canvasTransform());
+            else
+                standardPath(_edgePath, edge.origin, edge.target, zoomMult);
+            painter->drawPath(_edgePath);
         });
+
+        // routes over the frame's budget are finished in the next frames
+        if (_bIsEdgeRoutingEnabled && _edgeRouter.hasPendingRoutes())
+            QMetaObject::invokeMethod(this, qOverload<>(&QWidget::update), Qt::QueuedConnection);
     }
 
 
     // manage NODEFACTORYWIDGET
     {
+        FrameProfiler::ScopedPhase phase(_frameProfiler, FramePhase::WidgetCompositing);
+
         _nfWidget->setFixedSize(_nfWidget->getDesiredSize());
         _nfWidget->move(_nfWidget->getPosition().toPoint());
         _nfWidget->raise();
 
     }
 
+    // manage MINIMAP
+    if (_minimap->isVisible())
+    {
+        FrameProfiler::ScopedPhase phase(_frameProfiler, FramePhase::WidgetCompositing);
+
+        _minimap->setFixedSize(_minimap->getDesiredSize());
+        _minimap->move(_minimap->getPosition().toPoint());
+        _minimap->raise();
+        _minimap->setViewport(QRectF(mapToCanvas(QPointF(this->rect().topLeft())), mapToCanvas(QPointF(this->rect().bottomRight()))));
+        if (_minimap->raster().isDirty())
+            _minimap->update();
+    }
+
+    checkFrameAllocations(inputs, AllocationCounter::count() - allocationsAtStart);
 
-    // telemetrics 
+    if (_bIsProfilerOverlayVisible)
     {
         pen.setColor(c_dotsColor);
+        pen.setWidth(1);
         painter->setPen(pen);
+        paintProfilerOverlay(painter);
+    }
+}
 
-        auto pointToString = [](QPoint point) {
-            return QString::number(point.x()) + ", " + QString::number(point.y());
-        };
+void Canvas::paintOverview(QPainter *painter, const QRect &rectangle, float zoomMult)
+{
+    auto intersectsViewport = [&](QPointF first, QPointF second) {
+        return std::max(first.x(), second.x()) >= rectangle.left() && std::min(first.x(), second.x()) <= rectangle.right()
+            && std::max(first.y(), second.y()) >= rectangle.top() && std::min(first.y(), second.y()) <= rectangle.bottom();
+    };
 
-        auto pointfToString = [](QPointF point) {
-            return QString::number(point.x()) + ", " + QString::number(point.y());
-        };
+    FrameStats &stats = _frameProfiler.current();
+
+    auto nodeRects = _frameArena.makeVector<QRectF>(_nodes.size());
+    auto selectedNodeRects = _frameArena.makeVector<QRectF>(_selection.size());
+
+    std::ranges::for_each(_nodes, [&](const QSharedPointer<BaseNode> &node) {
+        if (isCollapsed(node->ID()))
+            return;
+
+        QRectF rect(mapFromCanvas(node->canvasPosition()), QSizeF(node->normalSize()) * zoomMult);
+        if (!intersectsViewport(rect.topLeft(), rect.bottomRight()))
+        {
+            stats.nodesCulled++;
+            return;
+        }
+
+        (node->isSelected() ? selectedNodeRects : nodeRects).push_back(rect);
+    });
+
+    updateOverviewEdges();
+
+    // one straight line per connected node pair, from the right side of the out-node
+    // to the left side of the in-node
+    auto lines = _frameArena.makeVector<QLineF>(_overviewEdges.size());
+    std::ranges::for_each(_overviewEdges, [&](const QPair<int, int> &pair) {
+        const BaseNode *outNode = _nodes[pair.first].get();
+        const BaseNode *inNode = _nodes[pair.second].get();
+
+        QPointF origin = mapFromCanvas(outNode->canvasPosition() + QPointF(outNode->normalSize().width(), outNode->normalSize().height() / 2.0));
+        QPointF target = mapFromCanvas(inNode->canvasPosition() + QPointF(0, inNode->normalSize().height() / 2.0));
+        if (intersectsViewport(origin, target))
+            lines.emplace_back(origin, target);
+        else
+            stats.edgesCulled++;
+    });
+
+    stats.nodesDrawn = static_cast<int>(nodeRects.size() + selectedNodeRects.size());
+    stats.edgesDrawn = static_cast<int>(lines.size());
+
+    painter->setRenderHint(QPainter::Antialiasing, false);
+
+    QPen pen(c_highlightColor);
+    pen.setWidthF(std::max(1.0f, c_pinConnectLineWidth * zoomMult));
+    painter->setPen(pen);
+    painter->drawLines(lines.data(), static_cast<int>(lines.size()));
+
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(c_nodesBackgroundColor);
+    painter->drawRects(nodeRects.data(), static_cast<int>(nodeRects.size()));
+    painter->setBrush(c_selectionColor);
+    painter->drawRects(selectedNodeRects.data(), static_cast<int>(selectedNodeRects.size()));
+    painter->setBrush(Qt::NoBrush);
+
+    painter->setRenderHint(QPainter::Antialiasing, true);
+}
+
+void Canvas::updateOverviewEdges()
+{
+    if (!_bIsOverviewEdgesDirty)
+        return;
+
+    QSet<QPair<int, int>> pairs;
+    // collapsed nodes are connected through their groups
+    std::ranges::for_each(_connectedPins.asKeyValueRange(), [&](std::pair<const PinData &, const PinData &> pair) {
+        const int outNodeID = _groupOfNode.value(pair.first.nodeID, pair.first.nodeID);
+        const int inNodeID = _groupOfNode.value(pair.second.nodeID, pair.second.nodeID);
+        if (outNodeID != inNodeID)
+            pairs.insert(QPair<int, int>(outNodeID, inNodeID));
+    });
+    _overviewEdges = QVector<QPair<int, int>>(pairs.begin(), pairs.end());
+    _bIsOverviewEdgesDirty = false;
+}
+
+void Canvas::paintTiles(QPainter *painter, const QRect &rectangle, float zoomMult)
+{
+    if (_bIsTileSceneDirty)
+    {
+        _bIsTileSceneDirty = false;
+        buildTileScene();
+        _tileRenderer.invalidate();
+    }
+
+    // tiles are rendered for the zoom level and scaled to the exact zoom
+    const float levelZoomMult = getLevelZoomMultiplier();
+    const qreal scale = zoomMult / levelZoomMult;
+    const QPointF origin = QPointF(this->rect().center()) - zoomMult * _offset;
+    const QRect viewport = QRectF((QPointF(rectangle.topLeft()) - origin) / scale, QSizeF(rectangle.size()) / scale).toAlignedRect();
+
+    float dotGap = levelZoomMult * _dotPaintGap;
+    if (dotGap < _dotPaintGap / 2)
+        dotGap *= 6;
+
+    painter->save();
+    painter->translate(origin);
+    painter->scale(scale, scale);
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, scale != 1.0);
+    _tileRenderer.paint(painter, _tileScene, QPoint(0, 0), viewport, levelZoomMult, dotGap);
+    painter->restore();
+
+    // routes over the frame's budget are finished in the next frames
+    if (_bIsTileSceneDirty)
+        QMetaObject::invokeMethod(this, qOverload<>(&QWidget::update), Qt::QueuedConnection);
+}
+
+void Canvas::buildTileScene()
+{
+    _tileScene.clear();
+
+    if (_renderDetail == RenderDetail::Overview)
+    {
+        _tileScene.bHasStraightEdges = true;
+        std::ranges::for_each(_nodes, [&](const QSharedPointer<BaseNode> &node) {
+            if (!isCollapsed(node->ID()))
+                _tileScene.addNode({ QRectF(node->canvasPosition(), QSizeF(node->normalSize())), node->isSelected() });
+        });
 
-        QPoint mouseCanvasPosition = mapToCanvas(_mousePosition.toPoint());
-        painter->drawText(QPoint(20, 20), QString( "Mouse on canvas: " + pointToString(mouseCanvasPosition) ));
-        painter->drawText(QPoint(20, 40), QString( "Mouse in viewport: " + pointfToString(_mousePosition) ));
-        painter->drawText(QPoint(20, 60), QString( "Size: " + QString::number(rectangle.width()) + ", " + QString::number(rectangle.height()) ));
-        painter->drawText(QPoint(20, 80), QString( "Center: " + pointfToString(_offset) ));
-        painter->drawText(QPoint(20, 100), QString( "Zoom: " + QString::number(_zoom) ));
-        painter->drawText(QPoint(20, 120), QString( "Drag pos: " + pointToString(_draggedPinTarget) ));
+        updateOverviewEdges();
+        std::ranges::for_each(_overviewEdges, [&](const QPair<int, int> &pair) {
+            const BaseNode *outNode = _nodes[pair.first].get();
+            const BaseNode *inNode = _nodes[pair.second].get();
+            _tileScene.addEdge({ outNode->canvasPosition() + QPointF(outNode->normalSize().width(), outNode->normalSize().height() / 2.0),
+                                 inNode->canvasPosition() + QPointF(0, inNode->normalSize().height() / 2.0),
+                                 c_highlightColor, c_highlightColor, QVector<QPointF>() });
+        });
+        return;
     }
+
+    if (_bIsEdgeRoutingEnabled)
+        _edgeRouter.beginFrame(c_edgeRoutesPerFrame);
+
+    std::ranges::for_each(_connectedPins.asKeyValueRange(), [&](std::pair<const PinData &, const PinData &> pair) {
+        if (pair.first.pinDirection == PinDirection::In) return;
+
+        const auto shown = shownEdge(pair.first, pair.second);
+        if (!shown) return;
+        const auto &[outPin, inPin] = *shown;
+
+        const QPointF origin = mapToCanvas(QPointF(_nodes[outPin.nodeID]->getOutlineCoordinateForPinID(outPin.pinID)));
+        const QPointF target = mapToCanvas(QPointF(_nodes[inPin.nodeID]->getOutlineCoordinateForPinID(inPin.pinID)));
+        const EdgeRoute *route = _bIsEdgeRoutingEnabled ? _edgeRouter.route(outPin, inPin, origin, target) : nullptr;
+
+        _tileScene.addEdge({ origin, target,
+                             _nodes[outPin.nodeID]->getPinByID(outPin.pinID)->getColor(),
+                             _nodes[inPin.nodeID]->getPinByID(inPin.pinID)->getColor(),
+                             route ? route->points : QVector<QPointF>() });
+    });
+
+    // the scene is rebuilt until every route is there
+    _bIsTileSceneDirty = _bIsEdgeRoutingEnabled && _edgeRouter.hasPendingRoutes();
 }
 
+void Canvas::paintProfilerOverlay(QPainter *painter)
+{
+    // stats of the last finished frame: the current one isn't composited yet
+    const FrameStats &stats = _frameProfiler.lastFrame();
+
+    auto ms = [&](FramePhase phase) { return stats.phase(phase) / 1.0e6; };
+
+    // lines are formatted into a stack buffer and copied into strings that keep
+    // their capacity, so showing the overlay doesn't allocate per frame
+    std::array<char, 128> buffer;
+    auto setLine = [&](int index, int length) {
+        _overlayLines[index].resize(0);
+        _overlayLines[index].append(QLatin1StringView(buffer.data(), std::min<int>(length, buffer.size() - 1)));
+    };
+
+    setLine(0, std::snprintf(buffer.data(), buffer.size(), "Frame %llu: %.2f ms, %llu allocations",
+                             static_cast<unsigned long long>(stats.frameNumber), stats.totalNs / 1.0e6,
+                             static_cast<unsigned long long>(stats.allocations)));
+    setLine(1, std::snprintf(buffer.data(), buffer.size(), "Background: %.2f ms, node layout: %.2f ms",
+                             ms(FramePhase::Background), ms(FramePhase::NodeLayout)));
+    setLine(2, std::snprintf(buffer.data(), buffer.size(), "Edges: %.2f ms, drag preview: %.2f ms",
+                             ms(FramePhase::Edges), ms(FramePhase::DragPreview)));
+    setLine(3, std::snprintf(buffer.data(), buffer.size(), "Widget compositing: %.2f ms",
+                             ms(FramePhase::WidgetCompositing)));
+    setLine(4, std::snprintf(buffer.data(), buffer.size(), "Nodes drawn / culled: %d / %d",
+                             stats.nodesDrawn, stats.nodesCulled));
+    setLine(5, std::snprintf(buffer.data(), buffer.size(), "Edges drawn / culled: %d / %d",
+                             stats.edgesDrawn, stats.edgesCulled));
+
+    for (int i = 0; i < static_cast<int>(_overlayLines.size()); i++)
+        painter->drawText(QPoint(20, 20 * (i + 1)), _overlayLines[i]);
+}
+
+
 }
@@ -9,8 +9,14 @@
 #include <QMouseEvent>
 #include <QPointF>
 #include <QVector>
-#include <QTimer>
 #include <QWheelEvent>
+#include <QHash>
+#include <QPen>
+#include <QPainterPath>
+#include <QTransform>
+#include <QFutureWatcher>
+#include <QVariantAnimation>
+#include <array>
 #include <optional>
 #include <variant>
 
@@ -19,6 +25,26 @@
 #include "TypeManagers/nodetypemanager.h"
 #include "TypeManagers/pintypemanager.h"
 #include "GraphWidgets/Abstracts/basenode.h"
+#include "GraphWidgets/minimap.h"
+#include "GraphWidgets/groupnode.h"
+#include "Render/framearena.h"
+#include "Render/renderdetail.h"
+#include "Render/zoomlevel.h"
+#include "Render/noderendercache.h"
+#include "Render/frameprofiler.h"
+#include "Render/frameclock.h"
+#include "Render/kineticpan.h"
+#include "History/commandjournal.h"
+#include "Layout/layoutgraph.h"
+#include "Layout/layeredlayout.h"
+#include "Layout/forcelayout.h"
+#include "Layout/edgerouter.h"
+#include "Spatial/spatialindex.h"
+#include "Selection/selectionset.h"
+#include "Analysis/graphquery.h"
+#include "Search/nodesearchindex.h"
+#include "Render/tilerenderer.h"
+#include "Export/exportoptions.h"
 #include "GraphLib_global.h"
 
 
@@ -32,14 +58,33 @@ public:
     Canvas(QWidget *parent = nullptr);
     ~Canvas();
 
-    float getZoomMultiplier() const     { return _zoomMultipliers[_zoom]; }
+    float getZoomMultiplier() const     { return _zoom; }
+    // Zoom quantized to a level, nodes are laid out and cached per level
+    short getZoomLevel() const          { return zoomLevelFor(_zoom); }
+    float getLevelZoomMultiplier() const { return zoomMultiplierForLevel(getZoomLevel()); }
     bool getSnappingEnabled() const     { return _bIsSnappingEnabled; }
+    bool getEdgeRoutingEnabled() const  { return _bIsEdgeRoutingEnabled; }
+    bool isTiledRenderingEnabled() const { return _bIsTiledRenderingEnabled; }
+    bool isKineticPanningEnabled() const { return _bIsKineticPanningEnabled; }
     int getSnappingInterval() const     { return _snappingInterval; }
     const QPointF &getOffset() const    { return _offset; }
     QString getPinText(int nodeID, int pinID) const;
     QString getNodeName(int nodeID) const;
 
     void setSnappingInterval(int num) { _snappingInterval = num; }
+    // Routed edges go around the nodes standing in the way of their standard curve
+    void setEdgeRoutingEnabled(bool bEnabled);
+    // Background, edges and overview nodes are rasterized into cached tiles on worker threads,
+    // the GUI thread only composites them. Node widgets are painted by Qt as usual
+    void setTiledRenderingEnabled(bool bEnabled);
+    // Panning with the right button keeps going after release and slows down
+    void setKineticPanningEnabled(bool bEnabled);
+    // Input is applied and the canvas is repainted once per frame of the clock
+    FrameClock *frameClock() const { return _frameClock; }
+    void requestFrame() { _frameClock->requestFrame(); }
+    const TileRenderer &tileRenderer() const { return _tileRenderer; }
+    Minimap *minimap() const { return _minimap; }
+    void setMinimapVisible(bool bVisible) { _minimap->setVisible(bVisible); }
     void setNodeTypeManager(const NodeTypeManager *manager);
     void setPinTypeManager(const PinTypeManager *manager);
     inline void setTypeManagers(const PinTypeManager *pins, const NodeTypeManager *nodes) { setNodeTypeManager(nodes); setPinTypeManager(pins); }
@@ -51,22 +96,126 @@ public:
 
     QPointF mapToCanvas(QPointF point) const;
     QPoint mapToCanvas(QPoint point) const;
+    QPointF mapFromCanvas(QPointF point) const;
+    // Same mapping as mapFromCanvas
+    QTransform canvasTransform() const;
+    RenderDetail getRenderDetail() const { return _renderDetail; }
+    NodeRenderCache &nodeRenderCache() const { return _nodeRenderCache; }
+    // Nodes' rects in canvas coordinates keyed by node ID
+    const SpatialIndex &nodeIndex() const { return _nodeIndex; }
+    const SelectionSet &selection() const { return _selection; }
+    bool isNodeSelected(int nodeID) const { return _selection.contains(nodeID); }
+    // Reachability, cycles and components of the graph, kept up to date with every edit
+    const GraphQuery &graphQuery() const { return _graphQuery; }
+    bool areCyclesAllowed() const { return _bAreCyclesAllowed; }
+    // When cycles aren't allowed, dragging a connection that would close one is refused
+    void setCyclesAllowed(bool bAllowed) { _bAreCyclesAllowed = bAllowed; }
+    void selectAll();
+    void invertSelection();
+    void clearSelection();
 
-    // If one or more of params of QPointF is negative, current mouse position will be used
+    // Replaces the selected nodes with one group node, returns its ID or -1 if fewer than two
+    // nodes are selected. Selected groups are merged into the new one, groups don't nest
+    int collapseSelection();
+    // Shows the group's members again where the group has moved them and removes the group
+    void expandGroup(int groupID);
+    void expandSelectedGroups();
+    // The node is hidden inside of a group
+    bool isCollapsed(int nodeID) const { return _groupOfNode.contains(nodeID); }
+    bool isGroup(int nodeID) const { return _groups.contains(nodeID); }
+    // nullptr if there's no such group
+    GroupNode *group(int groupID) const { return _groups.value(groupID); }
+
+    // Names and type names of the nodes, kept up to date with every insertion, rename and removal
+    const NodeSearchIndex &searchIndex() const { return _searchIndex; }
+    // Nodes whose name or type name starts with the query, then the ones similar to it
+    QVector<int> findNodes(const QString &query, int limit = c_searchResultsLimit) const { return _searchIndex.find(query, limit); }
+    // Centers the view at the node and selects it, a collapsed node is shown by its group
+    void jumpToNode(int nodeID);
+
+    // Timings and counters of the last finished frame
+    const FrameStats &frameStats() const { return _frameProfiler.lastFrame(); }
+    FrameProfiler &frameProfiler() const { return _frameProfiler; }
+    bool isProfilerOverlayVisible() const { return _bIsProfilerOverlayVisible; }
+    void setProfilerOverlayVisible(bool bVisible);
+
+    // If one or more of params of QPointF is negative, current mouse position will be used.
+    // Every step multiplies the zoom by c_zoomStepRatio, the change is animated
     void zoomIn(int times = 1, QPointF where = QPointF(-1, -1));
 
     // If one of params of QPointF is negative, current mouse position will be used
     void zoomOut(int times = 1, QPointF where = QPointF(-1, -1));
 
+    // Sets the zoom at once keeping the point in place, same as above if it's negative
+    void setZoom(float zoomMult, QPointF where = QPointF(-1, -1));
+
     QWeakPointer<BaseNode> addBaseNode(QPoint canvasPosition, QString name);
     QWeakPointer<BaseNode> addNode(BaseNode *node);
     QWeakPointer<BaseNode> addTypedNode(QPoint canvasPosition, int typeID);
+    void removeNode(int nodeID);
+    // Connects an out-pin to an in-pin the same way dragging between them does
+    void connectPins(PinData outPin, PinData inPin);
+
+    // Bulk insertion: the canvas is repainted once after the whole batch.
+    // Nodes are given as (canvas position, type ID), connections as (out-pin, in-pin)
+    QVector<QWeakPointer<BaseNode>> addTypedNodes(const QVector<QPair<QPoint, int>> &nodes);
+    void connectPins(const QVector<QPair<PinData, PinData>> &connections);
+
+    // Moves, connections and added or removed nodes are recorded into the journal
+    void undo();
+    void redo();
+    CommandJournal &journal() { return _journal; }
+    const CommandJournal &journal() const { return _journal; }
+
+    // Selected nodes with the connections between them
+    Subgraph selectedSubgraph() const;
+    // Adds the subgraph with new IDs, its top-left node at the canvas position.
+    // Returns IDs of the added nodes in the order of the subgraph's nodes
+    QVector<int> addSubgraph(const Subgraph &subgraph, QPointF canvasPosition);
+    void copySelection() const;
+    void cutSelection();
+    // Pastes at the cursor and selects the pasted nodes
+    void paste();
+
+    LayoutGraph layoutSnapshot() const;
+    bool isLayoutAnimating() const { return _layoutAnimation->state() == QAbstractAnimation::Running; }
+    // Moves the nodes in one undoable step, optionally animating the transition.
+    // Positions are snapped to the snapping interval when snapping is enabled
+    void applyLayout(const LayoutPositions &positions, bool bAnimate = true);
+    // Lays the graph out on a worker thread and applies the result when it's ready.
+    // Starting another layout cancels the running one
+    QFuture<LayoutPositions> layoutLayered(const LayeredLayoutOptions &options = LayeredLayoutOptions());
+    // Same as layoutLayered. If edited nodes are given, only the nodes around them settle
+    // and the rest of the graph stays where it is
+    QFuture<LayoutPositions> layoutForceDirected(const ForceLayoutOptions &options = ForceLayoutOptions(),
+                                                 const QVector<int> &editedNodeIDs = {});
+
+    // Bounding rect of every node with the margin around, in canvas coordinates
+    QRectF exportArea(const ExportOptions &options = ExportOptions()) const;
+    // Empty for an empty graph, a scale that isn't positive and images over c_exportMaxSide on a side
+    QSize exportSize(const ExportOptions &options = ExportOptions()) const;
+    // Paints the graph within the canvas area. The painter is expected to map canvas coordinates
+    // to its device, the viewport and the zoom of the canvas are ignored
+    void renderGraph(QPainter *painter, const QRectF &canvasArea, const ExportOptions &options = ExportOptions());
+    // The whole graph is exported independently of the viewport, so a hidden canvas works as well.
+    // PNG is rendered and written in strips that fit the memory budget
+    bool exportPng(QIODevice *device, const ExportOptions &options = ExportOptions());
+    bool exportPng(const QString &path, const ExportOptions &options = ExportOptions());
+    bool exportSvg(const QString &path, const ExportOptions &options = ExportOptions());
 
 public slots:
     void moveCanvas(QPointF offset);
+    // Call after types were added to or replaced in the managers, e.g. by a TypeCatalogWatcher.
+    // Nodes already on the canvas keep the pins of the types they were made of
+    void reloadTypes();
+    // Call after pin types were added or replaced. Pins of those types on the canvas, and the
+    // group pins standing for them, are colored again
+    void reloadPinTypes(const QVector<int> &pinTypeIDs);
 
 signals:
     void onNodesRemoved();
+    void onLayoutProgress(int percent);
+    void onLayoutFinished();
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -82,18 +231,89 @@ protected:
 
 private slots:
     void onNodeSelect(bool bIsMultiSelectionModifierDown, int nodeID);
+    void onNodeDeselect(int nodeID);
     void onPinDrag(PinDragSignal signal);
     void onPinConnect(PinData outPin, PinData inPin);
     void onPinConnectionBreak(PinData outPin, PinData inPin);
     void onNFWidgetMove(QVector2D offset);
-    void tick();
+    void onMinimapMove(QVector2D offset);
+    void onNodeDrag(int nodeID, QPointF canvasPosition);
+    void onNodeMoveFinished();
+    void onNodeRename(int nodeID, const QString &name);
+    void onFrame(qint64 elapsedNs);
 
 private:
+    // Everything a frame depends on; used to detect steady-state repaints
+    struct FrameInputs
+    {
+        QPointF offset, mousePosition, nodesPositionsSum;
+        QSize size;
+        float zoom;
+        qsizetype nodes, connections;
+        std::optional<QRect> selectionRect;
+        bool bIsPinDragged;
+        QPoint draggedPinTarget;
+
+        bool operator==(const FrameInputs &other) const = default;
+    };
+
     void paint(QPainter *painter, QPaintEvent *event);
-    void moveCanvasOnPinDragNearEdge(QPointF mousePosition);
+    void paintOverview(QPainter *painter, const QRect &rectangle, float zoomMult);
+    void setRenderDetail(RenderDetail detail);
+    void paintProfilerOverlay(QPainter *painter);
+    void paintTiles(QPainter *painter, const QRect &rectangle, float zoomMult);
+    void buildTileScene();
+    void updateOverviewEdges();
+    // Pin an edge is drawn to: the group's pin for a collapsed member's pin
+    PinData shownPin(const PinData &pin) const;
+    // Pins the edge is drawn between, nothing for the edges hidden inside of a group
+    std::optional<QPair<PinData, PinData>> shownEdge(const PinData &outPin, const PinData &inPin) const;
+    // Groups are kept at their members' top-left corner
+    QPointF membersTopLeft(const QVector<int> &members) const;
+    // Puts the groups of the moved members back to their top-left corner, e.g. after an undo or a layout
+    void placeGroups(const QVector<NodeMove> &moves);
+    const QPen &edgePen(const QColor &originColor, const QColor &targetColor, QPoint origin, QPoint target, float zoomMult);
+    void checkFrameAllocations(const FrameInputs &inputs, quint64 allocations);
+    // Moves by the time elapsed since the last frame, returns false if the cursor isn't near an edge
+    bool moveCanvasOnPinDragNearEdge(QPointF mousePosition, qint64 elapsedNs);
     void zoom(int times, QPointF where);
+    // Trims the caches to the levels around the new one and prefetches the next levels' fonts
+    void onZoomLevelChanged(short previousLevel, short level);
+    void prefetchZoomLevels(short level, int direction);
     void deleteNode(QSharedPointer<BaseNode> &ptr);
-    void processSelectionArea(const QMouseEvent *event);
+    // Removes the nodes recording them as one command
+    void removeNodes(const QVector<int> &nodeIDs);
+    // Keeps the node's rect in the spatial index up to date, invalidating routes around it
+    void updateNodeBounds(const BaseNode *node);
+    // Inserts a node that already has its ID
+    QWeakPointer<BaseNode> insertNode(BaseNode *node);
+    // Both return false if nothing has changed
+    bool insertConnection(const PinData &outPin, const PinData &inPin);
+    bool eraseConnection(const PinData &outPin, const PinData &inPin);
+
+    NodeRecord nodeRecord(const BaseNode *node) const;
+    EdgeRecord edgeRecord(const PinData &outPin, const PinData &inPin) const;
+    // Nothing if a node or a pin doesn't exist or the edge doesn't go from an out-pin to an in-pin,
+    // e.g. for a pasted subgraph that is malformed or whose types have changed since it was copied
+    std::optional<QPair<PinData, PinData>> edgePins(const EdgeRecord &edge) const;
+    void recordCommand(Command command);
+    // Recreates the nodes with their IDs through the bulk path. Returns the edges that were restored
+    QVector<EdgeRecord> restoreNodes(const QVector<NodeRecord> &nodes, const QVector<EdgeRecord> &edges);
+    // Empty for untyped nodes and the types the canvas doesn't know
+    QString typeName(const BaseNode *node) const;
+    void applyCommand(const Command &command, bool bIsUndo);
+    void watchLayout(QFuture<LayoutPositions> future, bool bAnimate);
+    // Jumps a running layout animation to its end, before anything else moves the nodes
+    void stopLayoutAnimation();
+    void finishLayoutAnimation();
+    // Only the nodes the edges of the rubber band passed over since the last call are touched
+    void processSelectionArea(QPointF mousePosition);
+    // Moves the dragged node and the selection with it by one translation, recorded as one command
+    void applyPendingDrag();
+    // Repaints the nodes and the overview with the new selection
+    void onSelectionChanged();
+    // Lays every node out for the current zoom and updates the spatial index
+    void layoutNodes();
     static unsigned int newID() { return IDgenerator++; }
     static unsigned int IDgenerator;
 
@@ -111,24 +331,84 @@ private:
     std::optional< std::optional<PinData> > _draggedPinTargetInfo;
     QPoint _draggedPinTarget;
     QPointF _offset, _lastMouseDownPosition, _mousePosition;
-    short _zoom;
+    float _zoom;
+    // Zoom the running animation goes to and the point it keeps in place
+    float _zoomTarget;
+    QPointF _zoomAnchor;
+    QVariantAnimation *_zoomAnimation;
 
     QSize *_lastResizedSize;
 
+    FrameClock *_frameClock;
+    // Input collected since the last frame, applied all at once on the next one
+    QPointF _pendingPan;
+    int _pendingZoomSteps;
+    QPointF _pendingZoomAnchor;
+    std::optional<QPointF> _pendingSelectionPoint;
+    // Node dragged since the last frame and where it's dragged to
+    std::optional<QPair<int, QPointF>> _pendingDrag;
+    KineticPan _kineticPan;
+    bool _bIsKineticPanningEnabled;
+
     int _snappingInterval;
     bool _bIsSnappingEnabled;
     std::optional<QRect> _selectionRect;
-    QSet<int> _selectionAreaPreviousNodes;
+    // Canvas area of the rubber band the selection was last updated for
+    std::optional<QRectF> _selectionArea;
 
     QMap<int, QSharedPointer<BaseNode>> _nodes;
 
     // Key for _connectedPins is an out-pin and the value is an in-pin
     QMultiMap<PinData, PinData> _connectedPins;
-    QTimer *_timer;
     NodeFactoryModule::NodeFactoryWidget *_nfWidget;
-    QMap<int, QSharedPointer<BaseNode>> _selectedNodes;
+    Minimap *_minimap;
+    SelectionSet _selection;
+    // Collapsed node -> its group, and the groups by their IDs
+    QHash<int, int> _groupOfNode;
+    QHash<int, GroupNode*> _groups;
+    NodeSearchIndex _searchIndex;
+
+    FrameArena _frameArena;
+    // Reused for every edge, so drawing connections doesn't allocate a path per edge
+    QPainterPath _edgePath;
+    // Edge pens hold object-bounding gradients, so one pen serves every edge with
+    // the same colors and orientation. The cache is dropped when zoom changes
+    QHash<QPair<quint64, int>, QPen> _edgePens;
+    float _edgePensZoom;
+    mutable FrameProfiler _frameProfiler;
+    bool _bIsProfilerOverlayVisible;
+    std::array<QString, 6> _overlayLines;
+    std::optional<FrameInputs> _lastFrameInputs;
+    int _steadyFrames;
+
+    RenderDetail _renderDetail;
+    // Node pairs that have at least one connection (out-node, in-node),
+    // used to draw aggregated edges at RenderDetail::Overview. Rebuilt lazily
+    QVector<QPair<int, int>> _overviewEdges;
+    bool _bIsOverviewEdgesDirty;
+
+    // Rendered images of the nodes, see BaseNode::paint
+    mutable NodeRenderCache _nodeRenderCache;
+
+    CommandJournal _journal;
+    bool _bIsJournalPaused;
+
+    QFutureWatcher<LayoutPositions> *_layoutWatcher;
+    bool _bIsLayoutAnimated;
+    QVariantAnimation *_layoutAnimation;
+    QVector<NodeMove> _animatedMoves;
+
+    SpatialIndex _nodeIndex;
+    GraphQuery _graphQuery;
+    bool _bAreCyclesAllowed;
+    EdgeRouter _edgeRouter;
+    bool _bIsEdgeRoutingEnabled;
 
-    const static QMap<short, float> _zoomMultipliers;
+    bool _bIsTiledRenderingEnabled;
+    TileScene _tileScene;
+    TileRenderer _tileRenderer;
+    // The scene is rebuilt and every tile is rendered again on the next frame
+    bool _bIsTileSceneDirty;
 };
 
 }
@@ -0,0 +1,62 @@
+#include <algorithm>
+
+#include "groupnode.h"
+#include "pin.h"
+
+namespace GraphLib {
+
+GroupNode::GroupNode(int ID, Canvas *canvas, const QVector<int> &members)
+    : BaseNode(ID, canvas)
+    , _members{ members }
+    , _memberSet{ QSet<int>(members.begin(), members.end()) }
+    , _proxyPins{ QHash<quint64, int>() }
+    , _memberPins{ QHash<int, PinData>() }
+{
+    setName(QString("Group of %1").arg(members.size()));
+}
+
+void GroupNode::removeMember(int nodeID)
+{
+    if (!_memberSet.remove(nodeID))
+        return;
+    _members.removeOne(nodeID);
+
+    // the pins standing for the member's pins go away with it
+    QVector<int> pinIDs;
+    for (auto it = _memberPins.cbegin(); it != _memberPins.cend(); it++)
+        if (it.value().nodeID == nodeID)
+            pinIDs.append(it.key());
+    std::ranges::for_each(pinIDs, [&](int pinID) {
+        _proxyPins.remove(pinKey(nodeID, _memberPins.take(pinID).pinID));
+        removePin(pinID);
+    });
+}
+
+void GroupNode::addProxyPin(const AbstractPin *memberPin, const QString &memberName)
+{
+    const quint64 key = pinKey(memberPin->getNodeID(), memberPin->ID());
+    if (_proxyPins.contains(key))
+        return;
+
+    Pin *pin = new Pin(this);
+    pin->setColor(memberPin->getColor());
+    pin->setText(memberName + ": " + memberPin->getText());
+    pin->setDirection(memberPin->getDirection());
+    addPin(pin);
+    _pinsOutlineCoords.insert(pin->ID(), QPoint(0, 0));
+    // the member's connections are drawn to it
+    pin->setConnected(true);
+
+    _proxyPins.insert(key, pin->ID());
+    _memberPins.insert(pin->ID(), memberPin->getData());
+}
+
+PinData GroupNode::proxyPin(const PinData &memberPin) const
+{
+    auto it = _proxyPins.constFind(pinKey(memberPin.nodeID, memberPin.pinID));
+    if (it == _proxyPins.cend())
+        return memberPin;
+    return getPinByID(it.value())->getData();
+}
+
+}
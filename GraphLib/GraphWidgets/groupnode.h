@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QObject>
+#include <QWidget>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+#include "GraphWidgets/Abstracts/basenode.h"
+
+namespace GraphLib {
+
+// Stands in for a set of collapsed nodes. Its pins are the members' pins connected to nodes
+// outside of the group: connections stay between the members' pins, the canvas only draws
+// them to the group's pins and skips the ones inside the group. The hidden members are
+// moved along with the group, so they are where the group has taken them once expanded
+class GRAPHLIB_EXPORT GroupNode : public BaseNode
+{
+    Q_OBJECT
+
+public:
+    GroupNode(int ID, Canvas *canvas, const QVector<int> &members);
+
+    const QVector<int> &members() const { return _members; }
+    bool hasMember(int nodeID) const { return _memberSet.contains(nodeID); }
+    // Drops the member with the pins standing for its pins
+    void removeMember(int nodeID);
+
+    // Adds a pin standing for the member's pin, named after both
+    void addProxyPin(const AbstractPin *memberPin, const QString &memberName);
+    // Group's pin for a member's pin, the pin itself if the group has none for it
+    PinData proxyPin(const PinData &memberPin) const;
+    // Member's pin for a pin of the group, the pin itself if it isn't one
+    PinData memberPin(const PinData &groupPin) const { return _memberPins.value(groupPin.pinID, groupPin); }
+
+private:
+    static quint64 pinKey(int nodeID, int pinID) { return (quint64(quint32(nodeID)) << 32) | quint32(pinID); }
+
+    QVector<int> _members;
+    QSet<int> _memberSet;
+    // (member node, member pin) -> group's pin
+    QHash<quint64, int> _proxyPins;
+    // Group's pin -> member's pin
+    QHash<int, PinData> _memberPins;
+};
+
+}
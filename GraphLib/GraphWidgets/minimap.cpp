@@ -0,0 +1,132 @@
+#include <QApplication>
+
+#include "minimap.h"
+#include "constants.h"
+#include "utility.h"
+
+namespace GraphLib {
+
+Minimap::Minimap(QWidget *parent)
+    : QWidget{ parent }
+    , _painter{ new QPainter() }
+    , _position{ QPointF() }
+    , _lastMouseDownPosition{ QPointF() }
+    , _mousePressPosition{ QPointF() }
+    , _bIsViewportDragged{ false }
+    , _viewportGrabOffset{ QPointF() }
+    , _viewport{ QRectF() }
+    , _raster{ c_minimapRasterSize }
+{
+    setMouseTracking(true);
+}
+
+Minimap::~Minimap()
+{ delete _painter; }
+
+QSize Minimap::getDesiredSize() const
+{
+    QSize imageSize = _raster.image().size();
+    return QSize(imageSize.width() + c_minimapPadding * 2, imageSize.height() + c_minimapHeaderHeight + c_minimapPadding);
+}
+
+void Minimap::setViewport(const QRectF &viewport)
+{
+    if (viewport == _viewport)
+        return;
+
+    _viewport = viewport;
+    update();
+}
+
+
+// ------------------ EVENTS --------------------
+
+
+void Minimap::mousePressEvent(QMouseEvent *event)
+{
+    if (!(event->buttons() & Qt::MouseButton::LeftButton))
+        return;
+
+    // clicking the map outside of the viewport centers the view there and keeps dragging it
+    if (imageRect().contains(event->position().toPoint()))
+    {
+        _bIsViewportDragged = true;
+        QPointF canvasPoint = mapToCanvas(event->position());
+        _viewportGrabOffset = _viewport.contains(canvasPoint) ? canvasPoint - _viewport.center() : QPointF(0, 0);
+        onViewportMove(canvasPoint - _viewportGrabOffset);
+        return;
+    }
+
+    _lastMouseDownPosition = mapToParent(event->position());
+    _mousePressPosition = _lastMouseDownPosition - _position;
+}
+
+void Minimap::mouseReleaseEvent(QMouseEvent *)
+{
+    _bIsViewportDragged = false;
+    this->setCursor(QCursor(Qt::CursorShape::ArrowCursor));
+}
+
+void Minimap::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!(event->buttons() & Qt::MouseButton::LeftButton))
+        return;
+
+    if (_bIsViewportDragged)
+    {
+        onViewportMove(mapToCanvas(event->position()) - _viewportGrabOffset);
+        return;
+    }
+
+    if ((event->position() - _mousePressPosition).manhattanLength()
+        > QApplication::startDragDistance())
+        this->setCursor(QCursor(Qt::CursorShape::OpenHandCursor));
+
+    QVector2D offset = QVector2D(mapToParent(event->position()) - _lastMouseDownPosition);
+    _position = mapToParent(event->position()) - _mousePressPosition;
+
+    _lastMouseDownPosition = mapToParent(event->position());
+
+    onMove(offset);
+}
+
+
+// ------------------- PAINT ----------------------
+
+
+void Minimap::paintEvent(QPaintEvent *event)
+{
+    _painter->begin(this);
+    _painter->setRenderHint(QPainter::Antialiasing, true);
+    paint(_painter, event);
+    _painter->end();
+}
+
+void Minimap::paint(QPainter *painter, QPaintEvent *)
+{
+    QRect rect(QPoint(0, 0), getDesiredSize());
+
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(c_nfWidgetBackgroundColor);
+    painter->drawRoundedRect(rect, c_nodeRoundingRadius, c_nodeRoundingRadius);
+
+    painter->setPen(c_highlightColor);
+    painter->setFont(standardFont(13));
+    painter->drawText(QRect(rect.x(), rect.y(), rect.width(), c_minimapHeaderHeight),
+                      (Qt::AlignVCenter | Qt::AlignHCenter), "minimap");
+
+    // only the areas changed since the last frame are drawn again
+    _raster.update();
+    const QRect image = imageRect();
+    painter->drawImage(image.topLeft(), _raster.image());
+
+    // VIEWPORT
+    painter->save();
+    painter->setClipRect(image);
+    painter->setPen(c_selectionRectColor);
+    painter->setBrush(Qt::NoBrush);
+    painter->drawRect(_raster.mapFromCanvas(_viewport).translated(image.topLeft()));
+    painter->restore();
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QObject>
+#include <QWidget>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QVector2D>
+
+#include "Render/minimapraster.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Overview of the whole graph with the visible part of the canvas outlined. The outline
+// is dragged or clicked to move the view, the rest of the widget drags the widget itself.
+// The canvas places it the same way as the NodeFactoryWidget
+class GRAPHLIB_EXPORT Minimap : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit Minimap(QWidget *parent = nullptr);
+    ~Minimap();
+
+    QSize getDesiredSize() const;
+    const QPointF &getPosition() const { return _position; }
+    MinimapRaster &raster() { return _raster; }
+
+    void setPosition(QPointF pos) { _position = pos; }
+    inline void setPosition(qreal x, qreal y) { setPosition(QPointF(x, y)); }
+    void setX(qreal x) { setPosition(x, getPosition().y()); }
+    void setY(qreal y) { setPosition(getPosition().x(), y); }
+    void adjustPosition(QVector2D by) { _position += by.toPointF(); }
+    inline void adjustPosition(qreal x, qreal y) { adjustPosition(QVector2D(x, y)); }
+    // Visible part of the canvas in canvas coordinates
+    void setViewport(const QRectF &viewport);
+
+signals:
+    void onMove(QVector2D offset);
+    // The canvas point the view should be centered at
+    void onViewportMove(QPointF canvasCenter);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+private:
+    void paint(QPainter *painter, QPaintEvent *event);
+    // Where the raster is drawn in the widget
+    QRect imageRect() const { return QRect(QPoint(c_minimapPadding, c_minimapHeaderHeight), _raster.image().size()); }
+    QPointF mapToCanvas(QPointF widgetPoint) const { return _raster.mapToCanvas(widgetPoint - imageRect().topLeft()); }
+
+    QPainter *_painter;
+    QPointF _position, _lastMouseDownPosition, _mousePressPosition;
+    bool _bIsViewportDragged;
+    // Canvas offset from the viewport's center to the point it was grabbed at
+    QPointF _viewportGrabOffset;
+    QRectF _viewport;
+    MinimapRaster _raster;
+};
+
+}
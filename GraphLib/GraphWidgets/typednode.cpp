@@ -3,6 +3,7 @@
 #include "constants.h"
 #include "canvas.h"
 #include "utility.h"
+#include "Render/renderdetail.h"
 
 namespace GraphLib {
 
@@ -12,24 +13,26 @@ TypedNode::TypedNode(int typeID, Canvas *canvas) : TypedNode(-1, typeID, canvas)
 TypedNode::TypedNode(int ID, int typeID, Canvas *canvas)
     : BaseNode(ID, canvas)
     , _typeID{ typeID }
+    , _typeNameStaticText{ cachedText() }
 {}
 
 int TypedNode::calculateRowsOffset(QPainter *painter) const
 {
-    QFont font = standardFont(c_nodeNameSize * _zoom);
-    painter->setFont(font);
-    QSize nameBounding = painter->fontMetrics().size(Qt::TextSingleLine, _name);
-    return nameBounding.height() * 2.25f + c_normalPinD * _zoom;
+    painter->setFont(standardFont(c_nodeNameSize * _zoom));
+    return painter->fontMetrics().height() * 2.25f + c_normalPinD * _zoom;
 }
 
 void TypedNode::paintName(QPainter *painter, int desiredWidth, QPoint textOrigin)
 {
-    QSize nameBounding = painter->fontMetrics().size(Qt::TextSingleLine, _name);
-
     painter->setFont(standardFont(c_nodeNameSize * _zoom));
+    int nameHeight = painter->fontMetrics().height();
+    bool bUseCachedText = renderDetailForZoom(_zoom) == RenderDetail::Reduced;
 
-    painter->drawText(QRect(textOrigin.x(), textOrigin.y(), desiredWidth, nameBounding.height() * 2),
-                     (Qt::AlignVCenter | Qt::AlignHCenter), _name);
+    QRect nameRect(textOrigin.x(), textOrigin.y(), desiredWidth, nameHeight * 2);
+    if (bUseCachedText)
+        drawCachedText(painter, nameRect, _nameStaticText);
+    else
+        painter->drawText(nameRect, (Qt::AlignVCenter | Qt::AlignHCenter), _name);
 
     QPen pen = painter->pen();
     QColor temp = pen.color();
@@ -37,8 +40,15 @@ void TypedNode::paintName(QPainter *painter, int desiredWidth, QPoint textOrigin
     painter->setPen(pen);
     painter->setFont(standardFont(c_nodeNameSize * 0.75f * _zoom));
 
-    painter->drawText(QRect(textOrigin.x(), textOrigin.y() + nameBounding.height(), desiredWidth, nameBounding.height() * 2),
-                      (Qt::AlignVCenter | Qt::AlignHCenter), _nodeTypeManager->typeNameByID(_typeID));
+    QRect typeNameRect(textOrigin.x(), textOrigin.y() + nameHeight, desiredWidth, nameHeight * 2);
+    if (bUseCachedText)
+    {
+        if (_typeNameStaticText.text().isEmpty())
+            _typeNameStaticText.setText(_nodeTypeManager->typeNameByID(_typeID));
+        drawCachedText(painter, typeNameRect, _typeNameStaticText);
+    }
+    else
+        painter->drawText(typeNameRect, (Qt::AlignVCenter | Qt::AlignHCenter), _nodeTypeManager->typeNameByID(_typeID));
 
     pen.setColor(temp);
     painter->setPen(pen);
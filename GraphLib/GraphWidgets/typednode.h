@@ -20,7 +20,7 @@ public:
 
     int getTypeID() const { return _typeID; }
 
-    void setTypeID(int newTypeID) { _typeID = newTypeID; }
+    void setTypeID(int newTypeID) { _typeID = newTypeID; _typeNameStaticText.setText(QString()); invalidateRender(); }
 
     const NodeTypeManager *getNodeTypeManager() const { return _nodeTypeManager; }
     const PinTypeManager *getPinTypeManager() const { return _pinTypeManager; }
@@ -37,6 +37,8 @@ private:
 
 protected:
     int _typeID;
+    // Glyph run of the type name used at RenderDetail::Reduced, filled on first use
+    QStaticText _typeNameStaticText;
 
 };
 
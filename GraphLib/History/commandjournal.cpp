@@ -0,0 +1,148 @@
+#include <algorithm>
+
+#include "commandjournal.h"
+
+namespace GraphLib {
+
+namespace {
+
+qsizetype recordSize(const NodeRecord &record)
+{
+    return sizeof(NodeRecord) + record.name.capacity() * sizeof(QChar)
+         + record.pins.capacity() * sizeof(PinRecord);
+}
+
+template<typename T>
+qsizetype vectorSize(const QVector<T> &vector) { return vector.capacity() * sizeof(T); }
+
+}
+
+CommandJournal::CommandJournal(qsizetype memoryCapBytes)
+    : _commands{ std::deque<Entry>() }
+    , _undoCount{ 0 }
+    , _memoryUsage{ 0 }
+    , _memoryCap{ memoryCapBytes }
+    , _bIsSealed{ true }
+{}
+
+qsizetype CommandJournal::memorySize(const Command &command)
+{
+    auto nodesSize = [](const QVector<NodeRecord> &nodes) {
+        qsizetype size = (nodes.capacity() - nodes.size()) * sizeof(NodeRecord);
+        std::ranges::for_each(nodes, [&](const NodeRecord &record) { size += recordSize(record); });
+        return size;
+    };
+
+    qsizetype size = sizeof(Entry);
+    if (auto *move = std::get_if<MoveNodesCommand>(&command))
+        size += vectorSize(move->moves);
+    else if (auto *add = std::get_if<AddNodesCommand>(&command))
+        size += nodesSize(add->nodes) + vectorSize(add->edges);
+    else if (auto *remove = std::get_if<RemoveNodesCommand>(&command))
+        size += nodesSize(remove->nodes) + vectorSize(remove->edges);
+    else if (auto *connect = std::get_if<ConnectPinsCommand>(&command))
+        size += vectorSize(connect->edges);
+    else if (auto *disconnect = std::get_if<DisconnectPinsCommand>(&command))
+        size += vectorSize(disconnect->edges);
+    return size;
+}
+
+void CommandJournal::record(Command command)
+{
+    // the commands that could be redone are from another branch of history now
+    while (size() > _undoCount)
+    {
+        _memoryUsage -= _commands.back().size;
+        _commands.pop_back();
+    }
+
+    if (!_bIsSealed && tryCoalesce(command))
+        return;
+
+    if (auto *move = std::get_if<MoveNodesCommand>(&command))
+        move->moves.squeeze();
+
+    qsizetype commandSize = memorySize(command);
+    _commands.push_back({ std::move(command), commandSize });
+    _memoryUsage += commandSize;
+    _undoCount = size();
+
+    // only moves are coalesced, anything else ends a drag
+    _bIsSealed = !std::holds_alternative<MoveNodesCommand>(_commands.back().command);
+    evict();
+}
+
+bool CommandJournal::tryCoalesce(const Command &command)
+{
+    auto *move = std::get_if<MoveNodesCommand>(&command);
+    auto *last = _commands.empty() ? nullptr : std::get_if<MoveNodesCommand>(&_commands.back().command);
+    if (!move || !last || move->moves.size() != last->moves.size())
+        return false;
+
+    bool bIsSameNodes = std::ranges::equal(move->moves, last->moves, [](const NodeMove &first, const NodeMove &second) {
+        return first.nodeID == second.nodeID;
+    });
+    if (!bIsSameNodes)
+        return false;
+
+    // the merged move starts where the first one did and ends where the new one does
+    for (qsizetype i = 0; i < move->moves.size(); i++)
+        last->moves[i].to = move->moves[i].to;
+    return true;
+}
+
+void CommandJournal::evict()
+{
+    // the newest command is kept even if it alone exceeds the cap
+    while (_memoryUsage > _memoryCap && _commands.size() > 1)
+    {
+        _memoryUsage -= _commands.front().size;
+        _commands.pop_front();
+        _undoCount = std::max<qsizetype>(0, _undoCount - 1);
+    }
+}
+
+const Command *CommandJournal::undo()
+{
+    _bIsSealed = true;
+    if (!canUndo())
+        return nullptr;
+    return &_commands[--_undoCount].command;
+}
+
+const Command *CommandJournal::redo()
+{
+    _bIsSealed = true;
+    if (!canRedo())
+        return nullptr;
+    return &_commands[_undoCount++].command;
+}
+
+void CommandJournal::replaceUndone(Command command)
+{
+    if (!canRedo())
+        return;
+
+    // the cap is enforced on the next record, evicting here could drop the replaced command itself
+    Entry &entry = _commands[_undoCount];
+    _memoryUsage -= entry.size;
+    entry.size = memorySize(command);
+    entry.command = std::move(command);
+    _memoryUsage += entry.size;
+}
+
+void CommandJournal::setMemoryCap(qsizetype bytes)
+{
+    _memoryCap = bytes;
+    evict();
+}
+
+void CommandJournal::clear()
+{
+    _commands.clear();
+    _undoCount = 0;
+    _memoryUsage = 0;
+    _bIsSealed = true;
+}
+
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+#include <deque>
+#include <variant>
+
+#include "DataClasses/graphdata.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+struct GRAPHLIB_EXPORT NodeMove
+{
+    int nodeID;
+    QPointF from, to;
+};
+
+struct GRAPHLIB_EXPORT MoveNodesCommand
+{
+    QVector<NodeMove> moves;
+};
+
+struct GRAPHLIB_EXPORT AddNodesCommand
+{
+    QVector<NodeRecord> nodes;
+    // Connections between the added nodes, e.g. of a pasted subgraph
+    QVector<EdgeRecord> edges;
+};
+
+struct GRAPHLIB_EXPORT RemoveNodesCommand
+{
+    QVector<NodeRecord> nodes;
+    // Connections of the removed nodes, including the ones between them
+    QVector<EdgeRecord> edges;
+};
+
+struct GRAPHLIB_EXPORT ConnectPinsCommand
+{
+    QVector<EdgeRecord> edges;
+};
+
+struct GRAPHLIB_EXPORT DisconnectPinsCommand
+{
+    QVector<EdgeRecord> edges;
+};
+
+using Command = std::variant<MoveNodesCommand, AddNodesCommand, RemoveNodesCommand, ConnectPinsCommand, DisconnectPinsCommand>;
+
+// Undo history kept as a ring: when the recorded commands take more memory
+// than the cap, the oldest ones are dropped
+class GRAPHLIB_EXPORT CommandJournal
+{
+public:
+    explicit CommandJournal(qsizetype memoryCapBytes);
+
+    // Drops the commands that could be redone. A move of the same nodes as the
+    // last recorded move is merged into it until the journal is sealed
+    void record(Command command);
+    // Ends coalescing of moves, e.g. when a drag is finished
+    void seal() { _bIsSealed = true; }
+
+    // Returns the command to revert or to apply again, nullptr if there is none
+    const Command *undo();
+    const Command *redo();
+    // Replaces the command undone last, e.g. with records of nodes that have changed since
+    // the command was recorded, so redoing it recreates them as they were when undone
+    void replaceUndone(Command command);
+
+    bool canUndo() const { return _undoCount > 0; }
+    bool canRedo() const { return _undoCount < static_cast<qsizetype>(_commands.size()); }
+    qsizetype size() const { return static_cast<qsizetype>(_commands.size()); }
+    qsizetype memoryUsage() const { return _memoryUsage; }
+    qsizetype memoryCap() const { return _memoryCap; }
+
+    void setMemoryCap(qsizetype bytes);
+    void clear();
+
+    static qsizetype memorySize(const Command &command);
+
+private:
+    bool tryCoalesce(const Command &command);
+    void evict();
+
+    struct Entry
+    {
+        Command command;
+        qsizetype size;
+    };
+
+    std::deque<Entry> _commands;
+    // Commands before this index are applied, the rest can be redone
+    qsizetype _undoCount;
+    qsizetype _memoryUsage;
+    qsizetype _memoryCap;
+    bool _bIsSealed;
+};
+
+}
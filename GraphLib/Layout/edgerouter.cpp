@@ -0,0 +1,297 @@
+#include <QLineF>
+#include <QPainterPath>
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+#include "edgerouter.h"
+#include "utility.h"
+
+namespace GraphLib {
+
+namespace {
+
+enum Direction { Right, Left, Down, Up };
+
+bool crossesStandardCurve(QPointF origin, QPointF target, const QVector<QRectF> &obstacles)
+{
+    QPainterPath curve;
+    standardPath(curve, origin.toPoint(), target.toPoint());
+
+    for (int i = 0; i <= c_edgeRouteCurveSamples; i++)
+    {
+        QPointF point = curve.pointAtPercent(static_cast<qreal>(i) / c_edgeRouteCurveSamples);
+        if (std::ranges::any_of(obstacles, [&](const QRectF &rect) { return rect.contains(point); }))
+            return true;
+    }
+    return false;
+}
+
+}
+
+EdgeRouter::EdgeRouter(const SpatialIndex *nodes)
+    : _nodes{ nodes }
+    , _nextID{ 0 }
+    , _budget{ 0 }
+    , _bHasPendingRoutes{ false }
+{}
+
+const EdgeRoute *EdgeRouter::route(const PinData &outPin, const PinData &inPin, QPointF origin, QPointF target)
+{
+    EdgeKey key(outPin, inPin);
+    auto idIt = _ids.constFind(key);
+    if (idIt == _ids.cend())
+        idIt = _ids.insert(key, _nextID++);
+
+    const int id = idIt.value();
+    auto it = _routes.find(id);
+    if (it == _routes.end())
+        it = _routes.insert(id, { EdgeRoute(), origin, target, true, false });
+    Entry &entry = it.value();
+
+    // pin positions come from the widgets and jitter a bit with zoom
+    const bool bEndsMoved = QLineF(entry.origin, origin).length() > c_edgeRouteEndTolerance
+                         || QLineF(entry.target, target).length() > c_edgeRouteEndTolerance;
+    if (entry.bIsStale || bEndsMoved)
+    {
+        if (_budget > 0)
+        {
+            _budget--;
+            entry.origin = origin;
+            entry.target = target;
+            recompute(id, entry, outPin, inPin);
+        }
+        else
+        {
+            _bHasPendingRoutes = true;
+            // a route whose ends don't match the pins looks broken, the curve is drawn meanwhile
+            if (bEndsMoved || !entry.bIsRouted)
+                return nullptr;
+        }
+    }
+
+    QVector<QPointF> &points = entry.route.points;
+    if (points.isEmpty())
+        return nullptr;
+
+    // the segments next to the ends are horizontal, so they follow the pins
+    points[1].setY(origin.y());
+    points[points.size() - 2].setY(target.y());
+    points.first() = origin;
+    points.last() = target;
+    return &entry.route;
+}
+
+const EdgeRoute *EdgeRouter::cachedRoute(const PinData &outPin, const PinData &inPin) const
+{
+    auto idIt = _ids.constFind(EdgeKey(outPin, inPin));
+    if (idIt == _ids.cend())
+        return nullptr;
+
+    auto it = _routes.constFind(idIt.value());
+    return it != _routes.cend() && !it.value().route.points.isEmpty() ? &it.value().route : nullptr;
+}
+
+void EdgeRouter::invalidate(const QRectF &area)
+{
+    _corridors.query(area, _found);
+    std::ranges::for_each(_found, [&](int id) { _routes[id].bIsStale = true; });
+}
+
+void EdgeRouter::remove(const PinData &outPin, const PinData &inPin)
+{
+    auto idIt = _ids.find(EdgeKey(outPin, inPin));
+    if (idIt == _ids.end())
+        return;
+
+    _routes.remove(idIt.value());
+    _corridors.remove(idIt.value());
+    _ids.erase(idIt);
+}
+
+void EdgeRouter::clear()
+{
+    _ids.clear();
+    _routes.clear();
+    _corridors.clear();
+}
+
+void EdgeRouter::recompute(int id, Entry &entry, const PinData &outPin, const PinData &inPin)
+{
+    entry.bIsStale = false;
+    entry.bIsRouted = true;
+    entry.route.points.clear();
+
+    // the standard curve never leaves this area
+    const QRectF curveArea = QRectF(entry.origin, entry.target).normalized()
+                                 .adjusted(-c_maxDiffsSum, -c_maxDiffsSum, c_maxDiffsSum, c_maxDiffsSum);
+
+    _nodes->query(curveArea, _found);
+    _obstacles.clear();
+    std::ranges::for_each(_found, [&](int nodeID) {
+        if (nodeID != outPin.nodeID && nodeID != inPin.nodeID)
+            _obstacles.append(_nodes->rect(nodeID));
+    });
+
+    if (!_obstacles.isEmpty() && crossesStandardCurve(entry.origin, entry.target, _obstacles))
+    {
+        // the route goes around the end nodes as well
+        const QRectF searchArea = curveArea.adjusted(-c_edgeRouteSearchMargin, -c_edgeRouteSearchMargin,
+                                                     c_edgeRouteSearchMargin, c_edgeRouteSearchMargin);
+        _nodes->query(searchArea, _found);
+        if (_found.size() <= c_edgeRouteMaxObstacles)
+        {
+            _obstacles.clear();
+            std::ranges::for_each(_found, [&](int nodeID) { _obstacles.append(_nodes->rect(nodeID)); });
+            entry.route.points = compute(entry.origin, entry.target, _obstacles);
+        }
+    }
+
+    entry.route.corridor = curveArea;
+    if (!entry.route.points.isEmpty())
+    {
+        QRectF bounds(entry.route.points.first(), QSizeF(0, 0));
+        std::ranges::for_each(entry.route.points, [&](QPointF point) { bounds |= QRectF(point, QSizeF(1, 1)); });
+        entry.route.corridor |= bounds.adjusted(-c_edgeRouteMargin, -c_edgeRouteMargin, c_edgeRouteMargin, c_edgeRouteMargin);
+    }
+    _corridors.insert(id, entry.route.corridor);
+}
+
+QVector<QPointF> EdgeRouter::compute(QPointF origin, QPointF target, const QVector<QRectF> &obstacles)
+{
+    const QPointF start = origin + QPointF(c_edgeRouteStubLength, 0);
+    const QPointF end = target - QPointF(c_edgeRouteStubLength, 0);
+
+    QVector<QRectF> inflated;
+    inflated.reserve(obstacles.size());
+    std::ranges::for_each(obstacles, [&](const QRectF &rect) {
+        inflated.append(rect.adjusted(-c_edgeRouteMargin, -c_edgeRouteMargin, c_edgeRouteMargin, c_edgeRouteMargin));
+    });
+
+    auto isInside = [](const QRectF &rect, QPointF point) {
+        return point.x() > rect.left() && point.x() < rect.right() && point.y() > rect.top() && point.y() < rect.bottom();
+    };
+    if (std::ranges::any_of(inflated, [&](const QRectF &rect) { return isInside(rect, start) || isInside(rect, end); }))
+        return {};
+
+    // Sparse grid made of the obstacles' borders and the ends. Between two neighbouring
+    // lines there is no border, so a grid segment is either free or entirely blocked
+    QVector<double> xs{ start.x(), end.x(), (start.x() + end.x()) / 2 };
+    QVector<double> ys{ start.y(), end.y(), (start.y() + end.y()) / 2 };
+    std::ranges::for_each(inflated, [&](const QRectF &rect) {
+        xs << rect.left() << rect.right();
+        ys << rect.top() << rect.bottom();
+    });
+    std::ranges::sort(xs);
+    std::ranges::sort(ys);
+    xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    const int nx = xs.size(), ny = ys.size();
+    auto indexOf = [](const QVector<double> &lines, double value) {
+        return static_cast<int>(std::ranges::lower_bound(lines, value) - lines.begin());
+    };
+
+    // blockedRight[v] - the segment to the right of grid vertex v crosses an obstacle, same for blockedDown
+    QVector<bool> blockedRight(nx * ny, false), blockedDown(nx * ny, false);
+    std::ranges::for_each(inflated, [&](const QRectF &rect) {
+        int x0 = indexOf(xs, rect.left()), x1 = indexOf(xs, rect.right());
+        int y0 = indexOf(ys, rect.top()), y1 = indexOf(ys, rect.bottom());
+        for (int y = y0 + 1; y < y1; y++)
+            for (int x = x0; x < x1; x++)
+                blockedRight[y * nx + x] = true;
+        for (int y = y0; y < y1; y++)
+            for (int x = x0 + 1; x < x1; x++)
+                blockedDown[y * nx + x] = true;
+    });
+
+    // A* over (vertex, direction of arrival) penalizing bends
+    const int startVertex = indexOf(ys, start.y()) * nx + indexOf(xs, start.x());
+    const int endVertex = indexOf(ys, end.y()) * nx + indexOf(xs, end.x());
+    auto heuristic = [&](int vertex) {
+        return std::abs(xs[vertex % nx] - end.x()) + std::abs(ys[vertex / nx] - end.y());
+    };
+
+    QVector<double> cost(nx * ny * 4, std::numeric_limits<double>::infinity());
+    QVector<int> previous(nx * ny * 4, -1);
+    using QueueItem = std::pair<double, int>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+    cost[startVertex * 4 + Right] = 0;
+    queue.push({ heuristic(startVertex), startVertex * 4 + Right });
+
+    int best = -1;
+    double bestCost = std::numeric_limits<double>::infinity();
+
+    while (!queue.empty())
+    {
+        auto [estimate, state] = queue.top();
+        queue.pop();
+        if (estimate >= bestCost)
+            break;
+
+        const int vertex = state / 4;
+        const int direction = state % 4;
+        if (estimate - heuristic(vertex) > cost[state] + 1e-6)
+            continue;
+
+        if (vertex == endVertex)
+        {
+            // the route enters the in-pin from the left
+            double total = cost[state] + (direction == Right ? 0 : c_edgeRouteBendPenalty);
+            if (total < bestCost)
+            {
+                bestCost = total;
+                best = state;
+            }
+            continue;
+        }
+
+        const int x = vertex % nx, y = vertex / nx;
+        auto relax = [&](int next, int nextDirection, double length) {
+            if (nextDirection != direction && nextDirection == (direction ^ 1))
+                return;
+            double nextCost = cost[state] + length + (nextDirection == direction ? 0 : c_edgeRouteBendPenalty);
+            int nextState = next * 4 + nextDirection;
+            if (nextCost < cost[nextState])
+            {
+                cost[nextState] = nextCost;
+                previous[nextState] = state;
+                queue.push({ nextCost + heuristic(next), nextState });
+            }
+        };
+
+        if (x + 1 < nx && !blockedRight[vertex])
+            relax(vertex + 1, Right, xs[x + 1] - xs[x]);
+        if (x > 0 && !blockedRight[vertex - 1])
+            relax(vertex - 1, Left, xs[x] - xs[x - 1]);
+        if (y + 1 < ny && !blockedDown[vertex])
+            relax(vertex + nx, Down, ys[y + 1] - ys[y]);
+        if (y > 0 && !blockedDown[vertex - nx])
+            relax(vertex - nx, Up, ys[y] - ys[y - 1]);
+    }
+
+    if (best < 0)
+        return {};
+
+    QVector<QPointF> points{ target };
+    for (int state = best; state >= 0; state = previous[state])
+        points.append(QPointF(xs[state / 4 % nx], ys[state / 4 / nx]));
+    points.append(origin);
+    std::ranges::reverse(points);
+
+    // only the bends are kept
+    QVector<QPointF> route{ points.first() };
+    for (int i = 1; i + 1 < points.size(); i++)
+    {
+        QPointF before = route.last(), after = points[i + 1];
+        bool bIsStraight = (before.x() == points[i].x() && points[i].x() == after.x())
+                        || (before.y() == points[i].y() && points[i].y() == after.y());
+        if (!bIsStraight)
+            route.append(points[i]);
+    }
+    route.append(points.last());
+    return route;
+}
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+
+#include "DataClasses/pindata.h"
+#include "Spatial/spatialindex.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Orthogonal path of an edge in canvas coordinates, from the out-pin to the in-pin.
+// An empty path means the standard curve doesn't cross any node and is used as is
+struct EdgeRoute
+{
+    QVector<QPointF> points;
+    // Area whose changes may affect the route
+    QRectF corridor;
+};
+
+// Routes edges around the nodes of a SpatialIndex keyed by node ID. Routes are cached
+// and recomputed only when their ends move or a node inside their corridor changes.
+// At most a budget of routes is recomputed per frame, the rest catches up in later frames
+class GRAPHLIB_EXPORT EdgeRouter
+{
+public:
+    using EdgeKey = QPair<PinData, PinData>;
+
+    explicit EdgeRouter(const SpatialIndex *nodes);
+
+    // Starts a frame allowing the given number of routes to be recomputed
+    void beginFrame(int budget) { _budget = budget; _bHasPendingRoutes = false; }
+    // True if some route was left stale during the frame because of the budget
+    bool hasPendingRoutes() const { return _bHasPendingRoutes; }
+
+    // Route of the edge between the pins' canvas positions. The first and the last points
+    // always match the given ones. Returns nullptr for the standard curve
+    const EdgeRoute *route(const PinData &outPin, const PinData &inPin, QPointF origin, QPointF target);
+    // Cached route without recomputing it, may be stale
+    const EdgeRoute *cachedRoute(const PinData &outPin, const PinData &inPin) const;
+
+    // Marks the routes whose corridor touches the area as stale
+    void invalidate(const QRectF &area);
+    void remove(const PinData &outPin, const PinData &inPin);
+    void clear();
+
+    qsizetype size() const { return _routes.size(); }
+
+    // Orthogonal route from origin (leaving to the right) to target (entering from the left)
+    // avoiding the obstacles. Returns an empty vector if there is no such route
+    static QVector<QPointF> compute(QPointF origin, QPointF target, const QVector<QRectF> &obstacles);
+
+private:
+    struct Entry
+    {
+        EdgeRoute route;
+        QPointF origin, target;
+        bool bIsStale;
+        bool bIsRouted;
+    };
+
+    void recompute(int id, Entry &entry, const PinData &outPin, const PinData &inPin);
+
+    const SpatialIndex *_nodes;
+    QMap<EdgeKey, int> _ids;
+    QHash<int, Entry> _routes;
+    // Corridors of the routes, to find the ones affected by a change in O(1) per cell
+    SpatialIndex _corridors;
+    int _nextID;
+    int _budget;
+    bool _bHasPendingRoutes;
+
+    // Reused between recomputations
+    QVector<int> _found;
+    QVector<QRectF> _obstacles;
+};
+
+}
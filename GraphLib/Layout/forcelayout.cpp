@@ -0,0 +1,285 @@
+#include <QtConcurrent>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "forcelayout.h"
+
+namespace GraphLib {
+
+namespace {
+
+const int c_quadTreeMaxDepth = 24;
+const int c_nodesPerTask = 512;
+
+class QuadTree
+{
+public:
+    void build(const QVector<QPointF> &points);
+
+    // Sum of repulsive forces acting on the body, k2 is the squared ideal edge length
+    QPointF repulsion(int body, double k2, double theta) const;
+
+private:
+    struct Cell
+    {
+        QPointF center;
+        double halfSize;
+        int firstChild;
+        // First body of a leaf, the rest are linked through _nextBody
+        int body;
+        double mass;
+        QPointF massCenter;
+    };
+
+    int quadrant(const Cell &cell, QPointF point) const
+    {
+        return (point.x() >= cell.center.x() ? 1 : 0) | (point.y() >= cell.center.y() ? 2 : 0);
+    }
+
+    void subdivide(int cell);
+
+    const QVector<QPointF> *_points = nullptr;
+    QVector<Cell> _cells;
+    QVector<int> _nextBody;
+};
+
+void QuadTree::build(const QVector<QPointF> &points)
+{
+    _points = &points;
+    _cells.clear();
+    _nextBody.fill(-1, points.size());
+
+    QRectF bounds(points.first(), QSizeF(0, 0));
+    std::ranges::for_each(points, [&](QPointF point) { bounds |= QRectF(point, QSizeF(1, 1)); });
+    _cells.append({ bounds.center(), std::max(bounds.width(), bounds.height()) / 2 + 1, -1, -1, 0, QPointF() });
+
+    for (int body = 0; body < points.size(); body++)
+    {
+        const QPointF point = points[body];
+        int cell = 0;
+        for (int depth = 0; ; depth++)
+        {
+            if (_cells[cell].firstChild >= 0)
+            {
+                cell = _cells[cell].firstChild + quadrant(_cells[cell], point);
+                continue;
+            }
+
+            if (_cells[cell].body < 0)
+            {
+                _cells[cell].body = body;
+                break;
+            }
+
+            // bodies that can't be told apart share a leaf
+            if (depth >= c_quadTreeMaxDepth)
+            {
+                _nextBody[body] = _cells[cell].body;
+                _cells[cell].body = body;
+                break;
+            }
+
+            int existing = _cells[cell].body;
+            _cells[cell].body = -1;
+            subdivide(cell);
+            _cells[_cells[cell].firstChild + quadrant(_cells[cell], points[existing])].body = existing;
+        }
+    }
+
+    // children are always created after their parent, so a reverse pass goes bottom-up
+    for (qsizetype i = _cells.size() - 1; i >= 0; i--)
+    {
+        Cell &cell = _cells[i];
+        QPointF weighted;
+        if (cell.firstChild >= 0)
+        {
+            for (int child = cell.firstChild; child < cell.firstChild + 4; child++)
+            {
+                cell.mass += _cells[child].mass;
+                weighted += _cells[child].massCenter * _cells[child].mass;
+            }
+        }
+        else
+        {
+            for (int body = cell.body; body >= 0; body = _nextBody[body])
+            {
+                cell.mass += 1;
+                weighted += points[body];
+            }
+        }
+        if (cell.mass > 0)
+            cell.massCenter = weighted / cell.mass;
+    }
+}
+
+void QuadTree::subdivide(int cell)
+{
+    const QPointF center = _cells[cell].center;
+    const double half = _cells[cell].halfSize / 2;
+    _cells[cell].firstChild = _cells.size();
+
+    for (int quadrant = 0; quadrant < 4; quadrant++)
+    {
+        QPointF offset(quadrant & 1 ? half : -half, quadrant & 2 ? half : -half);
+        _cells.append({ center + offset, half, -1, -1, 0, QPointF() });
+    }
+}
+
+QPointF QuadTree::repulsion(int body, double k2, double theta) const
+{
+    const QPointF point = (*_points)[body];
+    QPointF force;
+
+    auto push = [&](QPointF delta, double mass) {
+        double distance2 = QPointF::dotProduct(delta, delta);
+        // bodies at the same spot are pushed apart in a direction that depends only on the body
+        if (distance2 < 1e-6)
+        {
+            delta = QPointF(std::cos(body), std::sin(body));
+            distance2 = 1;
+        }
+        force += delta * (mass * k2 / distance2);
+    };
+
+    QVarLengthArray<int, 128> stack;
+    stack.append(0);
+    while (!stack.isEmpty())
+    {
+        const Cell &cell = _cells[stack.takeLast()];
+        if (cell.mass == 0)
+            continue;
+
+        if (cell.firstChild < 0)
+        {
+            for (int other = cell.body; other >= 0; other = _nextBody[other])
+                if (other != body)
+                    push(point - (*_points)[other], 1);
+            continue;
+        }
+
+        QPointF delta = point - cell.massCenter;
+        double size = cell.halfSize * 2;
+        if (size * size < theta * theta * QPointF::dotProduct(delta, delta))
+            push(delta, cell.mass);
+        else
+            for (int child = cell.firstChild; child < cell.firstChild + 4; child++)
+                stack.append(child);
+    }
+
+    return force;
+}
+
+}
+
+LayoutPositions ForceLayout::compute(const LayoutGraph &graph, const ForceLayoutOptions &options,
+                                     const QVector<int> &settledNodes, QPromise<LayoutPositions> *promise)
+{
+    const int nodeCount = graph.nodes.size();
+    if (nodeCount == 0)
+        return {};
+
+    QVector<QPointF> positions(nodeCount);
+    for (int i = 0; i < nodeCount; i++)
+        positions[i] = graph.nodes[i].position + QPointF(graph.nodes[i].size.width(), graph.nodes[i].size.height()) / 2;
+
+    // without nodes to settle everything moves, otherwise only the neighbourhood of them
+    QVector<bool> bIsMovable(nodeCount, settledNodes.isEmpty());
+    const double settleRadius2 = options.settleRadius * options.settleRadius;
+    std::ranges::for_each(settledNodes, [&](int settled) {
+        for (int i = 0; i < nodeCount; i++)
+        {
+            QPointF delta = positions[i] - positions[settled];
+            if (QPointF::dotProduct(delta, delta) <= settleRadius2)
+                bIsMovable[i] = true;
+        }
+    });
+
+    // undirected adjacency for the attraction
+    QVector<int> neighboursStart(nodeCount + 1, 0);
+    std::ranges::for_each(graph.edges, [&](const LayoutGraph::Edge &edge) {
+        neighboursStart[edge.outNode + 1]++;
+        neighboursStart[edge.inNode + 1]++;
+    });
+    std::partial_sum(neighboursStart.begin(), neighboursStart.end(), neighboursStart.begin());
+    QVector<int> neighbours(neighboursStart.last());
+    {
+        QVector<int> filled(neighboursStart.begin(), neighboursStart.end() - 1);
+        std::ranges::for_each(graph.edges, [&](const LayoutGraph::Edge &edge) {
+            neighbours[filled[edge.outNode]++] = edge.inNode;
+            neighbours[filled[edge.inNode]++] = edge.outNode;
+        });
+    }
+
+    QVector<QPair<int, int>> tasks;
+    for (int begin = 0; begin < nodeCount; begin += c_nodesPerTask)
+        tasks.append({ begin, std::min(nodeCount, begin + c_nodesPerTask) });
+
+    const double k = options.idealEdgeLength;
+    const double initialTemperature = k * 2;
+    QVector<QPointF> next(positions);
+    QuadTree tree;
+
+    for (int iteration = 0; iteration < options.iterations; iteration++)
+    {
+        if (promise)
+        {
+            if (promise->isCanceled())
+                return {};
+            promise->setProgressValue(100 * iteration / options.iterations);
+        }
+
+        // the system cools down linearly, limiting how far a node can go in one step
+        const double temperature = initialTemperature * (1.0 - static_cast<double>(iteration) / options.iterations);
+        tree.build(positions);
+
+        QtConcurrent::blockingMap(tasks, [&](const QPair<int, int> &task) {
+            for (int i = task.first; i < task.second; i++)
+            {
+                if (!bIsMovable[i])
+                    continue;
+
+                QPointF force = tree.repulsion(i, k * k, options.theta);
+                for (int n = neighboursStart[i]; n < neighboursStart[i + 1]; n++)
+                {
+                    QPointF delta = positions[neighbours[n]] - positions[i];
+                    force += delta * (std::sqrt(QPointF::dotProduct(delta, delta)) / k);
+                }
+
+                double length = std::sqrt(QPointF::dotProduct(force, force));
+                next[i] = positions[i] + (length > temperature ? force * (temperature / length) : force);
+            }
+        });
+
+        std::swap(positions, next);
+        // pinned nodes are never written, so both buffers keep their positions
+    }
+
+    LayoutPositions result;
+    result.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; i++)
+    {
+        if (bIsMovable[i])
+        {
+            const QSizeF &size = graph.nodes[i].size;
+            result.append({ graph.nodes[i].nodeID, positions[i] - QPointF(size.width(), size.height()) / 2 });
+        }
+    }
+
+    if (promise)
+        promise->setProgressValue(100);
+    return result;
+}
+
+QFuture<LayoutPositions> ForceLayout::run(LayoutGraph graph, ForceLayoutOptions options, QVector<int> settledNodes)
+{
+    return QtConcurrent::run([](QPromise<LayoutPositions> &promise, LayoutGraph graph, ForceLayoutOptions options, QVector<int> settledNodes) {
+        promise.setProgressRange(0, 100);
+        LayoutPositions positions = compute(graph, options, settledNodes, &promise);
+        if (!promise.isCanceled())
+            promise.addResult(std::move(positions));
+    }, std::move(graph), std::move(options), std::move(settledNodes));
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QFuture>
+#include <QPromise>
+#include <QVector>
+
+#include "layoutgraph.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+struct GRAPHLIB_EXPORT ForceLayoutOptions
+{
+    int iterations = 200;
+    // Distance connected nodes settle at
+    double idealEdgeLength = 300;
+    // Barnes–Hut accuracy: a quadtree cell is approximated by its center of mass
+    // when its size divided by the distance to it is below theta
+    double theta = 0.8;
+    // When nodes to settle are given, only the nodes within this distance of them move
+    double settleRadius = 800;
+    bool bAnimate = true;
+};
+
+// Fruchterman–Reingold layout with repulsion approximated through a quadtree,
+// so an iteration costs O(N log N). Forces are computed on the global thread pool
+class GRAPHLIB_EXPORT ForceLayout
+{
+public:
+    // `settledNodes` are indices in graph.nodes. If it's empty, every node moves.
+    // Returns an empty result if the promise gets canceled
+    static LayoutPositions compute(const LayoutGraph &graph, const ForceLayoutOptions &options,
+                                   const QVector<int> &settledNodes = {}, QPromise<LayoutPositions> *promise = nullptr);
+
+    static QFuture<LayoutPositions> run(LayoutGraph graph, ForceLayoutOptions options, QVector<int> settledNodes = {});
+};
+
+}
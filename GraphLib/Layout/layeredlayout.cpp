@@ -0,0 +1,324 @@
+#include <QtConcurrent>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+#include "layeredlayout.h"
+
+namespace GraphLib {
+
+namespace {
+
+// Link between vertices of adjacent layers. Ports are positions of the link's
+// ends along their vertex, from 0 (top) to 1 (bottom)
+struct Link
+{
+    int upper, lower;
+    float upperPort, lowerPort;
+};
+
+// Adjacency of one direction stored as contiguous ranges per vertex
+struct Adjacency
+{
+    QVector<int> start;
+    QVector<int> vertices;
+    QVector<float> ports;
+
+    Adjacency(const QVector<Link> &links, int vertexCount, bool bIsDownwards)
+        : start(vertexCount + 1, 0), vertices(links.size()), ports(links.size())
+    {
+        std::ranges::for_each(links, [&](const Link &link) { start[(bIsDownwards ? link.upper : link.lower) + 1]++; });
+        std::partial_sum(start.begin(), start.end(), start.begin());
+
+        QVector<int> filled(start.begin(), start.end() - 1);
+        std::ranges::for_each(links, [&](const Link &link) {
+            int from = bIsDownwards ? link.upper : link.lower;
+            int index = filled[from]++;
+            vertices[index] = bIsDownwards ? link.lower : link.upper;
+            ports[index] = bIsDownwards ? link.lowerPort : link.upperPort;
+        });
+    }
+};
+
+float pinPort(const LayoutGraph::Node &node, int pin)
+{
+    return node.pinCount > 0 ? (pin + 0.5f) / node.pinCount : 0.5f;
+}
+
+}
+
+LayoutPositions LayeredLayout::compute(const LayoutGraph &graph, const LayeredLayoutOptions &options,
+                                       QPromise<LayoutPositions> *promise)
+{
+    const int nodeCount = graph.nodes.size();
+    if (nodeCount == 0)
+        return {};
+
+    auto progress = [&](int value) {
+        if (promise)
+            promise->setProgressValue(value);
+        return !promise || !promise->isCanceled();
+    };
+
+
+    // CYCLE REMOVAL: edges closing a cycle in depth-first order are reversed
+
+    QVector<int> outStart(nodeCount + 1, 0);
+    std::ranges::for_each(graph.edges, [&](const LayoutGraph::Edge &edge) { outStart[edge.outNode + 1]++; });
+    std::partial_sum(outStart.begin(), outStart.end(), outStart.begin());
+    QVector<int> outEdges(graph.edges.size());
+    {
+        QVector<int> filled(outStart.begin(), outStart.end() - 1);
+        for (int i = 0; i < graph.edges.size(); i++)
+            outEdges[filled[graph.edges[i].outNode]++] = i;
+    }
+
+    enum class Visit : char { New, Active, Done };
+    QVector<Visit> visits(nodeCount, Visit::New);
+    QVector<bool> reversed(graph.edges.size(), false);
+    QVector<QPair<int, int>> stack; // (node, next edge to look at)
+
+    for (int root = 0; root < nodeCount; root++)
+    {
+        if (visits[root] != Visit::New)
+            continue;
+
+        stack.append({ root, outStart[root] });
+        visits[root] = Visit::Active;
+        while (!stack.isEmpty())
+        {
+            auto &[node, next] = stack.last();
+            if (next == outStart[node + 1])
+            {
+                visits[node] = Visit::Done;
+                stack.removeLast();
+                continue;
+            }
+
+            int edge = outEdges[next++];
+            int target = graph.edges[edge].inNode;
+            if (visits[target] == Visit::Active)
+                reversed[edge] = true;
+            else if (visits[target] == Visit::New)
+            {
+                visits[target] = Visit::Active;
+                stack.append({ target, outStart[target] });
+            }
+        }
+    }
+
+    if (!progress(5)) return {};
+
+
+    // LAYERING: longest path from the sources
+
+    auto effectiveEnds = [&](int edge) {
+        const LayoutGraph::Edge &e = graph.edges[edge];
+        return reversed[edge] ? QPair<int, int>(e.inNode, e.outNode) : QPair<int, int>(e.outNode, e.inNode);
+    };
+
+    QVector<int> inDegree(nodeCount, 0);
+    QVector<int> effectiveStart(nodeCount + 1, 0);
+    for (int i = 0; i < graph.edges.size(); i++)
+    {
+        auto [from, to] = effectiveEnds(i);
+        if (from == to) continue;
+        inDegree[to]++;
+        effectiveStart[from + 1]++;
+    }
+    std::partial_sum(effectiveStart.begin(), effectiveStart.end(), effectiveStart.begin());
+    QVector<int> effectiveTargets(effectiveStart.last());
+    {
+        QVector<int> filled(effectiveStart.begin(), effectiveStart.end() - 1);
+        for (int i = 0; i < graph.edges.size(); i++)
+        {
+            auto [from, to] = effectiveEnds(i);
+            if (from != to)
+                effectiveTargets[filled[from]++] = to;
+        }
+    }
+
+    QVector<int> layer(nodeCount, 0);
+    QVector<int> queue;
+    queue.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; i++)
+        if (inDegree[i] == 0) queue.append(i);
+
+    for (int head = 0; head < queue.size(); head++)
+    {
+        int node = queue[head];
+        for (int i = effectiveStart[node]; i < effectiveStart[node + 1]; i++)
+        {
+            int target = effectiveTargets[i];
+            layer[target] = std::max(layer[target], layer[node] + 1);
+            if (--inDegree[target] == 0)
+                queue.append(target);
+        }
+    }
+
+    const int layerCount = *std::ranges::max_element(layer) + 1;
+    if (!progress(10)) return {};
+
+
+    // DUMMY VERTICES: edges spanning several layers are split into chains
+
+    QVector<int> vertexLayer(layer);
+    // real nodes keep their order by position at first, chains follow their upper end
+    QVector<double> initialKey(nodeCount);
+    for (int i = 0; i < nodeCount; i++)
+        initialKey[i] = graph.nodes[i].position.y();
+
+    QVector<Link> links;
+    links.reserve(graph.edges.size());
+    for (int i = 0; i < graph.edges.size(); i++)
+    {
+        const LayoutGraph::Edge &edge = graph.edges[i];
+        auto [upper, lower] = effectiveEnds(i);
+        if (upper == lower) continue;
+
+        float upperPort = reversed[i] ? pinPort(graph.nodes[upper], edge.inPin) : pinPort(graph.nodes[upper], edge.outPin);
+        float lowerPort = reversed[i] ? pinPort(graph.nodes[lower], edge.outPin) : pinPort(graph.nodes[lower], edge.inPin);
+
+        int previous = upper;
+        float previousPort = upperPort;
+        for (int l = layer[upper] + 1; l < layer[lower]; l++)
+        {
+            int dummy = vertexLayer.size();
+            vertexLayer.append(l);
+            initialKey.append(initialKey[upper]);
+            links.append({ previous, dummy, previousPort, 0.5f });
+            previous = dummy;
+            previousPort = 0.5f;
+        }
+        links.append({ previous, lower, previousPort, lowerPort });
+    }
+
+    const int vertexCount = vertexLayer.size();
+    Adjacency down(links, vertexCount, true);
+    Adjacency up(links, vertexCount, false);
+
+    QVector<QVector<int>> layers(layerCount);
+    for (int v = 0; v < vertexCount; v++)
+        layers[vertexLayer[v]].append(v);
+
+    QVector<int> order(vertexCount);
+    for (QVector<int> &vertices : layers)
+    {
+        std::ranges::stable_sort(vertices, [&](int a, int b) { return initialKey[a] < initialKey[b]; });
+        for (int i = 0; i < vertices.size(); i++)
+            order[vertices[i]] = i;
+    }
+
+    if (!progress(20)) return {};
+
+
+    // CROSSING MINIMIZATION: barycenters of neighbours' pins in the adjacent layer
+
+    QVector<double> barycenter(vertexCount);
+    auto sortLayer = [&](QVector<int> &vertices, const Adjacency &neighbours) {
+        std::ranges::for_each(vertices, [&](int v) {
+            int count = neighbours.start[v + 1] - neighbours.start[v];
+            if (count == 0)
+            {
+                barycenter[v] = order[v];
+                return;
+            }
+            double sum = 0;
+            for (int i = neighbours.start[v]; i < neighbours.start[v + 1]; i++)
+                sum += order[neighbours.vertices[i]] + neighbours.ports[i];
+            barycenter[v] = sum / count - 0.5;
+        });
+
+        std::ranges::stable_sort(vertices, [&](int a, int b) { return barycenter[a] < barycenter[b]; });
+        for (int i = 0; i < vertices.size(); i++)
+            order[vertices[i]] = i;
+    };
+
+    for (int sweep = 0; sweep < options.sweeps; sweep++)
+    {
+        for (int l = 1; l < layerCount; l++)
+            sortLayer(layers[l], up);
+        for (int l = layerCount - 2; l >= 0; l--)
+            sortLayer(layers[l], down);
+
+        if (!progress(20 + 60 * (sweep + 1) / std::max(1, options.sweeps))) return {};
+    }
+
+
+    // COORDINATES: layers go left to right, nodes are pulled towards their neighbours
+
+    auto height = [&](int v) { return v < nodeCount ? graph.nodes[v].size.height() : 0.0; };
+    auto gap = [&](int a, int b) { return a < nodeCount || b < nodeCount ? options.nodeSpacing : options.nodeSpacing / 4.0; };
+
+    QVector<double> layerX(layerCount, 0);
+    for (int l = 0; l + 1 < layerCount; l++)
+    {
+        double width = 0;
+        std::ranges::for_each(layers[l], [&](int v) { if (v < nodeCount) width = std::max(width, graph.nodes[v].size.width()); });
+        layerX[l + 1] = layerX[l] + width + options.layerSpacing;
+    }
+
+    QVector<double> top(vertexCount, 0);
+    for (const QVector<int> &vertices : layers)
+    {
+        for (int i = 1; i < vertices.size(); i++)
+            top[vertices[i]] = top[vertices[i - 1]] + height(vertices[i - 1]) + gap(vertices[i - 1], vertices[i]);
+    }
+
+    auto placeLayer = [&](const QVector<int> &vertices, const Adjacency &neighbours) {
+        double bottom = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < vertices.size(); i++)
+        {
+            int v = vertices[i];
+            int count = neighbours.start[v + 1] - neighbours.start[v];
+            double desired = top[v];
+            if (count > 0)
+            {
+                double sum = 0;
+                for (int n = neighbours.start[v]; n < neighbours.start[v + 1]; n++)
+                    sum += top[neighbours.vertices[n]] + height(neighbours.vertices[n]) * neighbours.ports[n];
+                desired = sum / count - height(v) / 2;
+            }
+            top[v] = i > 0 ? std::max(desired, bottom + gap(vertices[i - 1], v)) : desired;
+            bottom = top[v] + height(v);
+        }
+    };
+
+    for (int l = 1; l < layerCount; l++)
+        placeLayer(layers[l], up);
+    for (int l = layerCount - 2; l >= 0; l--)
+        placeLayer(layers[l], down);
+
+    if (!progress(90)) return {};
+
+
+    // the laid out graph keeps the top-left corner of the original one
+    QPointF origin = graph.nodes.first().position;
+    std::ranges::for_each(graph.nodes, [&](const LayoutGraph::Node &node) {
+        origin.setX(std::min(origin.x(), node.position.x()));
+        origin.setY(std::min(origin.y(), node.position.y()));
+    });
+    double minTop = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < nodeCount; i++)
+        minTop = std::min(minTop, top[i]);
+
+    LayoutPositions positions;
+    positions.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; i++)
+        positions.append({ graph.nodes[i].nodeID, origin + QPointF(layerX[layer[i]], top[i] - minTop) });
+
+    progress(100);
+    return positions;
+}
+
+QFuture<LayoutPositions> LayeredLayout::run(LayoutGraph graph, LayeredLayoutOptions options)
+{
+    return QtConcurrent::run([](QPromise<LayoutPositions> &promise, LayoutGraph graph, LayeredLayoutOptions options) {
+        promise.setProgressRange(0, 100);
+        LayoutPositions positions = compute(graph, options, &promise);
+        if (!promise.isCanceled())
+            promise.addResult(std::move(positions));
+    }, std::move(graph), std::move(options));
+}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QFuture>
+#include <QPromise>
+
+#include "layoutgraph.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+struct GRAPHLIB_EXPORT LayeredLayoutOptions
+{
+    // Gaps between layers and between nodes of a layer
+    int layerSpacing = 120;
+    int nodeSpacing = 40;
+    // Passes of crossing minimization, each goes down and then up the layers
+    int sweeps = 4;
+    bool bAnimate = true;
+};
+
+// Sugiyama-style layout: edges point from left to right through layers, nodes of
+// a layer are ordered by the barycenters of their neighbours' pins to reduce crossings
+class GRAPHLIB_EXPORT LayeredLayout
+{
+public:
+    // Returns an empty result if the promise gets canceled
+    static LayoutPositions compute(const LayoutGraph &graph, const LayeredLayoutOptions &options,
+                                   QPromise<LayoutPositions> *promise = nullptr);
+
+    // Runs compute() on the global thread pool, reporting progress from 0 to 100
+    static QFuture<LayoutPositions> run(LayoutGraph graph, LayeredLayoutOptions options);
+};
+
+}
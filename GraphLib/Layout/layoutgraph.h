@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QPair>
+#include <QPointF>
+#include <QSizeF>
+#include <QVector>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Copy of the graph's structure that layout algorithms work on off the GUI thread
+struct GRAPHLIB_EXPORT LayoutGraph
+{
+    struct Node
+    {
+        int nodeID;
+        QPointF position;
+        QSizeF size;
+        int pinCount;
+    };
+
+    // Nodes are indices in `nodes`, pins are indices of the pins in their node
+    struct Edge
+    {
+        int outNode, outPin;
+        int inNode, inPin;
+    };
+
+    QVector<Node> nodes;
+    QVector<Edge> edges;
+};
+
+// New canvas positions as (node ID, position)
+using LayoutPositions = QVector<QPair<int, QPointF>>;
+
+}
@@ -20,11 +20,12 @@ TypedNode *NodeFactory::getNodeOfType(int typeID, Canvas *canvas)
 {
     TypedNode *node = new TypedNode(typeID, canvas);
 
-    node->setName(_nodeTypeManager->Types()[typeID].value("name").toString());
+    node->setName(_nodeTypeManager->typeNameByID(typeID));
     node->setNodeTypeManager(_nodeTypeManager);
     node->setPinTypeManager(_pinTypeManager);
 
-    const QJsonObject &type = _nodeTypeManager->Types()[typeID];
+    // only the types that are spawned get parsed
+    const QJsonObject type = _nodeTypeManager->type(typeID);
     QJsonValue inPins = type.value("in-pins");
     QJsonValue outPins = type.value("out-pins");
 
@@ -37,9 +38,16 @@ TypedNode *NodeFactory::getNodeOfType(int typeID, Canvas *canvas)
     return node;
 }
 
+QColor NodeFactory::pinColor(const QString &typeName) const
+{
+    const int id = _pinTypeManager->TypeNames().value(typeName, -1);
+    if (id < 0)
+        return QColor(Qt::GlobalColor::black);
+    return parseToColor(_pinTypeManager->type(id).value("color").toString());
+}
+
 void NodeFactory::addPinsToNodeByJsonValue(const QJsonValue &val, TypedNode *node, PinDirection direction)
 {
-    const QVector<QJsonObject> &pinTypes = _pinTypeManager->Types();
     QJsonArray pins = val.toArray();
 
     for (auto it = pins.begin(); it < pins.end(); it++)
@@ -47,13 +55,11 @@ void NodeFactory::addPinsToNodeByJsonValue(const QJsonValue &val, TypedNode *nod
         QJsonObject pinObject = (*it).toObject();
 
         QString typeName = pinObject.value("type").toString();
-        int id = _pinTypeManager->TypeNames()[typeName];
-        const QJsonObject &type = pinTypes[id];
-        QString colorString = type.value("color").toString();
-        QColor color = parseToColor(colorString);
 
+        // pins of unknown types keep the default color, the pin catalog may not be loaded yet.
+        // They're still added, connections refer to the pins by their index
         Pin *pin = new Pin(node);
-        pin->setColor(color);
+        pin->setColor(pinColor(typeName));
         pin->setText(typeName);
         pin->setDirection(direction);
 
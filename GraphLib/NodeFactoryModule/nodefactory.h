@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QJsonValue>
+#include <QColor>
 
 #include "TypeManagers/nodetypemanager.h"
 #include "TypeManagers/pintypemanager.h"
@@ -27,6 +28,9 @@ public:
     void setNodeTypeManager(const NodeTypeManager *manager) { _nodeTypeManager = manager; }
     void setPinTypeManager(const PinTypeManager *manager) { _pinTypeManager = manager; }
 
+    // The default pin color while the type is unknown
+    QColor pinColor(const QString &typeName) const;
+
 private:
     void addPinsToNodeByJsonValue(const QJsonValue &val, TypedNode *node, PinDirection direction);
 
@@ -1,7 +1,8 @@
 #include <QPaintEvent>
 #include <QRect>
-#include <QGroupBox>
 #include <QApplication>
+#include <QFontMetrics>
+#include <QSignalBlocker>
 
 #include "constants.h"
 #include "TypeManagers/nodetypemanager.h"
@@ -14,37 +15,67 @@ namespace NodeFactoryModule {
 
 NodeFactoryWidget::NodeFactoryWidget(QWidget *parent)
     : QWidget{ parent }
+    , _nodeTypeManager{ nullptr }
+    , _pinTypeManager{ nullptr }
     , _painter{ new QPainter() }
     , _gap{ 20 }
     , _bIsMinimized{ false }
     , _position{ QPointF() }
     , _lastMouseDownPosition{ QPointF() }
     , _mousePressPosition{ QPointF() }
-    , _layoutHolder{ QWidget(this) }
-    , _layout{ QBoxLayout(QBoxLayout::TopToBottom, &_layoutHolder) }
+    , _filter{ QLineEdit(this) }
+    , _category{ QComboBox(this) }
+    , _rows{ QWidget(this) }
     , _btnMinimize{ NFButtonMinimize(this) }
-    , _nodeImages{ QVector<QSharedPointer<TypedNodeImage>>() }
+    , _model{ PaletteModel() }
+    , _pool{ QVector<TypedNodeImage*>() }
+    , _scroll{ 0 }
+    , _maxTextWidth{ 0 }
+    , _desiredSize{ std::nullopt }
 {
     setMouseTracking(true);
-    _layoutHolder.setLayout(&_layout);
+
+    _filter.setPlaceholderText("filter");
+    _filter.setClearButtonEnabled(true);
+    _category.hide();
 
     _btnMinimize.text = c_nfWidgetArrowUp;
     _btnMinimize.color = c_highlightColor;
 
     connect(&_btnMinimize, &NFButtonMinimize::onClick, this, &NodeFactoryWidget::onButtonMinimizeClick);
+    connect(&_filter, &QLineEdit::textChanged, this, &NodeFactoryWidget::onFilterChanged);
+    connect(&_category, &QComboBox::currentIndexChanged, this, &NodeFactoryWidget::onFilterChanged);
+
+    relayout();
 }
 
 NodeFactoryWidget::~NodeFactoryWidget()
 { delete _painter; }
 
-void NodeFactoryWidget::onButtonMinimizeClick()
+void NodeFactoryWidget::onButtonMinimizeClick() { setMinimized(!_bIsMinimized); }
+
+void NodeFactoryWidget::setMinimized(bool b)
 {
-    _bIsMinimized = !_bIsMinimized;
+    _bIsMinimized = b;
     _btnMinimize.text = _bIsMinimized ? c_nfWidgetArrowDown : c_nfWidgetArrowUp;
-    if (_bIsMinimized)
-        _layoutHolder.hide();
-    else
-        _layoutHolder.show();
+    _filter.setVisible(!_bIsMinimized);
+    _category.setVisible(!_bIsMinimized && !_model.categories().isEmpty());
+    _rows.setVisible(!_bIsMinimized);
+    invalidateSize();
+}
+
+void NodeFactoryWidget::onFilterChanged()
+{
+    // the first item of the categories is every category
+    const QString category = _category.currentIndex() > 0 ? _category.currentText() : QString();
+    setFilter(_filter.text(), category);
+}
+
+void NodeFactoryWidget::setFilter(const QString &text, const QString &category)
+{
+    _model.setFilter(text, category);
+    _scroll = 0;
+    invalidateSize();
 }
 
 QSize NodeFactoryWidget::getDesiredSize() const
@@ -52,63 +83,129 @@ QSize NodeFactoryWidget::getDesiredSize() const
     if (_bIsMinimized)
         return QSize(c_nfWidgetMinimalWidth, c_nfWidgetSpacing * 1.5f);
 
-    QSize out;
-    int maxMetric = 0;
+    if (!_desiredSize)
+    {
+        const int width = std::max(c_nfWidgetMinimalWidth, _maxTextWidth + c_nfWidgetPadding * 2);
+        _desiredSize = QSize(width, listTop() + listHeight() + c_nfWidgetSpacing / 2);
+    }
+    return *_desiredSize;
+}
+
+int NodeFactoryWidget::rowHeight() const
+{
+    return QFontMetrics(standardFont(c_nfWidgetRowFontSize)).height() + _gap;
+}
+
+int NodeFactoryWidget::listTop() const
+{
+    int top = c_nfWidgetSpacing + c_nfWidgetFilterHeight + c_nfWidgetPadding;
+    if (!_model.categories().isEmpty())
+        top += c_nfWidgetFilterHeight + c_nfWidgetPadding / 2;
+    return top;
+}
+
+int NodeFactoryWidget::listHeight() const
+{
+    return static_cast<int>(std::min<qsizetype>(_model.visibleCount(), c_nfWidgetVisibleRows)) * rowHeight();
+}
+
+void NodeFactoryWidget::invalidateSize()
+{
+    _desiredSize = std::nullopt;
+    relayout();
+    // the canvas sizes and places the widget when it's painted
+    if (parentWidget())
+        parentWidget()->update();
+}
+
+void NodeFactoryWidget::relayout()
+{
+    const QSize size = getDesiredSize();
+    const int innerWidth = size.width() - c_nfWidgetPadding * 2;
+
+    _filter.setGeometry(c_nfWidgetPadding, c_nfWidgetSpacing, innerWidth, c_nfWidgetFilterHeight);
+    _category.setGeometry(c_nfWidgetPadding, c_nfWidgetSpacing + c_nfWidgetFilterHeight + c_nfWidgetPadding / 2,
+                          innerWidth, c_nfWidgetFilterHeight);
+    _rows.setGeometry(0, listTop(), size.width(), listHeight());
+    _btnMinimize.move((size.width() - _btnMinimize.width()) / 2, size.height() - _btnMinimize.height());
 
-    int maxImgWidth = 0, maxImgHeight = 0;
-    std::ranges::for_each(_nodeImages, [&](QSharedPointer<TypedNodeImage> ptr){
-        QSize imgSize = ptr->getDesiredSize();
-        maxImgWidth = std::max(maxImgWidth, imgSize.width());
-        maxImgHeight = std::max(maxImgHeight, imgSize.height());
-    });
+    updateRows();
+}
 
-    if (_layout.direction() == QBoxLayout::LeftToRight ||
-        _layout.direction() == QBoxLayout::RightToLeft)
+void NodeFactoryWidget::updateRows()
+{
+    const int height = rowHeight();
+    const auto [first, last] = PaletteModel::rowsInSpan(_scroll, _rows.height(), height, _model.visibleCount());
+
+    while (_pool.size() < last - first)
     {
-        maxMetric += c_nfWidgetSpacing;
-        maxMetric += _nodeImages.size() * (maxImgWidth + _gap);
-        out = QSize(maxMetric, c_nfWidgetSpacing + maxImgHeight);
+        TypedNodeImage *image = new TypedNodeImage(&_rows);
+        image->TypeManager = _nodeTypeManager;
+        image->fontSize = c_nfWidgetRowFontSize;
+        _pool.append(image);
     }
-    else
+
+    for (qsizetype i = 0; i < _pool.size(); i++)
     {
-        maxMetric += _nodeImages.size() * (maxImgHeight + _gap);
-        out = QSize( maxImgWidth, maxMetric);
+        TypedNodeImage *image = _pool[i];
+        const qsizetype row = first + i;
+        if (row >= last)
+        {
+            image->hide();
+            continue;
+        }
+
+        const PaletteEntry &entry = _model.visibleEntry(row);
+        image->setType(entry.name, entry.typeID);
+        image->setGeometry(0, static_cast<int>(row * height - _scroll), _rows.width(), height);
+        image->show();
     }
-    out.setWidth(std::max(c_nfWidgetMinimalWidth, out.width()));
+}
+
+void NodeFactoryWidget::scrollBy(int pixels)
+{
+    const int maxScroll = std::max(0, static_cast<int>(_model.visibleCount() * rowHeight()) - _rows.height());
+    const int scroll = std::clamp(_scroll + pixels, 0, maxScroll);
+    if (scroll == _scroll)
+        return;
 
-    return out;
+    _scroll = scroll;
+    updateRows();
 }
 
 void NodeFactoryWidget::clear()
 {
-    QLayoutItem* child;
-    while(_layout.count() != 0)
-    {
-        child = _layout.takeAt(0);
-        delete child;
-    }
-
-    _layout.addSpacing(c_nfWidgetSpacing);
+    _model.clear();
+    _maxTextWidth = 0;
+    _scroll = 0;
+    _category.clear();
+    _category.hide();
+    invalidateSize();
 }
 
 bool NodeFactoryWidget::initTypes()
 {
-    if (_nodeTypeManager->Types().isEmpty())
+    if (!_nodeTypeManager || _nodeTypeManager->typesCount() == 0)
         return false;
 
-    clear();
+    _model.setTypes(_nodeTypeManager);
+
+    // names are measured once here rather than every time the size is asked for
+    QFontMetrics metrics(standardFont(c_nfWidgetRowFontSize));
+    _maxTextWidth = 0;
+    for (qsizetype i = 0; i < _model.count(); i++)
+        _maxTextWidth = std::max(_maxTextWidth, metrics.horizontalAdvance(_model.entry(i).name));
 
-    try {
-        std::ranges::for_each(_nodeTypeManager->TypeNames().keys(), [&](const QString &typeName){
-            _nodeImages.append(QSharedPointer<TypedNodeImage>(new TypedNodeImage(typeName)));
-            TypedNodeImage *image = _nodeImages.last().get();
-            image->TypeManager = _nodeTypeManager;
-            image->initType();
-            _layout.addWidget(image);
-        });
-        _layout.addSpacing(c_nfWidgetSpacing / 2);
-    } catch (...) { return false; }
+    // the signal would filter the model again for every added item
+    const QSignalBlocker blocker(_category);
+    _category.clear();
+    _category.addItem("all categories");
+    _category.addItems(_model.categories());
+    _category.setCurrentIndex(std::max(0, static_cast<int>(_model.categories().indexOf(_model.filterCategory())) + 1));
+    _category.setVisible(!_bIsMinimized && !_model.categories().isEmpty());
 
+    std::ranges::for_each(_pool, [&](TypedNodeImage *image) { image->TypeManager = _nodeTypeManager; });
+    invalidateSize();
     return true;
 }
 
@@ -147,6 +244,14 @@ void NodeFactoryWidget::mouseMoveEvent(QMouseEvent *event)
     onMove(offset);
 }
 
+// the list scrolls instead of the canvas zooming under the palette
+void NodeFactoryWidget::wheelEvent(QWheelEvent *event)
+{
+    if (!_bIsMinimized)
+        scrollBy(-event->angleDelta().y() * rowHeight() / 120);
+    event->accept();
+}
+
 
 
 // ------------------- PAINT ----------------------
@@ -162,9 +267,6 @@ void NodeFactoryWidget::paintEvent(QPaintEvent *event)
 
 void NodeFactoryWidget::paint(QPainter *painter, QPaintEvent *)
 {
-    // this line avoids flickering between this widget and nodes
-    setUpdatesEnabled(false);
-
     QPen pen(Qt::SolidLine);
     pen.setColor(c_nfWidgetBackgroundColor);
     painter->setBrush(c_nfWidgetBackgroundColor);
@@ -179,17 +281,6 @@ void NodeFactoryWidget::paint(QPainter *painter, QPaintEvent *)
     painter->setFont(standardFont(13));
     painter->drawText(QRect(rect.x(), rect.y() + c_nfWidgetSpacing / 3, rect.width(), rect.height()),
                       (Qt::AlignTop | Qt::AlignHCenter), "drag & place");
-
-
-    _layoutHolder.setFixedSize(getDesiredSize());
-
-    // button minimize
-    {
-        _btnMinimize.move((this->width() - _btnMinimize.width()) / 2, this->height() - _btnMinimize.height());
-    }
-
-    // this line avoids flickering between this widget and nodes
-    setUpdatesEnabled(true);
 }
 
 }
@@ -3,21 +3,26 @@
 #include <QObject>
 #include <QWidget>
 #include <QPainter>
-#include <QBoxLayout>
 #include <QVector2D>
 #include <QPushButton>
-#include <QScrollArea>
+#include <QLineEdit>
+#include <QComboBox>
+#include <QWheelEvent>
+#include <optional>
 
 #include "GraphLib_global.h"
 #include "TypeManagers/nodetypemanager.h"
 #include "TypeManagers/pintypemanager.h"
 #include "typednodeimage.h"
+#include "palettemodel.h"
 #include "nfbuttonminimize.h"
 
 namespace GraphLib {
 
 namespace NodeFactoryModule {
 
+// Palette of the node types to drag onto the canvas. Only the rows in view have images,
+// a small pool of them is rebound to other types as the list scrolls or is filtered
 class GRAPHLIB_EXPORT NodeFactoryWidget : public QWidget
 {
     Q_OBJECT
@@ -26,20 +31,23 @@ public:
     explicit NodeFactoryWidget(QWidget *parent = nullptr);
     ~NodeFactoryWidget();
 
+    // Measured once per change of the types, the filter or the minimization
     QSize getDesiredSize() const;
     const QPointF &getPosition() const { return _position; }
     int getGap() const { return _gap; }
     bool isMinimized() const { return _bIsMinimized; }
+    const PaletteModel &model() const { return _model; }
 
-    inline void setDirection(QBoxLayout::Direction dir) { _layout.setDirection(dir); }
-    void setGap(int g) { _gap = g; }
+    void setGap(int g) { _gap = g; invalidateSize(); }
     void setPosition(QPointF pos) { _position = pos; }
     inline void setPosition(qreal x, qreal y) { setPosition(QPointF(x, y)); }
     void setX(qreal x) { setPosition(x, getPosition().y()); }
     void setY(qreal y) { setPosition(getPosition().x(), y); }
     void adjustPosition(QVector2D by) { _position += by.toPointF(); }
     inline void adjustPosition(qreal x, qreal y) { adjustPosition(QVector2D(x, y)); }
-    void setMinimized(bool b) { _bIsMinimized = b; }
+    void setMinimized(bool b);
+    // Shows the types whose name contains the text, of the category if it isn't empty
+    void setFilter(const QString &text, const QString &category = QString());
     bool initTypes();
     void clear();
 
@@ -51,25 +59,45 @@ protected:
     void mousePressEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
 
 private:
     void paint(QPainter *painter, QPaintEvent *event);
+    int rowHeight() const;
+    // Top of the list below the header and the filter
+    int listTop() const;
+    int listHeight() const;
+    void invalidateSize();
+    // Places the children for the new size and rebinds the rows
+    void relayout();
+    // Binds the pooled images to the rows in view, growing the pool if needed
+    void updateRows();
+    void scrollBy(int pixels);
 
 signals:
     void onMove(QVector2D offset);
 
 private slots:
     void onButtonMinimizeClick();
+    void onFilterChanged();
 
 private:
     QPainter *_painter;
     int _gap;
     bool _bIsMinimized;
     QPointF _position, _lastMouseDownPosition, _mousePressPosition;
-    QWidget _layoutHolder;
-    QBoxLayout _layout;
+    QLineEdit _filter;
+    QComboBox _category;
+    // Viewport of the list, the images are its children
+    QWidget _rows;
     NFButtonMinimize _btnMinimize;
-    QVector<QSharedPointer<TypedNodeImage>> _nodeImages;
+    PaletteModel _model;
+    QVector<TypedNodeImage*> _pool;
+    // Pixels the list is scrolled by
+    int _scroll;
+    // Widest type name, measured when the types are set
+    int _maxTextWidth;
+    mutable std::optional<QSize> _desiredSize;
 };
 
 }
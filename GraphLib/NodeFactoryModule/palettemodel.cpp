@@ -0,0 +1,95 @@
+#include <algorithm>
+
+#include "palettemodel.h"
+
+namespace GraphLib {
+
+namespace NodeFactoryModule {
+
+void PaletteModel::setTypes(const NodeTypeManager *manager)
+{
+    QVector<PaletteEntry> entries;
+    entries.reserve(manager->TypeNames().size());
+    std::ranges::for_each(manager->TypeNames().asKeyValueRange(), [&](std::pair<const QString &, const int &> type) {
+        entries.append({ type.first, manager->typeCategory(type.second), type.second });
+    });
+    setEntries(std::move(entries));
+}
+
+void PaletteModel::setEntries(QVector<PaletteEntry> entries)
+{
+    _entries = std::move(entries);
+    std::ranges::stable_sort(_entries, {}, &PaletteEntry::name);
+
+    _foldedNames.clear();
+    _foldedNames.reserve(_entries.size());
+    _categories.clear();
+    std::ranges::for_each(_entries, [&](const PaletteEntry &entry) {
+        _foldedNames.append(entry.name.toCaseFolded());
+        if (!entry.category.isEmpty())
+            _categories.append(entry.category);
+    });
+    _categories.sort();
+    _categories.removeDuplicates();
+
+    refilter();
+}
+
+void PaletteModel::clear()
+{
+    _entries.clear();
+    _foldedNames.clear();
+    _visible.clear();
+    _categories.clear();
+}
+
+void PaletteModel::setFilter(const QString &text, const QString &category)
+{
+    const QString folded = text.trimmed().toCaseFolded();
+    if (folded == _filterText && category == _filterCategory)
+        return;
+
+    // typing narrows the filter, only the rows passing the previous one are checked again
+    const bool bIsNarrowed = category == _filterCategory && folded.contains(_filterText);
+    _filterText = folded;
+    _filterCategory = category;
+
+    if (!bIsNarrowed)
+    {
+        refilter();
+        return;
+    }
+
+    _visible.removeIf([&](qsizetype index) { return !passes(index); });
+}
+
+bool PaletteModel::passes(qsizetype index) const
+{
+    return (_filterCategory.isEmpty() || _entries[index].category == _filterCategory)
+        && _foldedNames[index].contains(_filterText);
+}
+
+void PaletteModel::refilter()
+{
+    _visible.clear();
+    _visible.reserve(_entries.size());
+    for (qsizetype i = 0; i < _entries.size(); i++)
+    {
+        if (passes(i))
+            _visible.append(i);
+    }
+}
+
+QPair<qsizetype, qsizetype> PaletteModel::rowsInSpan(int offset, int span, int rowHeight, qsizetype count)
+{
+    if (rowHeight <= 0 || span <= 0)
+        return { 0, 0 };
+
+    const qsizetype first = std::clamp<qsizetype>(offset / rowHeight, 0, count);
+    const qsizetype last = std::clamp<qsizetype>((offset + span + rowHeight - 1) / rowHeight, first, count);
+    return { first, last };
+}
+
+}
+
+}
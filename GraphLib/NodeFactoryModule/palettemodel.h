@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+
+#include "TypeManagers/nodetypemanager.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+namespace NodeFactoryModule {
+
+struct PaletteEntry
+{
+    QString name, category;
+    int typeID;
+};
+
+// Rows of the NodeFactoryWidget: every node type sorted by name and the ones passing the filter.
+// The widget only creates images for the rows it shows, the rest of them live here
+class GRAPHLIB_EXPORT PaletteModel
+{
+public:
+    PaletteModel() {}
+
+    // Takes the types' names and their optional "category", keeping the filter. No type is parsed
+    void setTypes(const NodeTypeManager *manager);
+    void setEntries(QVector<PaletteEntry> entries);
+    void clear();
+
+    // Types whose name contains the text in any case, of the category if it isn't empty
+    void setFilter(const QString &text, const QString &category = QString());
+    const QString &filterText() const { return _filterText; }
+    const QString &filterCategory() const { return _filterCategory; }
+
+    qsizetype count() const { return _entries.size(); }
+    qsizetype visibleCount() const { return _visible.size(); }
+    const PaletteEntry &entry(qsizetype index) const { return _entries[index]; }
+    const PaletteEntry &visibleEntry(qsizetype row) const { return _entries[_visible[row]]; }
+    // Sorted categories of the types, without the empty one
+    const QStringList &categories() const { return _categories; }
+
+    // Rows [first, last) of the given height touching the span of pixels starting at the offset
+    static QPair<qsizetype, qsizetype> rowsInSpan(int offset, int span, int rowHeight, qsizetype count);
+
+private:
+    bool passes(qsizetype index) const;
+    void refilter();
+
+    QVector<PaletteEntry> _entries;
+    // Case folded names of the entries for filtering
+    QVector<QString> _foldedNames;
+    // Indices of the entries passing the filter
+    QVector<qsizetype> _visible;
+    QStringList _categories;
+    QString _filterText, _filterCategory;
+};
+
+}
+
+}
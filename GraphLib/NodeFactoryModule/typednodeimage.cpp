@@ -81,7 +81,7 @@ void TypedNodeImage::paint(QPainter *painter, QPaintEvent *event)
 
     QRect rect = event->rect();
 
-    painter->setFont(standardFont(11));
+    painter->setFont(standardFont(fontSize));
     painter->drawText(QRect(rect.x(), rect.y(), rect.width(), rect.height()),
                       (Qt::AlignTop | Qt::AlignHCenter), typeName);
 
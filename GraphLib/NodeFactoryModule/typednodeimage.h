@@ -22,6 +22,8 @@ public:
     TypedNodeSpawnData getData() const;
     QSize getDesiredSize() const;
     void initType() { typeID = TypeManager->TypeNames()[typeName]; }
+    // The palette rebinds its images to other types as it scrolls
+    void setType(const QString &type, int ID) { if (type != typeName) { typeName = type; update(); } typeID = ID; }
 
     QString typeName;
     int typeID;
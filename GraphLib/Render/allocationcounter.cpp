@@ -0,0 +1,82 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocationcounter.h"
+
+namespace {
+
+std::atomic<quint64> s_allocations{ 0 };
+
+}
+
+namespace GraphLib {
+
+namespace AllocationCounter {
+
+bool isEnabled()
+{
+#ifdef GRAPHLIB_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 count() { return s_allocations.load(std::memory_order_relaxed); }
+
+}
+
+}
+
+#ifdef GRAPHLIB_TRACK_ALLOCATIONS
+
+#if defined(__GLIBC__)
+
+// Qt containers allocate with malloc directly, so on glibc the whole malloc family
+// is interposed (operator new ends up here as well)
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+}
+
+#else
+
+void *operator new(std::size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+#endif
+
+#endif
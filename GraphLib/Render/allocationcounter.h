@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Debug counter of global heap allocations.
+// It only counts when GraphLib is built with CONFIG += graphlib_track_allocations,
+// otherwise isEnabled() returns false and count() stays 0.
+// The counter is process-wide, so allocations made by other threads are included.
+namespace AllocationCounter {
+
+bool GRAPHLIB_EXPORT isEnabled();
+quint64 GRAPHLIB_EXPORT count();
+
+}
+
+}
@@ -0,0 +1,11 @@
+#include "framearena.h"
+
+namespace GraphLib {
+
+FrameArena::FrameArena(std::size_t capacity)
+    : _capacity{ capacity }
+    , _buffer{ std::make_unique<std::byte[]>(capacity) }
+    , _resource{ _buffer.get(), capacity, std::pmr::new_delete_resource() }
+{}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Monotonic per-frame arena. Paint-time temporaries are allocated from it
+// and all of them are released at once by reset() when the next frame starts.
+// If a frame needs more than the preallocated capacity, the overflow falls back
+// to the global heap (and shows up in AllocationCounter).
+class GRAPHLIB_EXPORT FrameArena
+{
+public:
+    explicit FrameArena(std::size_t capacity);
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    std::pmr::memory_resource *resource() { return &_resource; }
+    std::size_t capacity() const { return _capacity; }
+
+    void reset() { _resource.release(); }
+
+    template <typename T>
+    std::pmr::vector<T> makeVector(std::size_t reserved = 0)
+    {
+        std::pmr::vector<T> out(&_resource);
+        out.reserve(reserved);
+        return out;
+    }
+
+private:
+    std::size_t _capacity;
+    std::unique_ptr<std::byte[]> _buffer;
+    std::pmr::monotonic_buffer_resource _resource;
+};
+
+}
@@ -0,0 +1,46 @@
+#include "frameclock.h"
+
+namespace GraphLib {
+
+FrameClock::FrameClock(QObject *parent, int intervalMs)
+    : QObject{ parent }
+    , _intervalMs{ intervalMs }
+    , _bIsFrameRequested{ false }
+{
+    _timer.setTimerType(Qt::PreciseTimer);
+    connect(&_timer, &QTimer::timeout, this, &FrameClock::tick);
+}
+
+void FrameClock::requestFrame()
+{
+    _bIsFrameRequested = true;
+    if (!_timer.isActive())
+        _timer.start(0);
+}
+
+void FrameClock::flush()
+{
+    if (_bIsFrameRequested)
+        tick();
+}
+
+void FrameClock::tick()
+{
+    if (!_bIsFrameRequested)
+    {
+        _timer.stop();
+        _sinceLastFrame.invalidate();
+        return;
+    }
+    _bIsFrameRequested = false;
+
+    const qint64 intervalNs = qint64(_intervalMs) * 1000000;
+    const qint64 elapsedNs = _sinceLastFrame.isValid() ? _sinceLastFrame.nsecsElapsed() : intervalNs;
+    _sinceLastFrame.start();
+    if (_timer.interval() != _intervalMs)
+        _timer.start(_intervalMs);
+
+    emit onFrame(elapsedNs);
+}
+
+}
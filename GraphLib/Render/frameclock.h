@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include "constants.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Ticks at most once per interval and only while frames are requested, so an idle
+// canvas doesn't wake up at all. Work wanting another frame requests it from onFrame
+class GRAPHLIB_EXPORT FrameClock : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameClock(QObject *parent = nullptr, int intervalMs = c_frameIntervalMs);
+
+    // Requests made before the next frame are merged into it. The first frame
+    // after idling comes right away, the next ones an interval after each other
+    void requestFrame();
+    // Runs a requested frame right away rather than on the timer, for callers not running an event loop
+    void flush();
+    bool isRunning() const { return _timer.isActive(); }
+    int interval() const { return _intervalMs; }
+
+signals:
+    // Time since the previous frame, a whole interval for the first frame after idling
+    void onFrame(qint64 elapsedNs);
+
+private:
+    void tick();
+
+    QTimer _timer;
+    QElapsedTimer _sinceLastFrame;
+    int _intervalMs;
+    bool _bIsFrameRequested;
+};
+
+}
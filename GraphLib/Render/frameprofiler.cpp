@@ -0,0 +1,37 @@
+#include <numeric>
+
+#include "frameprofiler.h"
+#include "allocationcounter.h"
+
+namespace GraphLib {
+
+FrameProfiler::ScopedPhase::ScopedPhase(FrameProfiler &profiler, FramePhase phase)
+    : _profiler{ profiler }
+    , _phase{ phase }
+    , _allocationsAtStart{ AllocationCounter::count() }
+{
+    _timer.start();
+}
+
+FrameProfiler::ScopedPhase::~ScopedPhase()
+{
+    FrameStats &stats = _profiler._current;
+    stats.phaseNs[static_cast<int>(_phase)] += _timer.nsecsElapsed();
+    stats.allocations += AllocationCounter::count() - _allocationsAtStart;
+}
+
+FrameProfiler::FrameProfiler()
+    : _current{ FrameStats() }
+    , _last{ FrameStats() }
+{}
+
+void FrameProfiler::beginFrame()
+{
+    _current.totalNs = std::accumulate(_current.phaseNs.begin(), _current.phaseNs.end(), qint64(0));
+    _last = _current;
+
+    _current = FrameStats();
+    _current.frameNumber = _last.frameNumber + 1;
+}
+
+}
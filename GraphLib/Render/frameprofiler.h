@@ -0,0 +1,74 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <array>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+enum class FramePhase
+{
+    Background,
+    NodeLayout,
+    Edges,
+    DragPreview,
+    // Node factory widget management and painting of the node widgets
+    WidgetCompositing,
+
+    Count
+};
+
+struct GRAPHLIB_EXPORT FrameStats
+{
+    quint64 frameNumber = 0;
+    std::array<qint64, static_cast<int>(FramePhase::Count)> phaseNs = {};
+    qint64 totalNs = 0;
+
+    int nodesDrawn = 0;
+    int nodesCulled = 0;
+    int edgesDrawn = 0;
+    int edgesCulled = 0;
+
+    // Only counted when allocation tracking is built in, see AllocationCounter
+    quint64 allocations = 0;
+
+    qint64 phase(FramePhase p) const { return phaseNs[static_cast<int>(p)]; }
+};
+
+// Collects per-phase timings of canvas frames. Child widgets are painted after
+// the canvas, so a frame is finalized when the next one begins
+class GRAPHLIB_EXPORT FrameProfiler
+{
+public:
+    // Adds the time (and allocations) spent in its scope to a phase of the current frame
+    class GRAPHLIB_EXPORT ScopedPhase
+    {
+    public:
+        ScopedPhase(FrameProfiler &profiler, FramePhase phase);
+        ~ScopedPhase();
+        ScopedPhase(const ScopedPhase &) = delete;
+        ScopedPhase &operator=(const ScopedPhase &) = delete;
+
+    private:
+        FrameProfiler &_profiler;
+        FramePhase _phase;
+        QElapsedTimer _timer;
+        quint64 _allocationsAtStart;
+    };
+
+    FrameProfiler();
+
+    void beginFrame();
+
+    // Counters of the frame being painted
+    FrameStats &current() { return _current; }
+    // The last finished frame
+    const FrameStats &lastFrame() const { return _last; }
+
+private:
+    FrameStats _current;
+    FrameStats _last;
+};
+
+}
@@ -0,0 +1,59 @@
+#include <cmath>
+
+#include "kineticpan.h"
+#include "constants.h"
+
+namespace GraphLib {
+
+KineticPan::KineticPan()
+    : _velocity{ QPointF() }
+    , _bIsMoving{ false }
+{}
+
+void KineticPan::track(QPointF delta, qint64 elapsedNs)
+{
+    if (elapsedNs <= 0)
+        return;
+
+    _bIsMoving = false;
+    const QPointF velocity = delta * (1e9 / elapsedNs);
+    // the first movement after a pause isn't mixed with the old velocity
+    if (!_sinceLastTrack.isValid() || _sinceLastTrack.elapsed() > c_kineticPanReleaseWindowMs)
+        _velocity = velocity;
+    else
+        _velocity += (velocity - _velocity) * c_kineticPanVelocitySmoothing;
+    _sinceLastTrack.start();
+}
+
+void KineticPan::release()
+{
+    const bool bIsRecent = _sinceLastTrack.isValid() && _sinceLastTrack.elapsed() <= c_kineticPanReleaseWindowMs;
+    _sinceLastTrack.invalidate();
+
+    _bIsMoving = bIsRecent && std::hypot(_velocity.x(), _velocity.y()) >= c_kineticPanMinSpeed;
+    if (!_bIsMoving)
+        _velocity = QPointF();
+}
+
+void KineticPan::stop()
+{
+    _bIsMoving = false;
+    _velocity = QPointF();
+    _sinceLastTrack.invalidate();
+}
+
+QPointF KineticPan::step(qint64 elapsedNs)
+{
+    if (!_bIsMoving)
+        return QPointF();
+
+    const double seconds = elapsedNs / 1e9;
+    const QPointF delta = _velocity * seconds;
+    _velocity *= std::exp(-c_kineticPanFriction * seconds);
+
+    if (std::hypot(_velocity.x(), _velocity.y()) < c_kineticPanMinSpeed)
+        stop();
+    return delta;
+}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QPointF>
+#include <QElapsedTimer>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Keeps a view moving after the pan is released, slowing it down with friction.
+// Velocities are in pixels per second, the steps are what the view moves by in a frame
+class GRAPHLIB_EXPORT KineticPan
+{
+public:
+    KineticPan();
+
+    // Feeds the movement made during a frame of panning
+    void track(QPointF delta, qint64 elapsedNs);
+    // Starts moving if the pan was still moving when released
+    void release();
+    void stop();
+
+    bool isMoving() const { return _bIsMoving; }
+    QPointF velocity() const { return _velocity; }
+    // Movement for a frame, decays the velocity and stops when it's slow enough
+    QPointF step(qint64 elapsedNs);
+
+private:
+    QPointF _velocity;
+    QElapsedTimer _sinceLastTrack;
+    bool _bIsMoving;
+};
+
+}
@@ -0,0 +1,119 @@
+#include <QPainter>
+#include <algorithm>
+
+#include "minimapraster.h"
+
+namespace GraphLib {
+
+MinimapRaster::MinimapRaster(QSize size)
+    : _image{ QImage(size, QImage::Format_ARGB32_Premultiplied) }
+    , _area{ QRectF(QPointF(0, 0), QSizeF(size)) }
+    , _scale{ 1.0 }
+    , _nodes{ SpatialIndex() }
+    , _dirty{ QVector<QRectF>() }
+    , _bIsFullRedrawNeeded{ true }
+    , _redrawnNodes{ 0 }
+{
+    _image.fill(Qt::transparent);
+}
+
+void MinimapRaster::setNode(int nodeID, const QRectF &rect)
+{
+    const bool bIsIndexed = _nodes.contains(nodeID);
+    const QRectF previous = _nodes.rect(nodeID);
+    if (bIsIndexed && previous == rect)
+        return;
+
+    _nodes.insert(nodeID, rect);
+    if (bIsIndexed)
+        _dirty.append(previous);
+    _dirty.append(rect);
+
+    if (!_area.contains(rect))
+        _bIsFullRedrawNeeded = true;
+}
+
+void MinimapRaster::removeNode(int nodeID)
+{
+    if (!_nodes.contains(nodeID))
+        return;
+
+    _dirty.append(_nodes.rect(nodeID));
+    _nodes.remove(nodeID);
+}
+
+void MinimapRaster::clear()
+{
+    _nodes.clear();
+    _dirty.clear();
+    _bIsFullRedrawNeeded = true;
+}
+
+bool MinimapRaster::update()
+{
+    _redrawnNodes = 0;
+    if (!isDirty())
+        return false;
+
+    QPainter painter(&_image);
+    if (_bIsFullRedrawNeeded || _dirty.size() > c_minimapMaxDirtyAreas)
+    {
+        fitArea();
+        redraw(&painter, _image.rect());
+    }
+    else
+    {
+        std::ranges::for_each(_dirty, [&](const QRectF &area) {
+            // a pixel around for the rects rounded up to a pixel
+            const QRect pixels = mapFromCanvas(area).toAlignedRect().adjusted(-1, -1, 1, 1) & _image.rect();
+            if (!pixels.isEmpty())
+                redraw(&painter, pixels);
+        });
+    }
+
+    _dirty.clear();
+    _bIsFullRedrawNeeded = false;
+    return true;
+}
+
+void MinimapRaster::fitArea()
+{
+    QRectF bounds = _nodes.bounds();
+    if (bounds.isEmpty())
+        bounds = QRectF(QPointF(0, 0), QSizeF(_image.size()));
+
+    const double room = std::max(bounds.width(), bounds.height()) * c_minimapAreaRoom;
+    bounds.adjust(-room, -room, room, room);
+
+    _scale = std::min(_image.width() / bounds.width(), _image.height() / bounds.height());
+    const QSizeF size = QSizeF(_image.size()) / _scale;
+    _area = QRectF(bounds.center() - QPointF(size.width(), size.height()) / 2, size);
+}
+
+void MinimapRaster::redraw(QPainter *painter, const QRect &pixels)
+{
+    painter->setCompositionMode(QPainter::CompositionMode_Source);
+    painter->fillRect(pixels, Qt::transparent);
+    painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    const QRectF area(mapToCanvas(pixels.topLeft()), QSizeF(pixels.size()) / _scale);
+    _nodes.query(area, _found);
+
+    // every node is at least a pixel, so small ones don't disappear
+    _rects.clear();
+    std::ranges::for_each(_found, [&](int nodeID) {
+        QRectF rect = mapFromCanvas(_nodes.rect(nodeID));
+        rect.setSize(rect.size().expandedTo(QSizeF(1, 1)));
+        _rects.append(rect);
+    });
+    _redrawnNodes += _rects.size();
+
+    painter->save();
+    painter->setClipRect(pixels);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(c_highlightColor);
+    painter->drawRects(_rects.constData(), _rects.size());
+    painter->restore();
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QImage>
+#include <QPointF>
+#include <QRectF>
+#include <QSize>
+#include <QVector>
+
+#include "Spatial/spatialindex.h"
+#include "constants.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Low-resolution image of every node of a canvas, used by the minimap. Changes only mark
+// their area as dirty and update redraws the dirty areas, so keeping it up to date costs
+// as much as the changes do rather than as much as the graph does
+class GRAPHLIB_EXPORT MinimapRaster
+{
+public:
+    explicit MinimapRaster(QSize size = c_minimapRasterSize);
+
+    // Inserts the node's rect in canvas coordinates or moves it
+    void setNode(int nodeID, const QRectF &rect);
+    void removeNode(int nodeID);
+    void clear();
+
+    // Redraws the areas changed since the last update. The whole image is redrawn
+    // when a node leaves the shown area or there are too many changes. Returns false if nothing has changed
+    bool update();
+    bool isDirty() const { return _bIsFullRedrawNeeded || !_dirty.isEmpty(); }
+
+    const QImage &image() const { return _image; }
+    // Canvas area the image shows, it keeps the aspect ratio of the image
+    const QRectF &area() const { return _area; }
+    QPointF mapFromCanvas(QPointF point) const { return (point - _area.topLeft()) * _scale; }
+    QPointF mapToCanvas(QPointF point) const { return point / _scale + _area.topLeft(); }
+    QRectF mapFromCanvas(const QRectF &rect) const { return QRectF(mapFromCanvas(rect.topLeft()), rect.size() * _scale); }
+
+    // Nodes drawn during the last update
+    int redrawnNodes() const { return _redrawnNodes; }
+
+private:
+    // Fits the area to the nodes with some room to grow, so new nodes don't redraw everything
+    void fitArea();
+    void redraw(QPainter *painter, const QRect &pixels);
+
+    QImage _image;
+    QRectF _area;
+    double _scale;
+    SpatialIndex _nodes;
+    // Changed areas in canvas coordinates
+    QVector<QRectF> _dirty;
+    bool _bIsFullRedrawNeeded;
+    int _redrawnNodes;
+
+    // Reused between updates
+    QVector<int> _found;
+    QVector<QRectF> _rects;
+};
+
+}
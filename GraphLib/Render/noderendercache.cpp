@@ -0,0 +1,26 @@
+#include <algorithm>
+
+#include "noderendercache.h"
+
+namespace GraphLib {
+
+NodeRenderCache::NodeRenderCache(qsizetype budgetKb)
+    : _cache{ budgetKb }
+{}
+
+void NodeRenderCache::insert(const NodeRenderKey &key, const QPixmap &pixmap)
+{
+    qsizetype costKb = static_cast<qsizetype>(pixmap.width()) * pixmap.height() * pixmap.depth() / 8 / 1024 + 1;
+    _cache.insert(key, new QPixmap(pixmap), costKb);
+}
+
+void NodeRenderCache::retainLevels(short minLevel, short maxLevel)
+{
+    const QList<NodeRenderKey> keys = _cache.keys();
+    std::ranges::for_each(keys, [&](const NodeRenderKey &key) {
+        if (key.zoomLevel < minLevel || key.zoomLevel > maxLevel)
+            _cache.remove(key);
+    });
+}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <QCache>
+#include <QHashFunctions>
+#include <QPixmap>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Everything a node's appearance depends on. The generation changes whenever
+// the node changes in a way that isn't covered by the other fields (name, pins...)
+struct NodeRenderKey
+{
+    int nodeID;
+    quint64 generation;
+    short zoomLevel;
+    bool bIsSelected;
+    // bit i is set if the i-th pin of the node is connected
+    quint64 connectedPins;
+
+    bool operator==(const NodeRenderKey &other) const = default;
+};
+
+inline size_t qHash(const NodeRenderKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.nodeID, key.generation, key.zoomLevel, key.bIsSelected, key.connectedPins);
+}
+
+// LRU cache of rendered node images shared by all nodes of a canvas.
+// The cost of an entry is its size in kilobytes
+class GRAPHLIB_EXPORT NodeRenderCache
+{
+public:
+    explicit NodeRenderCache(qsizetype budgetKb);
+
+    const QPixmap *find(const NodeRenderKey &key) const { return _cache.object(key); }
+    void insert(const NodeRenderKey &key, const QPixmap &pixmap);
+    void clear() { _cache.clear(); }
+    // Drops the images of the zoom levels outside of the range
+    void retainLevels(short minLevel, short maxLevel);
+
+    qsizetype size() const { return _cache.size(); }
+
+private:
+    QCache<NodeRenderKey, QPixmap> _cache;
+};
+
+}
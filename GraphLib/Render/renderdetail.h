@@ -0,0 +1,32 @@
+#pragma once
+
+#include "constants.h"
+
+namespace GraphLib {
+
+// Level of detail used to render the canvas, ordered from the farthest zoom to the closest
+enum class RenderDetail
+{
+    // Nodes are colored rectangles drawn by the canvas in one batch,
+    // edges are straight lines aggregated per node pair, no pins and no names
+    Overview,
+    // No pin text, node names are replaced with placeholders
+    Simplified,
+    // Everything is drawn, text comes from cached glyph runs (QStaticText)
+    Reduced,
+    // Everything is drawn as is
+    Full,
+};
+
+inline RenderDetail renderDetailForZoom(float zoomMult)
+{
+    if (zoomMult <= c_overviewZoomMultiplier)
+        return RenderDetail::Overview;
+    if (zoomMult <= c_changeRenderZoomMultiplier)
+        return RenderDetail::Simplified;
+    if (zoomMult <= c_cachedTextZoomMultiplier)
+        return RenderDetail::Reduced;
+    return RenderDetail::Full;
+}
+
+}
@@ -0,0 +1,180 @@
+#include <QPainter>
+#include <QPainterPath>
+#include <QtConcurrent>
+#include <cmath>
+
+#include "tilerenderer.h"
+#include "constants.h"
+#include "utility.h"
+
+namespace GraphLib {
+
+namespace {
+
+int floorDiv(int value, int divisor)
+{
+    return value / divisor - (value % divisor != 0 && (value < 0) != (divisor < 0) ? 1 : 0);
+}
+
+}
+
+void TileScene::addEdge(Edge edge)
+{
+    QRectF bounds;
+    if (edge.route.isEmpty())
+    {
+        bounds = QRectF(edge.origin, edge.target).normalized();
+        // curve's control points are at most c_maxDiffsSum beyond its ends
+        if (!bHasStraightEdges)
+            bounds.adjust(-c_maxDiffsSum, -c_maxDiffsSum, c_maxDiffsSum, c_maxDiffsSum);
+    }
+    else
+    {
+        bounds = QRectF(edge.route.first(), QSizeF(0, 0));
+        std::ranges::for_each(edge.route, [&](QPointF point) { bounds |= QRectF(point, QSizeF(0.01, 0.01)); });
+    }
+
+    bounds.adjust(-c_pinConnectLineWidth, -c_pinConnectLineWidth, c_pinConnectLineWidth, c_pinConnectLineWidth);
+    edgeIndex.insert(edges.size(), bounds);
+    edges.append(std::move(edge));
+}
+
+void TileScene::addNode(Node node)
+{
+    nodeIndex.insert(nodes.size(), node.rect);
+    nodes.append(node);
+}
+
+void TileScene::clear()
+{
+    bHasStraightEdges = false;
+    edges.clear();
+    nodes.clear();
+    edgeIndex.clear();
+    nodeIndex.clear();
+}
+
+TileRenderer::TileRenderer(int tileSize)
+    : _tileSize{ tileSize }
+    , _level{ 0 }
+    , _levels{ QHash<short, QHash<QPoint, QImage>>() }
+    , _missing{ QVector<QPoint>() }
+    , _renderedTiles{ 0 }
+{}
+
+void TileRenderer::setLevel(short level)
+{
+    _level = level;
+    _levels.removeIf([&](QHash<short, QHash<QPoint, QImage>>::iterator &it) { return std::abs(it.key() - level) > c_zoomCachedLevels; });
+}
+
+void TileRenderer::paint(QPainter *painter, const TileScene &scene, QPoint origin, const QRect &viewport, float zoomMult, float dotGap)
+{
+    _renderedTiles = 0;
+    QHash<QPoint, QImage> &tiles = _levels[_level];
+
+    // viewport in zoomed canvas pixels
+    const QRect visible = viewport.translated(-origin);
+    const int left = floorDiv(visible.left(), _tileSize), right = floorDiv(visible.right(), _tileSize);
+    const int top = floorDiv(visible.top(), _tileSize), bottom = floorDiv(visible.bottom(), _tileSize);
+
+    _missing.clear();
+    for (int y = top; y <= bottom; y++)
+        for (int x = left; x <= right; x++)
+            if (!tiles.contains(QPoint(x, y)))
+                _missing.append(QPoint(x, y));
+
+    if (!_missing.isEmpty())
+    {
+        QVector<QImage> images = QtConcurrent::blockingMapped<QVector<QImage>>(_missing, [&](const QPoint &tile) {
+            return renderTile(scene, tile, _tileSize, zoomMult, dotGap);
+        });
+        for (int i = 0; i < _missing.size(); i++)
+            tiles.insert(_missing[i], images[i]);
+        _renderedTiles = _missing.size();
+
+        // tiles away from the viewport are dropped, so memory is bounded by the viewport size
+        for (auto it = tiles.begin(); it != tiles.end();)
+        {
+            const QPoint &tile = it.key();
+            if (tile.x() < left - 1 || tile.x() > right + 1 || tile.y() < top - 1 || tile.y() > bottom + 1)
+                it = tiles.erase(it);
+            else
+                it++;
+        }
+    }
+
+    for (int y = top; y <= bottom; y++)
+        for (int x = left; x <= right; x++)
+            painter->drawImage(origin + QPoint(x, y) * _tileSize, tiles.value(QPoint(x, y)));
+}
+
+QImage TileRenderer::renderTile(const TileScene &scene, QPoint tile, int tileSize, float zoomMult, float dotGap)
+{
+    QImage image(tileSize, tileSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    const QPoint topLeft = tile * tileSize;
+    QPainter painter(&image);
+    painter.translate(-topLeft);
+
+    // BACKGROUND: dots lie on multiples of the gap in zoomed canvas pixels
+    painter.setPen(c_dotsColor);
+    const double firstX = std::ceil(topLeft.x() / dotGap) * dotGap;
+    const double firstY = std::ceil(topLeft.y() / dotGap) * dotGap;
+    for (double x = firstX; x < topLeft.x() + tileSize; x += dotGap)
+        for (double y = firstY; y < topLeft.y() + tileSize; y += dotGap)
+            painter.drawPoint(QPointF(x, y));
+
+    const QRectF area(QPointF(topLeft) / zoomMult, QSizeF(tileSize, tileSize) / zoomMult);
+    const QVector<int> edges = scene.edgeIndex.query(area);
+
+    // EDGES: the same curves and routes the canvas draws, see Canvas::paint
+    if (scene.bHasStraightEdges)
+    {
+        QPen pen(c_highlightColor);
+        pen.setWidthF(std::max(1.0f, c_pinConnectLineWidth * zoomMult));
+        painter.setPen(pen);
+        std::ranges::for_each(edges, [&](int index) {
+            const TileScene::Edge &edge = scene.edges[index];
+            painter.drawLine(edge.origin * zoomMult, edge.target * zoomMult);
+        });
+    }
+    else
+    {
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        const QTransform transform = QTransform::fromScale(zoomMult, zoomMult);
+        QPainterPath path;
+        std::ranges::for_each(edges, [&](int index) {
+            const TileScene::Edge &edge = scene.edges[index];
+            const QPoint origin = (edge.origin * zoomMult).toPoint();
+            const QPoint target = (edge.target * zoomMult).toPoint();
+
+            painter.setPen(standardEdgePen(edge.originColor, edge.targetColor, origin, target, zoomMult));
+            if (edge.route.isEmpty())
+                standardPath(path, origin, target, zoomMult);
+            else
+                routedPath(path, edge.route, c_edgeRouteCornerRadius * zoomMult, transform);
+            painter.drawPath(path);
+        });
+        painter.setRenderHint(QPainter::Antialiasing, false);
+    }
+
+    // NODES: batched rects as in the overview
+    QVector<QRectF> rects, selectedRects;
+    std::ranges::for_each(scene.nodeIndex.query(area), [&](int index) {
+        const TileScene::Node &node = scene.nodes[index];
+        QRectF rect(node.rect.topLeft() * zoomMult, node.rect.size() * zoomMult);
+        (node.bIsSelected ? selectedRects : rects).append(rect);
+    });
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(c_nodesBackgroundColor);
+    painter.drawRects(rects.constData(), rects.size());
+    painter.setBrush(c_selectionColor);
+    painter.drawRects(selectedRects.constData(), selectedRects.size());
+
+    return image;
+}
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QColor>
+#include <QHash>
+#include <QImage>
+#include <QPoint>
+#include <QRectF>
+#include <QVector>
+
+#include "Spatial/spatialindex.h"
+#include "constants.h"
+#include "GraphLib_global.h"
+
+class QPainter;
+
+namespace GraphLib {
+
+// Everything the canvas draws itself, in canvas coordinates. It's built on the GUI thread
+// and only read by the workers rasterizing tiles
+struct GRAPHLIB_EXPORT TileScene
+{
+    struct Edge
+    {
+        QPointF origin, target;
+        QColor originColor, targetColor;
+        // See EdgeRoute, the standard curve is drawn if it's empty
+        QVector<QPointF> route;
+    };
+
+    struct Node
+    {
+        QRectF rect;
+        bool bIsSelected;
+    };
+
+    // Overview edges are straight lines of a single color
+    bool bHasStraightEdges = false;
+    QVector<Edge> edges;
+    // Only filled at RenderDetail::Overview, otherwise nodes are widgets
+    QVector<Node> nodes;
+
+    void addEdge(Edge edge);
+    void addNode(Node node);
+    void clear();
+
+    // Indices in edges and nodes keyed by the area they cover
+    SpatialIndex edgeIndex;
+    SpatialIndex nodeIndex;
+};
+
+// Rasterizes a TileScene into square images in parallel on the global thread pool, with a QPainter
+// per worker. Tiles are aligned to the zoomed canvas, so panning only renders the newly exposed ones.
+// Tiles are kept per zoom level, so zooming back and forth around a level reuses them
+class GRAPHLIB_EXPORT TileRenderer
+{
+public:
+    explicit TileRenderer(int tileSize = c_tileSize);
+
+    // Drops every tile of every level, call it when the scene changes
+    void invalidate() { _levels.clear(); }
+    // Switches to the tiles of the level, dropping the levels farther than c_zoomCachedLevels from it
+    void setLevel(short level);
+
+    // Renders the missing tiles of the viewport and composites them. Origin is where
+    // the canvas point (0, 0) is in the viewport, dotGap is the zoomed gap of the background dots
+    void paint(QPainter *painter, const TileScene &scene, QPoint origin, const QRect &viewport, float zoomMult, float dotGap);
+
+    int tileSize() const { return _tileSize; }
+    qsizetype size() const { return _levels.value(_level).size(); }
+    // Tiles rasterized during the last paint
+    int renderedTiles() const { return _renderedTiles; }
+
+    static QImage renderTile(const TileScene &scene, QPoint tile, int tileSize, float zoomMult, float dotGap);
+
+private:
+    int _tileSize;
+    short _level;
+    QHash<short, QHash<QPoint, QImage>> _levels;
+    QVector<QPoint> _missing;
+    int _renderedTiles;
+};
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.h"
+
+namespace GraphLib {
+
+// Zoom is continuous, but node layouts and the render caches are kept per zoom level.
+// Levels are a geometric series of multipliers with level 0 being the zoom of 1
+inline short zoomLevelFor(float zoomMult)
+{
+    return static_cast<short>(std::lround(std::log(zoomMult) / std::log(c_zoomLevelRatio)));
+}
+
+inline float zoomMultiplierForLevel(short level)
+{
+    return std::pow(c_zoomLevelRatio, static_cast<float>(level));
+}
+
+inline float clampZoomMultiplier(float zoomMult)
+{
+    return std::clamp(zoomMult, c_minZoomMultiplier, c_maxZoomMultiplier);
+}
+
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+
+#include "nodesearchindex.h"
+
+namespace GraphLib {
+
+void NodeSearchIndex::insert(int nodeID, const QString &name, const QString &typeName)
+{
+    remove(nodeID);
+
+    NodeTerms terms{ normalized(name), normalized(typeName) };
+    link(nodeID, terms.name);
+    link(nodeID, terms.typeName);
+    _nodes.insert(nodeID, std::move(terms));
+}
+
+void NodeSearchIndex::rename(int nodeID, const QString &name)
+{
+    auto it = _nodes.find(nodeID);
+    if (it == _nodes.end())
+        return;
+
+    QString term = normalized(name);
+    if (term == it->name)
+        return;
+
+    // the node stays linked to the old name if its type is named the same
+    if (it->name != it->typeName)
+        unlink(nodeID, it->name);
+    link(nodeID, term);
+    it->name = std::move(term);
+}
+
+void NodeSearchIndex::remove(int nodeID)
+{
+    auto it = _nodes.constFind(nodeID);
+    if (it == _nodes.cend())
+        return;
+
+    unlink(nodeID, it->name);
+    if (it->typeName != it->name)
+        unlink(nodeID, it->typeName);
+    _nodes.erase(it);
+}
+
+void NodeSearchIndex::clear()
+{
+    _nodes.clear();
+    _terms.clear();
+    _trigrams.clear();
+}
+
+void NodeSearchIndex::link(int nodeID, const QString &term)
+{
+    if (term.isEmpty())
+        return;
+
+    auto it = _terms.find(term);
+    if (it == _terms.end())
+    {
+        it = _terms.insert(term, Term());
+        std::ranges::for_each(trigrams(term), [&](quint64 trigram) { _trigrams[trigram].insert(term); });
+    }
+    // IDs mostly grow, so the node usually goes to the end
+    auto position = std::ranges::lower_bound(it->nodes, nodeID);
+    if (position == it->nodes.end() || *position != nodeID)
+        it->nodes.insert(position, nodeID);
+}
+
+void NodeSearchIndex::unlink(int nodeID, const QString &term)
+{
+    if (term.isEmpty())
+        return;
+
+    auto it = _terms.find(term);
+    if (it == _terms.end())
+        return;
+
+    auto position = std::ranges::lower_bound(it->nodes, nodeID);
+    if (position != it->nodes.end() && *position == nodeID)
+        it->nodes.erase(position);
+    if (!it->nodes.isEmpty())
+        return;
+
+    std::ranges::for_each(trigrams(term), [&](quint64 trigram) {
+        auto posting = _trigrams.find(trigram);
+        posting->remove(term);
+        if (posting->isEmpty())
+            _trigrams.erase(posting);
+    });
+    _terms.erase(it);
+}
+
+bool NodeSearchIndex::collect(const Term &term, int limit, QVector<int> &out, QSet<int> &found) const
+{
+    for (int nodeID : term.nodes)
+    {
+        if (out.size() >= limit)
+            return false;
+        if (!found.contains(nodeID))
+        {
+            found.insert(nodeID);
+            out.append(nodeID);
+        }
+    }
+    return out.size() < limit;
+}
+
+QSet<quint64> NodeSearchIndex::trigrams(const QString &term)
+{
+    const QString padded = QChar(' ') + term + QChar(' ');
+    QSet<quint64> result;
+    result.reserve(padded.size());
+    for (qsizetype i = 0; i + 2 < padded.size(); i++)
+        result.insert(trigramKey(padded[i], padded[i + 1], padded[i + 2]));
+    return result;
+}
+
+
+// ------------------------- QUERIES -------------------------------
+
+
+QVector<int> NodeSearchIndex::findPrefix(const QString &prefix, int limit) const
+{
+    QVector<int> out;
+    const QString term = normalized(prefix);
+    if (term.isEmpty() || limit <= 0)
+        return out;
+
+    QSet<int> found;
+    // terms starting with the prefix follow each other in the map
+    for (auto it = _terms.lowerBound(term); it != _terms.cend() && it.key().startsWith(term); ++it)
+    {
+        if (!collect(it.value(), limit, out, found))
+            break;
+    }
+    return out;
+}
+
+QVector<int> NodeSearchIndex::findFuzzy(const QString &query, int limit) const
+{
+    QVector<int> out;
+    const QString term = normalized(query);
+    if (term.isEmpty() || limit <= 0)
+        return out;
+
+    const QSet<quint64> queryTrigrams = trigrams(term);
+
+    // candidates come from the rarest trigrams first, common ones would bring most of the terms.
+    // Ties are broken by the trigram, the hashes' order changes from run to run
+    QVector<QPair<quint64, const QSet<QString>*>> postings;
+    std::ranges::for_each(queryTrigrams, [&](quint64 trigram) {
+        auto it = _trigrams.constFind(trigram);
+        if (it != _trigrams.cend())
+            postings.append({ trigram, &it.value() });
+    });
+    std::ranges::sort(postings, [](const QPair<quint64, const QSet<QString>*> &first, const QPair<quint64, const QSet<QString>*> &second) {
+        return first.second->size() != second.second->size() ? first.second->size() < second.second->size()
+                                                              : first.first < second.first;
+    });
+
+    QSet<QString> candidates;
+    for (const auto &[trigram, posting] : postings)
+    {
+        if (!candidates.isEmpty() && candidates.size() + posting->size() > c_searchMaxFuzzyCandidates)
+            break;
+        candidates.unite(*posting);
+    }
+
+    // similarity is the share of the trigrams of both the query and the term they have in common
+    QVector<QPair<float, QString>> scored;
+    std::ranges::for_each(candidates, [&](const QString &candidate) {
+        const QSet<quint64> candidateTrigrams = trigrams(candidate);
+        const qsizetype shared = std::ranges::count_if(candidateTrigrams, [&](quint64 trigram) { return queryTrigrams.contains(trigram); });
+        const float similarity = float(shared) / float(queryTrigrams.size() + candidateTrigrams.size() - shared);
+        if (similarity >= c_searchFuzzyMinSimilarity)
+            scored.append({ similarity, candidate });
+    });
+    std::ranges::sort(scored, [](const QPair<float, QString> &first, const QPair<float, QString> &second) {
+        return first.first != second.first ? first.first > second.first : first.second < second.second;
+    });
+
+    QSet<int> found;
+    for (const auto &[similarity, candidate] : scored)
+    {
+        if (!collect(_terms[candidate], limit, out, found))
+            break;
+    }
+    return out;
+}
+
+QVector<int> NodeSearchIndex::find(const QString &query, int limit) const
+{
+    QVector<int> out = findPrefix(query, limit);
+    if (out.size() >= limit)
+        return out;
+
+    QSet<int> found(out.begin(), out.end());
+    std::ranges::for_each(findFuzzy(query, limit), [&](int nodeID) {
+        if (out.size() < limit && !found.contains(nodeID))
+        {
+            found.insert(nodeID);
+            out.append(nodeID);
+        }
+    });
+    return out;
+}
+
+}
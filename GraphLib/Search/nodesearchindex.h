@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include "constants.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Index of the nodes by their names and type names. Terms are kept case folded in a sorted map,
+// so prefix lookups and updates cost O(log N). Distinct terms are also indexed by their
+// trigrams for fuzzy lookups. Nodes sharing a term share its entries
+class GRAPHLIB_EXPORT NodeSearchIndex
+{
+public:
+    NodeSearchIndex() {}
+
+    // Inserts the node or replaces its terms. The type name is empty for untyped nodes
+    void insert(int nodeID, const QString &name, const QString &typeName = QString());
+    void rename(int nodeID, const QString &name);
+    void remove(int nodeID);
+    void clear();
+
+    bool contains(int nodeID) const { return _nodes.contains(nodeID); }
+    qsizetype size() const { return _nodes.size(); }
+    qsizetype termsCount() const { return _terms.size(); }
+
+    // Nodes with a name or a type name starting with the prefix, in the order of the terms
+    QVector<int> findPrefix(const QString &prefix, int limit = c_searchResultsLimit) const;
+    // Nodes with a term sharing enough trigrams with the query, the most similar first
+    QVector<int> findFuzzy(const QString &query, int limit = c_searchResultsLimit) const;
+    // Prefix matches followed by the fuzzy ones
+    QVector<int> find(const QString &query, int limit = c_searchResultsLimit) const;
+
+    static QString normalized(const QString &text) { return text.trimmed().toCaseFolded(); }
+
+private:
+    struct NodeTerms
+    {
+        QString name, typeName;
+    };
+
+    struct Term
+    {
+        // Sorted, so nodes sharing a term are found in the same order on every run
+        QVector<int> nodes;
+    };
+
+    void link(int nodeID, const QString &term);
+    void unlink(int nodeID, const QString &term);
+    // Appends the term's nodes not yet in the results, returns false once the limit is reached
+    bool collect(const Term &term, int limit, QVector<int> &out, QSet<int> &found) const;
+
+    static quint64 trigramKey(QChar first, QChar second, QChar third)
+    { return (quint64(first.unicode()) << 32) | (quint64(second.unicode()) << 16) | third.unicode(); }
+    // Trigrams of the term padded with a space on both sides, so short terms have some too
+    static QSet<quint64> trigrams(const QString &term);
+
+    QHash<int, NodeTerms> _nodes;
+    QMap<QString, Term> _terms;
+    QHash<quint64, QSet<QString>> _trigrams;
+};
+
+}
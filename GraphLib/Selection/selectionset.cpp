@@ -0,0 +1,90 @@
+#include <algorithm>
+
+#include "selectionset.h"
+
+namespace GraphLib {
+
+SelectionSet::SelectionSet()
+    : _nodes{ QBitArray() }
+    , _selected{ QBitArray() }
+    , _count{ 0 }
+{}
+
+void SelectionSet::addNode(int nodeID)
+{
+    if (nodeID < 0)
+        return;
+
+    // grows by half, so adding nodes one by one doesn't reallocate every time
+    if (nodeID >= _nodes.size())
+    {
+        const qsizetype size = std::max<qsizetype>(nodeID + 1, _nodes.size() + _nodes.size() / 2);
+        _nodes.resize(size);
+        _selected.resize(size);
+    }
+    _nodes.setBit(nodeID);
+}
+
+void SelectionSet::removeNode(int nodeID)
+{
+    if (!exists(nodeID))
+        return;
+
+    deselect(nodeID);
+    _nodes.clearBit(nodeID);
+}
+
+void SelectionSet::clearNodes()
+{
+    _nodes.clear();
+    _selected.clear();
+    _count = 0;
+}
+
+bool SelectionSet::select(int nodeID)
+{
+    if (!exists(nodeID) || _selected.testBit(nodeID))
+        return false;
+
+    _selected.setBit(nodeID);
+    _count++;
+    return true;
+}
+
+bool SelectionSet::deselect(int nodeID)
+{
+    if (!contains(nodeID))
+        return false;
+
+    _selected.clearBit(nodeID);
+    _count--;
+    return true;
+}
+
+void SelectionSet::clear()
+{
+    _selected.fill(false);
+    _count = 0;
+}
+
+void SelectionSet::selectAll()
+{
+    _selected = _nodes;
+    _count = _selected.count(true);
+}
+
+void SelectionSet::invert()
+{
+    _selected ^= _nodes;
+    _count = _selected.count(true);
+}
+
+QVector<int> SelectionSet::ids() const
+{
+    QVector<int> ids;
+    ids.reserve(_count);
+    forEach([&](int nodeID) { ids.append(nodeID); });
+    return ids;
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QBitArray>
+#include <QVector>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Selected nodes as bits indexed by node ID, next to the bits of the nodes that exist.
+// IDs are handed out in increasing order, so both bitsets stay dense, and selecting
+// everything or inverting the selection is a pass over machine words rather than over nodes
+class GRAPHLIB_EXPORT SelectionSet
+{
+public:
+    SelectionSet();
+
+    void addNode(int nodeID);
+    // Deselects the node as well
+    void removeNode(int nodeID);
+    void clearNodes();
+
+    bool contains(int nodeID) const { return nodeID >= 0 && nodeID < _selected.size() && _selected.testBit(nodeID); }
+    qsizetype size() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+
+    // Both return false if nothing has changed. Nodes that don't exist aren't selected
+    bool select(int nodeID);
+    bool deselect(int nodeID);
+    void clear();
+    void selectAll();
+    void invert();
+
+    // Selected IDs in increasing order
+    QVector<int> ids() const;
+    template <typename Function>
+    void forEach(Function function) const;
+    const QBitArray &bits() const { return _selected; }
+
+private:
+    bool exists(int nodeID) const { return nodeID >= 0 && nodeID < _nodes.size() && _nodes.testBit(nodeID); }
+
+    QBitArray _nodes;
+    QBitArray _selected;
+    qsizetype _count;
+};
+
+template <typename Function>
+void SelectionSet::forEach(Function function) const
+{
+    // whole bytes without a selected node are skipped
+    const char *bytes = _selected.bits();
+    const qsizetype byteCount = (_selected.size() + 7) / 8;
+    for (qsizetype byte = 0; byte < byteCount; byte++)
+    {
+        if (!bytes[byte])
+            continue;
+        for (int bit = 0; bit < 8; bit++)
+            if (bytes[byte] & (1 << bit))
+                function(static_cast<int>(byte * 8 + bit));
+    }
+}
+
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cmath>
+
+#include "spatialindex.h"
+
+namespace GraphLib {
+
+SpatialIndex::SpatialIndex(double cellSize)
+    : _cellSize{ cellSize }
+    , _bIsBoundsDirty{ false }
+{}
+
+void SpatialIndex::insert(int id, const QRectF &rect)
+{
+    auto it = _rects.find(id);
+    if (it != _rects.end())
+    {
+        if (it.value() == rect)
+            return;
+        unlink(id, it.value());
+        it.value() = rect;
+    }
+    else
+        _rects.insert(id, rect);
+
+    link(id, rect);
+    _bIsBoundsDirty = true;
+}
+
+void SpatialIndex::remove(int id)
+{
+    auto it = _rects.find(id);
+    if (it == _rects.end())
+        return;
+
+    unlink(id, it.value());
+    _rects.erase(it);
+    _bIsBoundsDirty = true;
+}
+
+void SpatialIndex::clear()
+{
+    _cells.clear();
+    _rects.clear();
+    _oversized.clear();
+    _bounds = QRectF();
+    _bIsBoundsDirty = false;
+}
+
+QRectF SpatialIndex::bounds() const
+{
+    if (_bIsBoundsDirty)
+    {
+        _bounds = QRectF();
+        std::ranges::for_each(_rects, [&](const QRectF &rect) { _bounds = _bounds.isNull() ? rect : _bounds.united(rect); });
+        _bIsBoundsDirty = false;
+    }
+    return _bounds;
+}
+
+QVector<int> SpatialIndex::query(const QRectF &area) const
+{
+    QVector<int> out;
+    query(area, out);
+    return out;
+}
+
+void SpatialIndex::query(const QRectF &area, QVector<int> &out) const
+{
+    out.clear();
+    CellRange range = cellRange(area);
+
+    auto collect = [&](int id) {
+        if (touches(_rects.value(id), area))
+            out.append(id);
+    };
+
+    // a huge area is cheaper to answer by looking at every item once
+    if (range.count() > _rects.size())
+    {
+        for (auto it = _rects.cbegin(); it != _rects.cend(); it++)
+            if (touches(it.value(), area))
+                out.append(it.key());
+    }
+    else
+    {
+        for (int x = range.left; x <= range.right; x++)
+        {
+            for (int y = range.top; y <= range.bottom; y++)
+            {
+                auto it = _cells.constFind(cellKey(x, y));
+                if (it != _cells.cend())
+                    std::ranges::for_each(it.value(), collect);
+            }
+        }
+        std::ranges::for_each(_oversized, collect);
+    }
+
+    // an item spanning several cells is found once per cell
+    std::ranges::sort(out);
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void SpatialIndex::queryDifference(const QRectF &from, const QRectF &to, QVector<int> &entered, QVector<int> &left) const
+{
+    entered.clear();
+    left.clear();
+    collectOutside(to, from, entered);
+    collectOutside(from, to, left);
+
+    std::ranges::sort(entered);
+    entered.erase(std::unique(entered.begin(), entered.end()), entered.end());
+    std::ranges::sort(left);
+    left.erase(std::unique(left.begin(), left.end()), left.end());
+}
+
+void SpatialIndex::collectOutside(const QRectF &area, const QRectF &excluded, QVector<int> &out) const
+{
+    // items outside the excluded rect touch at least one of the strips of the area around it,
+    // strips of zero height or width only find items the other strips find as well
+    QVector<QRectF> strips;
+    const QRectF overlap = area & excluded;
+    if (!touches(area, excluded) || overlap.isEmpty())
+        strips.append(area);
+    else
+    {
+        strips.append(QRectF(QPointF(area.left(), area.top()), QPointF(area.right(), overlap.top())));
+        strips.append(QRectF(QPointF(area.left(), overlap.bottom()), QPointF(area.right(), area.bottom())));
+        strips.append(QRectF(QPointF(area.left(), overlap.top()), QPointF(overlap.left(), overlap.bottom())));
+        strips.append(QRectF(QPointF(overlap.right(), overlap.top()), QPointF(area.right(), overlap.bottom())));
+    }
+
+    QVector<int> found;
+    std::ranges::for_each(strips, [&](const QRectF &strip) {
+        query(strip, found);
+        std::ranges::for_each(found, [&](int id) {
+            if (!touches(_rects.value(id), excluded))
+                out.append(id);
+        });
+    });
+}
+
+SpatialIndex::CellRange SpatialIndex::cellRange(const QRectF &rect) const
+{
+    auto cell = [&](double coordinate) {
+        return static_cast<int>(std::clamp(std::floor(coordinate / _cellSize), -1e9, 1e9));
+    };
+    return { cell(rect.left()), cell(rect.top()), cell(rect.right()), cell(rect.bottom()) };
+}
+
+void SpatialIndex::link(int id, const QRectF &rect)
+{
+    CellRange range = cellRange(rect);
+    if (range.count() > c_spatialIndexMaxCellsPerItem)
+    {
+        _oversized.append(id);
+        return;
+    }
+
+    for (int x = range.left; x <= range.right; x++)
+        for (int y = range.top; y <= range.bottom; y++)
+            _cells[cellKey(x, y)].append(id);
+}
+
+void SpatialIndex::unlink(int id, const QRectF &rect)
+{
+    CellRange range = cellRange(rect);
+    if (range.count() > c_spatialIndexMaxCellsPerItem)
+    {
+        _oversized.removeOne(id);
+        return;
+    }
+
+    for (int x = range.left; x <= range.right; x++)
+    {
+        for (int y = range.top; y <= range.bottom; y++)
+        {
+            auto it = _cells.find(cellKey(x, y));
+            if (it == _cells.end())
+                continue;
+            it.value().removeOne(id);
+            if (it.value().isEmpty())
+                _cells.erase(it);
+        }
+    }
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+#include "constants.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Uniform grid over canvas coordinates. Every item is an ID with a bounding rect
+// and is registered in each cell its rect touches. Items spanning too many cells
+// are kept aside and checked by every query instead
+class GRAPHLIB_EXPORT SpatialIndex
+{
+public:
+    explicit SpatialIndex(double cellSize = c_spatialIndexCellSize);
+
+    // Inserts the item or moves it if it's already there
+    void insert(int id, const QRectF &rect);
+    void remove(int id);
+    void clear();
+
+    bool contains(int id) const { return _rects.contains(id); }
+    QRectF rect(int id) const { return _rects.value(id); }
+    qsizetype size() const { return _rects.size(); }
+    double cellSize() const { return _cellSize; }
+    // Bounding rect of all items
+    QRectF bounds() const;
+
+    // Items whose rects touch the area, sorted by ID
+    QVector<int> query(const QRectF &area) const;
+    void query(const QRectF &area, QVector<int> &out) const;
+    // Items touching the new area but not the old one and the other way around, both sorted by ID.
+    // Only the parts of the areas outside each other are searched, so moving an area's
+    // edge costs as much as the items the edge passes over
+    void queryDifference(const QRectF &from, const QRectF &to, QVector<int> &entered, QVector<int> &left) const;
+
+    // Rects touching each other's border are considered intersecting
+    static bool touches(const QRectF &first, const QRectF &second)
+    {
+        return first.left() <= second.right() && second.left() <= first.right()
+            && first.top() <= second.bottom() && second.top() <= first.bottom();
+    }
+
+private:
+    struct CellRange
+    {
+        int left, top, right, bottom;
+
+        qint64 count() const { return qint64(right - left + 1) * (bottom - top + 1); }
+    };
+
+    CellRange cellRange(const QRectF &rect) const;
+    // Items touching the area but not the excluded one, appended in any order
+    void collectOutside(const QRectF &area, const QRectF &excluded, QVector<int> &out) const;
+    static quint64 cellKey(int x, int y) { return (quint64(quint32(x)) << 32) | quint32(y); }
+
+    void link(int id, const QRectF &rect);
+    void unlink(int id, const QRectF &rect);
+
+    double _cellSize;
+    QHash<quint64, QVector<int>> _cells;
+    QHash<int, QRectF> _rects;
+    QVector<int> _oversized;
+
+    mutable QRectF _bounds;
+    mutable bool _bIsBoundsDirty;
+};
+
+}
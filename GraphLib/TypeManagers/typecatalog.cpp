@@ -0,0 +1,237 @@
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+
+#include "typecatalog.h"
+
+namespace GraphLib {
+
+namespace {
+
+// Walks the JSON text without building values, every step returns false on broken input
+class CatalogScanner
+{
+public:
+    explicit CatalogScanner(const QByteArray &data) : _data{ data }, _pos{ 0 } {}
+
+    qsizetype position() const { return _pos; }
+
+    bool atEnd()
+    {
+        skipWhitespace();
+        return _pos >= _data.size();
+    }
+
+    char peek()
+    {
+        skipWhitespace();
+        return _pos < _data.size() ? _data[_pos] : '\0';
+    }
+
+    bool expect(char c)
+    {
+        if (peek() != c)
+            return false;
+        _pos++;
+        return true;
+    }
+
+    // Reads a string's raw bytes with the quotes, decoding it only when it has escapes
+    bool readString(QString *out)
+    {
+        if (peek() != '"')
+            return false;
+
+        const qsizetype begin = _pos++;
+        bool bHasEscapes = false;
+        while (_pos < _data.size() && _data[_pos] != '"')
+        {
+            if (_data[_pos] == '\\')
+            {
+                bHasEscapes = true;
+                _pos++;
+            }
+            _pos++;
+        }
+        if (_pos >= _data.size())
+            return false;
+        _pos++;
+
+        if (!out)
+            return true;
+
+        const QByteArrayView raw(_data.constData() + begin, _pos - begin);
+        if (!bHasEscapes)
+            *out = QString::fromUtf8(raw.sliced(1, raw.size() - 2));
+        else
+            *out = QJsonDocument::fromJson('[' + raw.toByteArray() + ']').array().at(0).toString();
+        return true;
+    }
+
+    // Skips any value, nested objects and arrays are skipped by counting brackets
+    bool skipValue()
+    {
+        const char c = peek();
+        if (c == '"')
+            return readString(nullptr);
+
+        if (c != '{' && c != '[')
+        {
+            // numbers and literals end at a delimiter
+            const qsizetype begin = _pos;
+            while (_pos < _data.size() && !isDelimiter(_data[_pos]))
+                _pos++;
+            return _pos > begin;
+        }
+
+        int depth = 0;
+        while (_pos < _data.size())
+        {
+            const char current = _data[_pos];
+            if (current == '"')
+            {
+                if (!readString(nullptr))
+                    return false;
+                continue;
+            }
+
+            _pos++;
+            if (current == '{' || current == '[')
+                depth++;
+            else if ((current == '}' || current == ']') && --depth == 0)
+                return true;
+        }
+        return false;
+    }
+
+private:
+    void skipWhitespace()
+    {
+        while (_pos < _data.size() && (_data[_pos] == ' ' || _data[_pos] == '\n' || _data[_pos] == '\r' || _data[_pos] == '\t'))
+            _pos++;
+    }
+
+    static bool isDelimiter(char c) { return c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+    const QByteArray &_data;
+    qsizetype _pos;
+};
+
+// Reads the type's object picking its name and category, the scanner ends up after it
+bool scanType(CatalogScanner &scanner, const QByteArray &data, CatalogType &type)
+{
+    // the object starts after the whitespace before it
+    scanner.peek();
+    const qsizetype begin = scanner.position();
+    if (!scanner.expect('{'))
+        return false;
+
+    if (!scanner.expect('}'))
+    {
+        do
+        {
+            QString key;
+            if (!scanner.readString(&key) || !scanner.expect(':'))
+                return false;
+
+            bool bIsRead = false;
+            if (scanner.peek() == '"')
+            {
+                if (key == "name")
+                    bIsRead = scanner.readString(&type.name);
+                else if (key == "category")
+                    bIsRead = scanner.readString(&type.category);
+            }
+            if (!bIsRead && !scanner.skipValue())
+                return false;
+        } while (scanner.expect(','));
+
+        if (!scanner.expect('}'))
+            return false;
+    }
+
+    type.json = data.sliced(begin, scanner.position() - begin);
+    return true;
+}
+
+}
+
+std::optional<QVector<CatalogType>> scanTypeCatalog(const QByteArray &data)
+{
+    CatalogScanner scanner(data);
+    QVector<CatalogType> types;
+
+    if (!scanner.expect('{'))
+        return std::nullopt;
+
+    if (!scanner.expect('}'))
+    {
+        do
+        {
+            QString key;
+            if (!scanner.readString(&key) || !scanner.expect(':'))
+                return std::nullopt;
+
+            if (key != "types" || scanner.peek() != '[')
+            {
+                if (!scanner.skipValue())
+                    return std::nullopt;
+                continue;
+            }
+
+            scanner.expect('[');
+            if (scanner.expect(']'))
+                continue;
+
+            do
+            {
+                CatalogType type;
+                if (scanner.peek() != '{')
+                {
+                    if (!scanner.skipValue())
+                        return std::nullopt;
+                    continue;
+                }
+                if (!scanType(scanner, data, type))
+                    return std::nullopt;
+                types.append(std::move(type));
+            } while (scanner.expect(','));
+
+            if (!scanner.expect(']'))
+                return std::nullopt;
+        } while (scanner.expect(','));
+
+        if (!scanner.expect('}'))
+            return std::nullopt;
+    }
+
+    if (!scanner.atEnd())
+        return std::nullopt;
+    return types;
+}
+
+std::optional<QVector<CatalogType>> scanTypeCatalogFile(const QString &file)
+{
+    QFile inFile(file);
+    if (!inFile.open(QIODevice::ReadOnly))
+        return std::nullopt;
+
+    return scanTypeCatalog(inFile.readAll());
+}
+
+QStringList typeCatalogFiles(const QString &path)
+{
+    const QFileInfo info(path);
+    if (!info.isDir())
+        return info.exists() ? QStringList{ info.filePath() } : QStringList();
+
+    QStringList files;
+    const QFileInfoList entries = QDir(path).entryInfoList({ "*.json" }, QDir::Files | QDir::Readable, QDir::Name);
+    std::ranges::for_each(entries, [&](const QFileInfo &entry) { files.append(entry.filePath()); });
+    return files;
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+#include <optional>
+
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// A type found in a catalog file, its JSON is kept as it is and parsed on first use
+struct CatalogType
+{
+    QString name, category;
+    QByteArray json;
+    // The memory-mapped cache the JSON points into, if it was loaded from one
+    std::shared_ptr<QFile> mapping = {};
+};
+
+// Finds the objects of the "types" array of a catalog and reads only their "name" and
+// "category" on the way, no JSON values are built. Returns nothing if the structure is broken
+std::optional<QVector<CatalogType>> GRAPHLIB_EXPORT scanTypeCatalog(const QByteArray &data);
+std::optional<QVector<CatalogType>> GRAPHLIB_EXPORT scanTypeCatalogFile(const QString &file);
+
+// The file itself or the .json files of the directory sorted by name
+QStringList GRAPHLIB_EXPORT typeCatalogFiles(const QString &path);
+
+}
@@ -0,0 +1,208 @@
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "typecatalogcache.h"
+
+namespace GraphLib {
+
+namespace {
+
+// Header: magic, version, reserved, types count, size and modification time of the source and
+// the SHA-1 of its content. Then a table of offset and size pairs of every type's name, category
+// and JSON, then the bytes they point to. Numbers are little-endian, so a cache is valid on any machine
+const quint32 c_catalogCacheMagic = 0x43544C47; // "GLTC"
+const quint16 c_catalogCacheVersion = 2;
+const qsizetype c_catalogCacheStampOffset = 12;
+const qsizetype c_catalogCacheHashOffset = c_catalogCacheStampOffset + 2 * sizeof(qint64);
+const qsizetype c_catalogCacheHashSize = 20;
+const qsizetype c_catalogCacheHeaderSize = c_catalogCacheHashOffset + c_catalogCacheHashSize;
+const qsizetype c_catalogCacheFieldsCount = 3;
+const qsizetype c_catalogCacheEntrySize = c_catalogCacheFieldsCount * 2 * sizeof(quint32);
+
+bool isCurrentImage(const QByteArray &image)
+{
+    return image.size() >= c_catalogCacheHeaderSize
+        && qFromLittleEndian<quint32>(image.constData()) == c_catalogCacheMagic
+        && qFromLittleEndian<quint16>(image.constData() + 4) == c_catalogCacheVersion;
+}
+
+// Field of an entry, nothing if it's out of the image
+std::optional<QByteArrayView> readField(const QByteArray &image, qsizetype entry, qsizetype field)
+{
+    const char *position = image.constData() + entry + field * 2 * sizeof(quint32);
+    const quint64 offset = qFromLittleEndian<quint32>(position);
+    const quint64 size = qFromLittleEndian<quint32>(position + sizeof(quint32));
+    const quint64 imageSize = static_cast<quint64>(image.size());
+    if (offset > imageSize || size > imageSize - offset)
+        return std::nullopt;
+    return QByteArrayView(image.constData() + offset, static_cast<qsizetype>(size));
+}
+
+}
+
+CatalogStamp CatalogStamp::of(const QString &file)
+{
+    const QFileInfo info(file);
+    if (!info.exists())
+        return CatalogStamp();
+    return CatalogStamp{ info.size(), info.lastModified().toMSecsSinceEpoch() };
+}
+
+QString TypeCatalogCache::cacheFile(const QString &file) const
+{
+    const QByteArray pathHash = QCryptographicHash::hash(QFileInfo(file).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1);
+    return QDir(_directory).filePath(QString::fromLatin1(pathHash.toHex()) + ".typecache");
+}
+
+QByteArray TypeCatalogCache::contentHash(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+QByteArray TypeCatalogCache::compile(const QVector<CatalogType> &types, const QByteArray &contentHash, CatalogStamp stamp)
+{
+    if (contentHash.size() != c_catalogCacheHashSize)
+        return QByteArray();
+
+    const qsizetype tableEnd = c_catalogCacheHeaderSize + types.size() * c_catalogCacheEntrySize;
+    QByteArray image(tableEnd, '\0');
+    qToLittleEndian<quint32>(c_catalogCacheMagic, image.data());
+    qToLittleEndian<quint16>(c_catalogCacheVersion, image.data() + 4);
+    qToLittleEndian<quint32>(static_cast<quint32>(types.size()), image.data() + 8);
+    qToLittleEndian<qint64>(stamp.size, image.data() + c_catalogCacheStampOffset);
+    qToLittleEndian<qint64>(stamp.modifiedMs, image.data() + c_catalogCacheStampOffset + sizeof(qint64));
+    image.replace(c_catalogCacheHashOffset, c_catalogCacheHashSize, contentHash);
+
+    QVector<quint32> table;
+    table.reserve(types.size() * c_catalogCacheFieldsCount * 2);
+    auto append = [&](QByteArrayView bytes) {
+        table.append(static_cast<quint32>(image.size()));
+        table.append(static_cast<quint32>(bytes.size()));
+        image.append(bytes);
+    };
+    std::ranges::for_each(types, [&](const CatalogType &type) {
+        append(type.name.toUtf8());
+        append(type.category.toUtf8());
+        append(type.json);
+    });
+
+    // offsets are 32-bit
+    if (static_cast<quint64>(image.size()) > std::numeric_limits<quint32>::max())
+        return QByteArray();
+
+    for (qsizetype i = 0; i < table.size(); i++)
+        qToLittleEndian<quint32>(table[i], image.data() + c_catalogCacheHeaderSize + i * sizeof(quint32));
+    return image;
+}
+
+std::optional<QVector<CatalogType>> TypeCatalogCache::read(const QByteArray &image, const QByteArray &contentHash)
+{
+    if (!isCurrentImage(image) || contentHash.size() != c_catalogCacheHashSize
+        || QByteArrayView(image.constData() + c_catalogCacheHashOffset, c_catalogCacheHashSize) != QByteArrayView(contentHash))
+        return std::nullopt;
+    return readTypes(image);
+}
+
+std::optional<QVector<CatalogType>> TypeCatalogCache::read(const QByteArray &image, CatalogStamp stamp)
+{
+    if (!stamp.isValid() || !isCurrentImage(image)
+        || qFromLittleEndian<qint64>(image.constData() + c_catalogCacheStampOffset) != stamp.size
+        || qFromLittleEndian<qint64>(image.constData() + c_catalogCacheStampOffset + sizeof(qint64)) != stamp.modifiedMs)
+        return std::nullopt;
+    return readTypes(image);
+}
+
+std::optional<QVector<CatalogType>> TypeCatalogCache::readTypes(const QByteArray &image)
+{
+    const quint32 count = qFromLittleEndian<quint32>(image.constData() + 8);
+    if ((image.size() - c_catalogCacheHeaderSize) / c_catalogCacheEntrySize < count)
+        return std::nullopt;
+
+    QVector<CatalogType> types(count);
+    for (quint32 i = 0; i < count; i++)
+    {
+        const qsizetype entry = c_catalogCacheHeaderSize + i * c_catalogCacheEntrySize;
+        const std::optional<QByteArrayView> name = readField(image, entry, 0);
+        const std::optional<QByteArrayView> category = readField(image, entry, 1);
+        const std::optional<QByteArrayView> json = readField(image, entry, 2);
+        if (!name || !category || !json)
+            return std::nullopt;
+
+        // names are kept longer than the image, the JSON only until the type is parsed
+        types[i].name = QString::fromUtf8(*name);
+        types[i].category = QString::fromUtf8(*category);
+        types[i].json = QByteArray::fromRawData(json->data(), json->size());
+    }
+    return types;
+}
+
+void TypeCatalogCache::write(const QString &path, const QByteArray &image) const
+{
+    // a cache that can't be written only costs the next load a scan
+    QSaveFile output(path);
+    if (!image.isEmpty() && QDir().mkpath(_directory) && output.open(QIODevice::WriteOnly)
+        && output.write(image) == image.size())
+        output.commit();
+}
+
+std::optional<QVector<CatalogType>> TypeCatalogCache::load(const QString &file) const
+{
+    if (!isEnabled())
+        return scanTypeCatalogFile(file);
+
+    // taken before the content is read, so a file edited meanwhile doesn't pass for the read one
+    const CatalogStamp stamp = CatalogStamp::of(file);
+
+    const QString path = cacheFile(file);
+    auto cache = std::make_shared<QFile>(path);
+    const qint64 cacheSize = cache->open(QIODevice::ReadOnly) ? cache->size() : 0;
+    const uchar *cacheMap = cacheSize > 0 ? cache->map(0, cacheSize) : nullptr;
+    const QByteArray image = cacheMap ? QByteArray::fromRawData(reinterpret_cast<const char *>(cacheMap), cacheSize)
+                                      : QByteArray();
+    auto mapped = [&](QVector<CatalogType> &types) {
+        std::ranges::for_each(types, [&](CatalogType &type) { type.mapping = cache; });
+    };
+
+    // the source isn't even opened while its stamp is the one the cache was compiled for
+    std::optional<QVector<CatalogType>> types = read(image, stamp);
+    if (types)
+    {
+        mapped(*types);
+        return types;
+    }
+
+    QFile source(file);
+    if (!source.open(QIODevice::ReadOnly))
+        return std::nullopt;
+
+    // with an up to date cache the source is only hashed, so it's mapped rather than read
+    const qint64 sourceSize = source.size();
+    const uchar *sourceMap = sourceSize > 0 ? source.map(0, sourceSize) : nullptr;
+    const QByteArray data = sourceMap ? QByteArray::fromRawData(reinterpret_cast<const char *>(sourceMap), sourceSize)
+                                      : source.readAll();
+    const QByteArray hash = contentHash(data);
+
+    // e.g. a file that was touched or copied, its cache gets the new stamp
+    types = read(image, hash);
+    if (types)
+    {
+        write(path, compile(*types, hash, stamp));
+        mapped(*types);
+        return types;
+    }
+
+    // the scanned types own copies of their JSON, so the source can be unmapped
+    types = scanTypeCatalog(data);
+    if (types)
+        write(path, compile(*types, hash, stamp));
+    return types;
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <optional>
+
+#include "typecatalog.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Size and modification time of a catalog file
+struct GRAPHLIB_EXPORT CatalogStamp
+{
+    qint64 size = -1;
+    qint64 modifiedMs = -1;
+
+    bool isValid() const { return size >= 0 && modifiedMs >= 0; }
+    static CatalogStamp of(const QString &file);
+};
+
+// Compiled catalogs kept between runs. A catalog file's cache has the file's types with their names,
+// categories and JSON at fixed offsets, so it's memory-mapped and the types point into it instead of
+// the file being scanned again. A cache of a file with the stamp it was compiled for is used without
+// reading the file. Otherwise it's used while the content hash of the file matches the one it was
+// compiled from, and the file is scanned and its cache written again once it doesn't
+class GRAPHLIB_EXPORT TypeCatalogCache
+{
+public:
+    // Nothing is cached with an empty directory
+    explicit TypeCatalogCache(const QString &directory = QString()) : _directory{ directory } {}
+
+    const QString &directory() const { return _directory; }
+    bool isEnabled() const { return !_directory.isEmpty(); }
+
+    // The file's types, from its cache if there's one for the file's content
+    std::optional<QVector<CatalogType>> load(const QString &file) const;
+    // Where the cache of the file is kept, there's one for every catalog file
+    QString cacheFile(const QString &file) const;
+
+    static QByteArray contentHash(const QByteArray &data);
+    static QByteArray compile(const QVector<CatalogType> &types, const QByteArray &contentHash,
+                              CatalogStamp stamp = CatalogStamp());
+    // The types' JSON point into the image. Returns nothing if the image is malformed,
+    // of another version or compiled from other content
+    static std::optional<QVector<CatalogType>> read(const QByteArray &image, const QByteArray &contentHash);
+    // Same for a file with the stamp, nothing for an invalid stamp
+    static std::optional<QVector<CatalogType>> read(const QByteArray &image, CatalogStamp stamp);
+
+private:
+    static std::optional<QVector<CatalogType>> readTypes(const QByteArray &image);
+    void write(const QString &path, const QByteArray &image) const;
+
+    QString _directory;
+};
+
+}
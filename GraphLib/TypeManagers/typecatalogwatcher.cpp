@@ -0,0 +1,95 @@
+#include <QtConcurrent/QtConcurrent>
+#include <QFileInfo>
+#include <QTimer>
+#include <algorithm>
+
+#include "typecatalogwatcher.h"
+#include "constants.h"
+
+namespace GraphLib {
+
+TypeCatalogWatcher::TypeCatalogWatcher(TypeManager *manager, QObject *parent)
+    : QObject{ parent }
+    , _manager{ manager }
+    , _fileWatcher{ QFileSystemWatcher() }
+    , _pending{ QList<QFuture<QVector<CatalogType>>>() }
+{
+    connect(&_fileWatcher, &QFileSystemWatcher::fileChanged, this, &TypeCatalogWatcher::onFileChanged);
+    connect(&_fileWatcher, &QFileSystemWatcher::directoryChanged, this, &TypeCatalogWatcher::onDirectoryChanged);
+}
+
+void TypeCatalogWatcher::load(const QString &path)
+{
+    if (QFileInfo(path).isDir())
+        _fileWatcher.addPath(path);
+    scan(typeCatalogFiles(path));
+}
+
+void TypeCatalogWatcher::scan(const QStringList &files)
+{
+    if (files.isEmpty())
+        return;
+
+    _fileWatcher.addPaths(files);
+
+    QFuture<QVector<CatalogType>> future = QtConcurrent::run([files, cache = _manager->catalogCache()]() {
+        QVector<CatalogType> types;
+        std::ranges::for_each(files, [&](const QString &file) {
+            // a broken file is skipped, it's loaded again once it's fixed
+            if (std::optional<QVector<CatalogType>> scanned = cache.load(file))
+                types.append(std::move(*scanned));
+        });
+        return types;
+    });
+    _pending.append(future);
+
+    auto *watcher = new QFutureWatcher<QVector<CatalogType>>(this);
+    connect(watcher, &QFutureWatcher<QVector<CatalogType>>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        mergeFinished();
+    });
+    watcher->setFuture(future);
+}
+
+void TypeCatalogWatcher::mergeFinished()
+{
+    QVector<int> changed;
+    while (!_pending.isEmpty() && _pending.first().isFinished())
+        changed.append(_manager->mergeTypes(_pending.takeFirst().result()));
+
+    if (!changed.isEmpty())
+        onTypesChanged(changed);
+}
+
+void TypeCatalogWatcher::waitForFinished()
+{
+    std::ranges::for_each(_pending, [](QFuture<QVector<CatalogType>> &future) { future.waitForFinished(); });
+    mergeFinished();
+}
+
+void TypeCatalogWatcher::onFileChanged(const QString &file)
+{
+    // editors often replace the file, which drops it from the watcher until it's scanned again
+    if (QFileInfo::exists(file))
+    {
+        scan({ file });
+        return;
+    }
+    QTimer::singleShot(c_typeCatalogRetryMs, this, [this, file]() {
+        if (QFileInfo::exists(file))
+            scan({ file });
+    });
+}
+
+void TypeCatalogWatcher::onDirectoryChanged(const QString &directory)
+{
+    const QStringList watched = _fileWatcher.files();
+    QStringList added;
+    std::ranges::for_each(typeCatalogFiles(directory), [&](const QString &file) {
+        if (!watched.contains(file))
+            added.append(file);
+    });
+    scan(added);
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+#include "typemanager.h"
+#include "GraphLib_global.h"
+
+namespace GraphLib {
+
+// Loads catalogs into a type manager without blocking the GUI thread and keeps them up to date.
+// Files are scanned, or read from the manager's catalog cache, on worker threads, the types are
+// merged into the manager on the watcher's thread in the order the loads were started. Changed
+// files are merged again, new .json files in watched directories are loaded
+class GRAPHLIB_EXPORT TypeCatalogWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TypeCatalogWatcher(TypeManager *manager, QObject *parent = nullptr);
+
+    // A catalog file or a directory of them
+    void load(const QString &path);
+    bool isLoading() const { return !_pending.isEmpty(); }
+    // Blocks until every started load is merged, e.g. when the types are needed right away
+    void waitForFinished();
+
+signals:
+    // IDs of the added and the replaced types
+    void onTypesChanged(const QVector<int> &typeIDs);
+
+private slots:
+    void onFileChanged(const QString &file);
+    void onDirectoryChanged(const QString &directory);
+
+private:
+    void scan(const QStringList &files);
+    // Merges the finished loads from the oldest one, a load finished early waits for the ones before it
+    void mergeFinished();
+
+    TypeManager *_manager;
+    QFileSystemWatcher _fileWatcher;
+    QList<QFuture<QVector<CatalogType>>> _pending;
+};
+
+}
@@ -0,0 +1,82 @@
+#include <QJsonDocument>
+#include <algorithm>
+
+#include "typemanager.h"
+
+namespace GraphLib {
+
+const QVector<QJsonObject> &TypeManager::Types() const
+{
+    for (int id = 0; id < _names.size(); id++)
+        type(id);
+    return _types;
+}
+
+QJsonObject TypeManager::type(int id) const
+{
+    if (id < 0 || id >= _names.size())
+        return QJsonObject();
+
+    if (!_parsed.testBit(id))
+    {
+        _types[id] = QJsonDocument::fromJson(_sources[id]).object();
+        _sources[id] = QByteArray();
+        _mappings[id].reset();
+        _parsed.setBit(id);
+    }
+    return _types[id];
+}
+
+QVector<int> TypeManager::mergeTypes(const QVector<CatalogType> &types)
+{
+    QVector<int> merged;
+    merged.reserve(types.size());
+
+    std::ranges::for_each(types, [&](const CatalogType &type) {
+        auto it = _typeNames.constFind(type.name);
+        int id = 0;
+        if (it == _typeNames.cend())
+        {
+            id = static_cast<int>(_names.size());
+            _typeNames.insert(type.name, id);
+            _names.append(type.name);
+            _categories.append(type.category);
+            _types.append(QJsonObject());
+            _sources.append(type.json);
+            _mappings.append(type.mapping);
+        }
+        else
+        {
+            id = it.value();
+            _categories[id] = type.category;
+            _types[id] = QJsonObject();
+            _sources[id] = type.json;
+            _mappings[id] = type.mapping;
+        }
+        merged.append(id);
+    });
+
+    // the new types are unparsed as well as the replaced ones
+    _parsed.resize(_names.size());
+    std::ranges::for_each(merged, [&](int id) { _parsed.clearBit(id); });
+    return merged;
+}
+
+bool TypeManager::loadCatalog(const QString &path)
+{
+    const QStringList files = typeCatalogFiles(path);
+    if (files.isEmpty())
+        return false;
+
+    bool bAreAllLoaded = true;
+    std::ranges::for_each(files, [&](const QString &file) {
+        std::optional<QVector<CatalogType>> types = _catalogCache.load(file);
+        if (types)
+            mergeTypes(*types);
+        else
+            bAreAllLoaded = false;
+    });
+    return bAreAllLoaded;
+}
+
+}
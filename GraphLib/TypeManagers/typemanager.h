@@ -1,25 +1,60 @@
 #pragma once
 
+#include <QBitArray>
+#include <QByteArray>
 #include <QJsonObject>
 #include <QMap>
+#include <QVector>
+#include <memory>
+
+#include "typecatalog.h"
+#include "typecatalogcache.h"
+#include "GraphLib_global.h"
 
 namespace GraphLib {
 
-class TypeManager
+// Types of a catalog by their IDs. Loading only finds the types with their names and categories,
+// a type's JSON is parsed the first time the type is asked for. Types are merged by name:
+// a loaded type replaces the one with its name under the same ID, new ones get the next IDs.
+// Types are parsed from const methods, so the manager is meant to be used from one thread
+class GRAPHLIB_EXPORT TypeManager
 {
 public:
     TypeManager() {}
+    virtual ~TypeManager() {}
 
-    const QVector<QJsonObject> &Types() const { return _types; }
+    // Parses every type that hasn't been yet, type() parses only the one asked for
+    const QVector<QJsonObject> &Types() const;
     const QMap<QString, int> &TypeNames() const { return _typeNames; }
+    qsizetype typesCount() const { return _names.size(); }
+    // The getters return empty values for unknown IDs, e.g. while another catalog is still loading
+    QJsonObject type(int id) const;
 
-    inline QString typeNameByID(int id) const { return Types()[id].value("name").toString(); }
+    inline QString typeNameByID(int id) const { return _names.value(id); }
+    // Empty if the type has none
+    QString typeCategory(int id) const { return _categories.value(id); }
 
+    // A catalog file or every .json file of a directory, added to the types loaded before
     virtual bool loadTypes(const char *file) = 0;
+    // Returns IDs of the added and the replaced types
+    QVector<int> mergeTypes(const QVector<CatalogType> &types);
+
+    // Catalogs loaded afterwards are read from and compiled to the cache, there's none by default
+    void setCatalogCache(const TypeCatalogCache &cache) { _catalogCache = cache; }
+    const TypeCatalogCache &catalogCache() const { return _catalogCache; }
 
 protected:
-    QVector<QJsonObject> _types = {};
+    bool loadCatalog(const QString &path);
+
+    mutable QVector<QJsonObject> _types = {};
     QMap<QString, int> _typeNames = {};
+    QVector<QString> _names = {};
+    QVector<QString> _categories = {};
+    // JSON of the types, dropped once parsed, with the mapped caches some of them point into
+    mutable QVector<QByteArray> _sources = {};
+    mutable QVector<std::shared_ptr<QFile>> _mappings = {};
+    mutable QBitArray _parsed = {};
+    TypeCatalogCache _catalogCache = TypeCatalogCache();
 
 };
 
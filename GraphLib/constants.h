@@ -2,6 +2,7 @@
 
 #include <QColor>
 #include <QSize>
+#include <cstddef>
 
 #include "GraphLib_global.h"
 
@@ -12,9 +13,14 @@ namespace GraphLib {
 
 const float c_globalOutlineWidth = 2.0f;
 
+// Render detail tiers, see RenderDetail.
 // If canvas' zoom multiplier less or equal than this constant
 // the render will be simplified
 const float c_changeRenderZoomMultiplier = 0.4f;
+// At or below this zoom the canvas draws nodes and edges itself in batches
+const float c_overviewZoomMultiplier = 0.2f;
+// At or below this zoom text is drawn from cached glyph runs
+const float c_cachedTextZoomMultiplier = 0.8f;
 
 // COMMON GENERAL CONSTANTS
 
@@ -27,12 +33,110 @@ const Qt::KeyboardModifier c_multiSelectionModifier = Qt::ShiftModifier;
 
 const float c_percentOfCanvasSizeToConsiderNearEdge = 0.14f;
 
-// This is the offset to use with zoomMult=1 to move canvas when the
-// cursor is near edge of the canvas during pin drag
-const float c_standardPinDragEdgeCanvasMoveValue = 50.0f;
+// Speed in pixels per second the canvas moves at when the cursor is
+// at the very edge of the canvas during pin drag, 50 pixels every 30 ms
+const float c_pinDragEdgeCanvasMoveSpeed = 50.0f / 0.030f;
+
+// Zoom multiplier limits, the zoom is continuous in between
+const float c_minZoomMultiplier = 0.1f;
+const float c_maxZoomMultiplier = 2.0f;
+// Ratio between neighbouring zoom levels, see zoomLevelFor
+const float c_zoomLevelRatio = 1.1f;
+// Zoom change per wheel step
+const float c_zoomStepRatio = 1.2f;
+const int c_zoomAnimationDurationMs = 150;
+// Render caches are kept for this many levels on each side of the current one
+const int c_zoomCachedLevels = 2;
+// Levels whose fonts and text metrics are prepared ahead in the zoom direction
+const int c_zoomPrefetchedLevels = 2;
+
+// Canvas updates at most once per this interval, input arriving in between is merged
+const int c_frameIntervalMs = 16;
+// Kinetic panning slows down by exp(-friction * seconds) and stops below the minimal speed in pixels per second
+const float c_kineticPanFriction = 5.0f;
+const float c_kineticPanMinSpeed = 20.0f;
+// Weight of the newest movement in the tracked velocity
+const float c_kineticPanVelocitySmoothing = 0.6f;
+// Pans released longer than this after the last movement don't keep moving
+const int c_kineticPanReleaseWindowMs = 60;
+
+// Shows and hides the frame profiler overlay
+const Qt::Key c_profilerOverlayToggleKey = Qt::Key_F3;
+// Inverts the selection together with Ctrl, Ctrl+A selects every node
+const Qt::Key c_invertSelectionKey = Qt::Key_I;
+// Collapses the selection into a group together with Ctrl, Ctrl+Shift expands the selected groups
+const Qt::Key c_groupKey = Qt::Key_G;
+
+// Memory the undo history may take before the oldest commands are dropped
+const qsizetype c_commandJournalMemoryCapBytes = 32 * 1024 * 1024;
+
+const int c_layoutAnimationDurationMs = 400;
+
+// Cells of the spatial index are squares of this size in canvas coordinates
+const double c_spatialIndexCellSize = 256.0;
+// Items covering more cells than this are checked by every query instead
+const int c_spatialIndexMaxCellsPerItem = 1024;
+
+// SEARCH CONSTANTS
+
+// Nodes returned by a search at most
+const int c_searchResultsLimit = 50;
+// Share of trigrams a term has to have in common with the query to be a fuzzy match
+const float c_searchFuzzyMinSimilarity = 0.3f;
+// Fuzzy lookups score at most about this many terms, taken from the query's rarest trigrams
+const int c_searchMaxFuzzyCandidates = 4096;
+
+// EDGE ROUTING CONSTANTS
+
+// Distance routed edges keep from nodes
+const double c_edgeRouteMargin = 15.0;
+// Length of the horizontal segments leaving and entering pins
+const double c_edgeRouteStubLength = 30.0;
+// Cost of a bend in pixels of length
+const double c_edgeRouteBendPenalty = 60.0;
+// How far around the edge routes may go looking for a way around nodes
+const double c_edgeRouteSearchMargin = 300.0;
+// Edges with more nodes around them keep the standard curve
+const int c_edgeRouteMaxObstacles = 64;
+// Points of the standard curve checked against nodes
+const int c_edgeRouteCurveSamples = 32;
+// Pins moving less than this don't trigger rerouting
+const double c_edgeRouteEndTolerance = 4.0;
+// Routes recomputed per frame, the rest is left for the next frames
+const int c_edgeRoutesPerFrame = 64;
+const float c_edgeRouteCornerRadius = 12.0f;
+
+// MINIMAP CONSTANTS
+
+const QSize c_minimapRasterSize{ 240, 160 };
+// Room left around the nodes when the minimap fits them, relative to their bounds
+const double c_minimapAreaRoom = 0.1;
+// More changed areas than this per update redraw the whole minimap
+const int c_minimapMaxDirtyAreas = 64;
+const int c_minimapPadding = 10;
+const int c_minimapHeaderHeight = 26;
+
+// EXPORT CONSTANTS
+
+// Raster exports keep at most this much of the image in memory at once
+const qsizetype c_exportMemoryBudgetBytes = 256 * 1024 * 1024;
+// Larger exports are refused, a row of the image alone would take too much memory
+const int c_exportMaxSide = 1 << 20;
+// Size of the compressed chunks PNG exports are written in
+const qsizetype c_pngChunkBytes = 256 * 1024;
 
 // CANVAS RENDER CONSTANTS
 
+// Side of the square tiles the canvas is rasterized into when tiled rendering is on
+const int c_tileSize = 256;
+
+// Size of the per-frame arena used for paint-time temporaries
+const std::size_t c_frameArenaCapacity = 256 * 1024;
+
+// Number of identical consecutive frames after which a repaint is considered
+// steady-state and must not allocate (checked only with allocation tracking on)
+const int c_steadyStateFramesToCheckAllocations = 2;
+
 const float c_diffCoeffForPinConnectionCurves = 0.4f;
 const short c_xDiffFunctionBlendPoint = 100;
 const short c_maxYDiff = 50;
@@ -54,12 +158,19 @@ const float c_pinConnectLineWidth = 2.5f;
 const char c_dataSeparator = '/';
 const QString c_mimeFormatForPinConnection = "PinData";
 const QString c_mimeFormatForNodeFactory = "NewNode";
+// Binary Subgraph, see Subgraph::toByteArray
+const QString c_mimeFormatForSubgraph = "application/x-graphlib-subgraph";
 
 
 
 // -------- NODES ---------
 // NODES RENDER CONSTANTS
 
+// Memory budget for the rendered images of all nodes of a canvas
+const qsizetype c_nodeRenderCacheBudgetKb = 64 * 1024;
+// Nodes with more pins than this are not cached, since the key tracks connected pins in 64 bits
+const int c_nodeRenderCacheMaxPins = 64;
+
 const short c_nodeNameSize = 15;
 const float c_nodeRoundingRadius = 20.0f;
 const float c_nodeNameRoundedRectSizeY = 0.2f;
@@ -68,16 +179,28 @@ const float c_nodeMaxOutlineWidth = 3.0f;
 
 
 
+// ----- TYPE CATALOGS ---------
+
+// A watched catalog that disappeared is looked for again after this long, editors save by replacing files
+const int c_typeCatalogRetryMs = 200;
+
+
+
 // ----- NODEFACTORY ---------
 // NODEFACTORY GENERAL CONSTANTS
 
 const int c_nfWidgetSpacing = 40;
+// Rows shown at once, the rest of the types are scrolled to
+const int c_nfWidgetVisibleRows = 12;
 
 // NODEFACTORY RENDER CONSTANTS
 
 const QString c_nfWidgetArrowUp = "˄";
 const QString c_nfWidgetArrowDown = "˅";
 const int c_nfWidgetMinimalWidth = 120;
+const int c_nfWidgetPadding = 10;
+const int c_nfWidgetFilterHeight = 24;
+const int c_nfWidgetRowFontSize = 11;
 
 
 
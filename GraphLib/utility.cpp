@@ -3,6 +3,12 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QtDebug>
+#include <QHash>
+#include <QPainter>
+#include <QTextOption>
+#include <QLineF>
+#include <QLinearGradient>
+#include <algorithm>
 
 #include "utility.h"
 #include "constants.h"
@@ -30,9 +36,14 @@ std::optional<QJsonObject> loadFile(const char* name)
     return doc.object();
 }
 
-QFont standardFont(int size)
+const QFont &standardFont(int size)
 {
-    return QFont("Jost", size);
+    thread_local QHash<int, QFont> fonts;
+
+    auto it = fonts.find(size);
+    if (it == fonts.end())
+        it = fonts.insert(size, QFont("Jost", size));
+    return it.value();
 }
 
 QPoint snap(const QPointF &position, short interval)
@@ -50,6 +61,13 @@ QPoint snap(const QPointF &position, short interval)
 }
 
 QPainterPath standardPath(const QPoint &origin, const QPoint &target, float zoomMult)
+{
+    QPainterPath path;
+    standardPath(path, origin, target, zoomMult);
+    return path;
+}
+
+void standardPath(QPainterPath &path, const QPoint &origin, const QPoint &target, float zoomMult)
 {
     const int xDifference = target.x() - origin.x();
     const float xDiffCoeffed = abs(xDifference) * c_diffCoeffForPinConnectionCurves;
@@ -72,14 +90,72 @@ QPainterPath standardPath(const QPoint &origin, const QPoint &target, float zoom
         x2 = target.x() - xDiffCoeffed;
     }
 
-    QPainterPath path;
+    path.clear();
 
     path.moveTo(origin.x(), origin.y());
     path.cubicTo(x1, origin.y(),
                  x2, target.y(),
                  target.x(), target.y());
+}
 
-    return path;
+void routedPath(QPainterPath &path, const QVector<QPointF> &points, qreal cornerRadius, const QTransform &transform)
+{
+    path.clear();
+    path.moveTo(transform.map(points.first()));
+
+    for (int i = 1; i + 1 < points.size(); i++)
+    {
+        const QPointF corner = transform.map(points[i]);
+        const QLineF before(corner, transform.map(points[i - 1]));
+        const QLineF after(corner, transform.map(points[i + 1]));
+
+        // a corner never takes more than half of a segment
+        const qreal radius = std::min({ cornerRadius, before.length() / 2, after.length() / 2 });
+        if (radius <= 0)
+        {
+            path.lineTo(corner);
+            continue;
+        }
+        path.lineTo(before.pointAt(radius / before.length()));
+        path.quadTo(corner, after.pointAt(radius / after.length()));
+    }
+
+    path.lineTo(transform.map(points.last()));
+}
+
+QPen standardEdgePen(const QColor &originColor, const QColor &targetColor, QPointF origin, QPointF target, float zoomMult)
+{
+    // the gradient goes between the corners of the edge's bounding rect
+    // that the origin and the target occupy
+    QPointF start(origin.x() > target.x() ? 1 : 0, origin.y() > target.y() ? 1 : 0);
+    QLinearGradient gradient(start, QPointF(1, 1) - start);
+    gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
+    gradient.setColorAt(0, originColor);
+    gradient.setColorAt(1, targetColor);
+
+    QPen pen(Qt::SolidLine);
+    pen.setWidth(c_pinConnectLineWidth * zoomMult);
+    pen.setBrush(QBrush(gradient));
+    return pen;
+}
+
+void drawCachedText(QPainter *painter, const QRect &rect, QStaticText &text)
+{
+    // changing the width relayouts the text, which happens only when zoom changes
+    if (text.textWidth() != rect.width())
+        text.setTextWidth(rect.width());
+
+    int textHeight = painter->fontMetrics().height();
+    painter->drawStaticText(rect.x(), rect.y() + (rect.height() - textHeight) / 2, text);
+}
+
+QStaticText cachedText(const QString &text)
+{
+    QStaticText out(text);
+    out.setTextFormat(Qt::PlainText);
+    out.setTextOption(QTextOption(Qt::AlignHCenter));
+    out.setPerformanceHint(QStaticText::AggressiveCaching);
+    return out;
 }
 
 QColor NodeFactoryModule::parseToColor(const QString &str)
@@ -3,10 +3,16 @@
 #include <QFont>
 #include <QPoint>
 #include <QPainterPath>
+#include <QStaticText>
+#include <QPen>
+#include <QTransform>
+#include <QVector>
 #include <optional>
 
 #include "GraphLib_global.h"
 
+class QPainter;
+
 namespace GraphLib {
 
 class BaseNode;
@@ -15,12 +21,30 @@ class TypedNode;
 
 std::optional<QJsonObject> loadFile(const char* name);
 
-QFont GRAPHLIB_EXPORT standardFont(int size);
+// Fonts are cached per size, so repeated calls during painting don't allocate
+const QFont GRAPHLIB_EXPORT &standardFont(int size);
 
 QPoint GRAPHLIB_EXPORT snap(const QPointF &position, short interval);
 
 QPainterPath GRAPHLIB_EXPORT standardPath(const QPoint &origin, const QPoint &target, float zoomMult = 1.0f);
 
+// Same as above, but reuses the storage of the given path
+void GRAPHLIB_EXPORT standardPath(QPainterPath &path, const QPoint &origin, const QPoint &target, float zoomMult = 1.0f);
+
+// Orthogonal route with rounded corners, the points are mapped through the transform first
+void GRAPHLIB_EXPORT routedPath(QPainterPath &path, const QVector<QPointF> &points, qreal cornerRadius, const QTransform &transform);
+
+// Pen of an edge between the points: a gradient from the origin's color to the target's one.
+// The gradient is object-bounding, so the pen may be reused for edges with the same colors and orientation
+QPen GRAPHLIB_EXPORT standardEdgePen(const QColor &originColor, const QColor &targetColor, QPointF origin, QPointF target, float zoomMult = 1.0f);
+
+// Draws a cached glyph run centered in the rect, like drawText with Qt::AlignCenter would.
+// The text is expected to be PlainText with a horizontally centered text option
+void GRAPHLIB_EXPORT drawCachedText(QPainter *painter, const QRect &rect, QStaticText &text);
+
+// Plain-text QStaticText set up for drawCachedText
+QStaticText GRAPHLIB_EXPORT cachedText(const QString &text = QString());
+
 namespace NodeFactoryModule {
 
 QColor GRAPHLIB_EXPORT parseToColor(const QString &str);
@@ -3,7 +3,9 @@ TEMPLATE = subdirs
 SUBDIRS += \
     GraphApp \
     GraphLib \
-    GraphTests
+    GraphTests \
+    GraphBenchmarks
 
 GraphApp.depends = GraphLib GraphTests
 GraphTests.depends = GraphLib
+GraphBenchmarks.depends = GraphLib
@@ -1,9 +1,14 @@
-
-
+#include <QApplication>
 #include <gtest/gtest.h>
 
 int main(int argc, char *argv[])
 {
+    // canvases are tested without being shown, no window system is needed
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
@@ -3,18 +3,58 @@
 
 #include <QString>
 #include <QByteArray>
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QDragMoveEvent>
+#include <QFile>
+#include <QImage>
+#include <QTemporaryDir>
 #include <QMap>
+#include <QMimeData>
+#include <QThread>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QPointF>
 #include <algorithm>
+#include <functional>
+#include <limits>
+#include <iterator>
 #include <string>
+#include <memory>
 
 #include "NodeFactoryModule/nodefactory.h"
+#include "NodeFactoryModule/palettemodel.h"
 #include "TypeManagers/nodetypemanager.h"
 #include "TypeManagers/pintypemanager.h"
+#include "TypeManagers/typecatalog.h"
+#include "TypeManagers/typecatalogcache.h"
+#include "TypeManagers/typecatalogwatcher.h"
 #include "GraphLib_global.h"
 #include "GraphWidgets/Abstracts/abstractpin.h"
 #include "DataClasses/nodespawndata.h"
+#include "Render/framearena.h"
+#include "Render/frameprofiler.h"
+#include "Render/frameclock.h"
+#include "Generators/graphgenerator.h"
+#include "History/commandjournal.h"
+#include "DataClasses/graphdata.h"
+#include "Layout/layeredlayout.h"
+#include "Layout/forcelayout.h"
+#include "Layout/edgerouter.h"
+#include "Spatial/spatialindex.h"
+#include "Selection/selectionset.h"
+#include "Analysis/graphquery.h"
+#include "Search/nodesearchindex.h"
+#include "Render/tilerenderer.h"
+#include "Export/pngstreamwriter.h"
+#include "Render/minimapraster.h"
+#include "Render/zoomlevel.h"
+#include "Render/kineticpan.h"
+#include "Render/renderdetail.h"
+#include "Render/noderendercache.h"
+#include "GraphWidgets/canvas.h"
+#include "GraphWidgets/typednode.h"
 #include "utility.h"
 
 using namespace testing;
@@ -40,6 +80,21 @@ protected:
     PinTypeManager _PinTypeManager;
 };
 
+// A hidden canvas with the test types
+class TestCanvas : public TestTypeManagers
+{
+protected:
+    void SetUp() override
+    {
+        TestTypeManagers::SetUp();
+        _canvas = std::make_unique<Canvas>();
+        _canvas->setTypeManagers(&_PinTypeManager, &_NodeTypeManager);
+        _canvas->resize(800, 600);
+    }
+
+    std::unique_ptr<Canvas> _canvas;
+};
+
 TEST(TestPinData, ByteArrayConversions)
 {
     PinData first(PinDirection::In, 0, 0);
@@ -103,6 +158,212 @@ TEST_F(TestTypeManagers, Properties)
     EXPECT_EQ(0, _NodeTypeManager.TypeNames()["Monitor"]);
 }
 
+TEST_F(TestTypeManagers, CatalogsMergeByName)
+{
+    const QByteArray catalog = R"({ "version": 2, "types": [
+        { "pins": [ { "name": "a", "nested": { "name": "x" } } ], "name": "power", "category": "Energy" },
+        { "name": "signal" } ] })";
+
+    std::optional<QVector<CatalogType>> scanned = scanTypeCatalog(catalog);
+    ASSERT_TRUE(scanned.has_value());
+    ASSERT_EQ(2, scanned->size());
+    EXPECT_EQ("power", scanned->at(0).name);
+    EXPECT_EQ("Energy", scanned->at(0).category);
+    EXPECT_TRUE(scanned->at(1).category.isEmpty());
+    EXPECT_FALSE(scanTypeCatalog(catalog + "]").has_value());
+
+    // a replaced type keeps its ID, a new one is appended
+    const qsizetype count = _PinTypeManager.typesCount();
+    EXPECT_EQ(QVector<int>({ 0, static_cast<int>(count) }), _PinTypeManager.mergeTypes(*scanned));
+    EXPECT_EQ(count + 1, _PinTypeManager.typesCount());
+    EXPECT_EQ("Energy", _PinTypeManager.typeCategory(0));
+    EXPECT_EQ("a", _PinTypeManager.type(0).value("pins").toArray().at(0).toObject().value("name").toString());
+    EXPECT_EQ(static_cast<int>(count), _PinTypeManager.TypeNames()["signal"]);
+}
+
+static bool writeFile(const QString &path, const QByteArray &content)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+}
+
+// File watchers and worker threads report through the event loop
+static bool processEventsUntil(const std::function<bool()> &condition, int timeoutMs = 5000)
+{
+    QElapsedTimer timeout;
+    timeout.start();
+    while (!condition() && timeout.elapsed() < timeoutMs)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    return condition();
+}
+
+TEST(TestTypeCatalogWatcher, ReloadsEditedAndNewFiles)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    ASSERT_TRUE(writeFile(dir.filePath("a.json"), R"({ "types": [ { "name": "power", "category": "Energy" } ] })"));
+
+    PinTypeManager manager;
+    TypeCatalogWatcher watcher(&manager);
+    QVector<int> changed;
+    QObject::connect(&watcher, &TypeCatalogWatcher::onTypesChanged, [&](const QVector<int> &typeIDs) { changed.append(typeIDs); });
+
+    watcher.load(dir.path());
+    EXPECT_EQ(0, manager.typesCount()) << "Types are expected to be merged on the watcher's thread only";
+    watcher.waitForFinished();
+    EXPECT_FALSE(watcher.isLoading());
+    ASSERT_EQ(1, manager.typesCount());
+    EXPECT_EQ(QVector<int>({ 0 }), changed);
+
+    // an edited type keeps its ID
+    ASSERT_TRUE(writeFile(dir.filePath("a.json"), R"({ "types": [ { "name": "power", "category": "Supply" } ] })"));
+    EXPECT_TRUE(processEventsUntil([&] { return manager.typeCategory(0) == "Supply"; }));
+    EXPECT_EQ(1, manager.typesCount());
+
+    // a file added to the directory is loaded as well
+    ASSERT_TRUE(writeFile(dir.filePath("b.json"), R"({ "types": [ { "name": "USB" } ] })"));
+    EXPECT_TRUE(processEventsUntil([&] { return manager.typesCount() == 2; }));
+    EXPECT_EQ(1, manager.TypeNames().value("USB", -1));
+    EXPECT_TRUE(changed.contains(1));
+}
+
+TEST(TestTypeCatalogWatcher, RetriesFilesReplacedByEditors)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString file = dir.filePath("pins.json");
+    ASSERT_TRUE(writeFile(file, R"({ "types": [ { "name": "power", "category": "Energy" } ] })"));
+
+    PinTypeManager manager;
+    TypeCatalogWatcher watcher(&manager);
+    watcher.load(file);
+    watcher.waitForFinished();
+    ASSERT_EQ(1, manager.typesCount());
+
+    // the file is gone when the change is reported, it's scanned again once it's back
+    ASSERT_TRUE(QFile::remove(file));
+    processEventsUntil([] { return false; }, c_typeCatalogRetryMs / 2);
+    ASSERT_TRUE(writeFile(file, R"({ "types": [ { "name": "power", "category": "Grid" } ] })"));
+    EXPECT_TRUE(processEventsUntil([&] { return manager.typeCategory(0) == "Grid"; }));
+    EXPECT_EQ(1, manager.typesCount());
+}
+
+TEST_F(TestCanvas, SpawnsNodesBeforePinTypesAreLoaded)
+{
+    // node types can be merged before the pin types, unknown IDs give empty values
+    PinTypeManager pins;
+    EXPECT_TRUE(pins.type(0).isEmpty());
+    EXPECT_TRUE(pins.typeNameByID(0).isEmpty());
+    EXPECT_TRUE(_NodeTypeManager.typeCategory(-1).isEmpty());
+
+    // the pins are still made, they're referred to by their index
+    NodeFactoryModule::NodeFactory factory;
+    factory.setNodeTypeManager(&_NodeTypeManager);
+    factory.setPinTypeManager(&pins);
+    std::unique_ptr<TypedNode> computer(factory.getNodeOfType(1, _canvas.get()));
+    EXPECT_EQ("Computer", computer->getName());
+    EXPECT_EQ(6, computer->pins().size());
+}
+
+TEST_F(TestCanvas, RecolorsPinsWhenPinTypesArrive)
+{
+    PinTypeManager pins;
+    _canvas->setPinTypeManager(&pins);
+    QSharedPointer<BaseNode> computer = _canvas->addTypedNode(QPoint(0, 0), 1).toStrongRef();
+    ASSERT_FALSE(computer.isNull());
+    const auto pinOfType = [&](const QString &typeName) {
+        return *std::ranges::find_if(computer->pins(), [&](const AbstractPin *pin) { return pin->getText() == typeName; });
+    };
+    EXPECT_EQ(QColor(Qt::GlobalColor::black), pinOfType("power")->getColor());
+
+    const quint64 generation = computer->renderGeneration();
+    std::optional<QVector<CatalogType>> scanned = scanTypeCatalog(R"({ "types": [ { "name": "power", "color": "FF0000" } ] })");
+    ASSERT_TRUE(scanned.has_value());
+    _canvas->reloadPinTypes(pins.mergeTypes(*scanned));
+
+    EXPECT_EQ(QColor(255, 0, 0), pinOfType("power")->getColor());
+    EXPECT_EQ(QColor(Qt::GlobalColor::black), pinOfType("USB")->getColor());
+    EXPECT_NE(generation, computer->renderGeneration());
+
+    _canvas->setPinTypeManager(&_PinTypeManager);
+}
+
+TEST(TestTypeCatalogCache, CompiledCatalogRoundTrips)
+{
+    const QVector<CatalogType> types = { { "power", "Energy", R"({"name":"power"})" }, { "signal", QString(), R"({"name":"signal"})" } };
+    const QByteArray hash = TypeCatalogCache::contentHash("catalog");
+    const QByteArray image = TypeCatalogCache::compile(types, hash);
+
+    std::optional<QVector<CatalogType>> read = TypeCatalogCache::read(image, hash);
+    ASSERT_TRUE(read.has_value());
+    ASSERT_EQ(2, read->size());
+    EXPECT_EQ("Energy", read->at(0).category);
+    EXPECT_EQ(types.at(1).json, read->at(1).json);
+    // the JSON isn't copied out of the image
+    EXPECT_TRUE(read->at(0).json.constData() >= image.constData() && read->at(0).json.constData() < image.constData() + image.size());
+
+    // a cache of other content or a truncated one isn't used
+    EXPECT_FALSE(TypeCatalogCache::read(image, TypeCatalogCache::contentHash("edited")).has_value());
+    EXPECT_FALSE(TypeCatalogCache::read(image.first(image.size() - 1), hash).has_value());
+
+    // without a stamp the content is always hashed
+    EXPECT_FALSE(TypeCatalogCache::read(image, CatalogStamp()).has_value());
+    const CatalogStamp stamp{ 7, 1000 };
+    const QByteArray stamped = TypeCatalogCache::compile(types, hash, stamp);
+    EXPECT_TRUE(TypeCatalogCache::read(stamped, stamp).has_value());
+    EXPECT_FALSE(TypeCatalogCache::read(stamped, CatalogStamp{ 7, 1001 }).has_value());
+}
+
+TEST(TestTypeCatalogCache, LoadWritesReadsAndRecompilesCache)
+{
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString file = dir.filePath("pins.json");
+    ASSERT_TRUE(writeFile(file, R"({ "types": [ { "name": "power", "category": "Energy" } ] })"));
+    const TypeCatalogCache cache(dir.filePath("cache"));
+
+    // the first load scans the file and writes its cache
+    std::optional<QVector<CatalogType>> first = cache.load(file);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_EQ(1, first->size());
+    EXPECT_FALSE(first->at(0).mapping);
+    ASSERT_TRUE(QFile::exists(cache.cacheFile(file)));
+
+    // the next one maps the cache
+    std::optional<QVector<CatalogType>> second = cache.load(file);
+    ASSERT_TRUE(second.has_value());
+    ASSERT_EQ(1, second->size());
+    EXPECT_TRUE(second->at(0).mapping);
+    EXPECT_EQ("Energy", second->at(0).category);
+    EXPECT_EQ(first->at(0).json, second->at(0).json);
+
+    // an edited file is scanned and compiled again
+    ASSERT_TRUE(writeFile(file, R"({ "types": [ { "name": "power", "category": "Grid" }, { "name": "USB" } ] })"));
+    std::optional<QVector<CatalogType>> edited = cache.load(file);
+    ASSERT_TRUE(edited.has_value());
+    ASSERT_EQ(2, edited->size());
+    EXPECT_FALSE(edited->at(0).mapping);
+    EXPECT_EQ("Grid", edited->at(0).category);
+    std::optional<QVector<CatalogType>> recompiled = cache.load(file);
+    ASSERT_TRUE(recompiled.has_value());
+    ASSERT_EQ(2, recompiled->size());
+    EXPECT_TRUE(recompiled->at(0).mapping);
+
+    // a touched file is hashed once, its cache is kept and gets the new stamp
+    {
+        QFile touched(file);
+        ASSERT_TRUE(touched.open(QIODevice::ReadWrite));
+        ASSERT_TRUE(touched.setFileTime(touched.fileTime(QFileDevice::FileModificationTime).addSecs(10),
+                                        QFileDevice::FileModificationTime));
+    }
+    std::optional<QVector<CatalogType>> touched = cache.load(file);
+    ASSERT_TRUE(touched.has_value());
+    EXPECT_TRUE(touched->at(0).mapping);
+    QFile cacheFile(cache.cacheFile(file));
+    ASSERT_TRUE(cacheFile.open(QIODevice::ReadOnly));
+    EXPECT_TRUE(TypeCatalogCache::read(cacheFile.readAll(), CatalogStamp::of(file)).has_value());
+}
+
 TEST(TestNodeFactory, ParseToColor)
 {
     auto check = [](QString str, int r, int g, int b) {
@@ -123,3 +384,980 @@ TEST(TestNodeFactory, ParseToColor)
     check(str3, 0xFF, 0xFF, 0xFF);
 }
 
+TEST(TestFrameArena, ResetReusesBuffer)
+{
+    FrameArena arena(4096);
+
+    const int *firstFrame = nullptr;
+    {
+        auto vector = arena.makeVector<int>(100);
+        vector.push_back(1);
+        firstFrame = vector.data();
+    }
+
+    arena.reset();
+
+    auto vector = arena.makeVector<int>(100);
+    vector.push_back(2);
+    EXPECT_EQ(firstFrame, vector.data()) << "Arena memory is expected to be reused after reset";
+}
+
+TEST(TestFrameProfiler, FinalizesFrameOnNextBegin)
+{
+    FrameProfiler profiler;
+    profiler.beginFrame();
+
+    {
+        FrameProfiler::ScopedPhase phase(profiler, FramePhase::Edges);
+        profiler.current().edgesDrawn = 3;
+    }
+    EXPECT_EQ(profiler.lastFrame().edgesDrawn, 0) << "Frame is expected to stay current until the next one begins";
+
+    profiler.beginFrame();
+    const FrameStats &stats = profiler.lastFrame();
+    EXPECT_EQ(stats.frameNumber, 1);
+    EXPECT_EQ(stats.edgesDrawn, 3);
+    EXPECT_GT(stats.phase(FramePhase::Edges), 0);
+    EXPECT_EQ(stats.totalNs, stats.phase(FramePhase::Edges));
+    EXPECT_EQ(profiler.current().edgesDrawn, 0);
+}
+
+TEST(TestFrameClock, MergesRequestsAndIdles)
+{
+    FrameClock clock(nullptr, 5);
+    QVector<qint64> frames;
+    QObject::connect(&clock, &FrameClock::onFrame, [&](qint64 elapsedNs) { frames.append(elapsedNs); });
+    EXPECT_FALSE(clock.isRunning()) << "Clock is expected to stay idle until a frame is requested";
+
+    clock.requestFrame();
+    clock.requestFrame();
+    clock.flush();
+    clock.flush();
+    ASSERT_EQ(frames.size(), 1) << "Requests before a frame are expected to be merged into it";
+    EXPECT_EQ(frames[0], qint64(5) * 1000000) << "First frame after idling is expected to last an interval";
+
+    // the next frame comes from the timer, after which nothing is requested and the clock stops
+    clock.requestFrame();
+    QElapsedTimer timeout;
+    timeout.start();
+    while (clock.isRunning() && timeout.elapsed() < 1000)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    EXPECT_FALSE(clock.isRunning());
+    ASSERT_EQ(frames.size(), 2);
+    EXPECT_GT(frames[1], 0);
+}
+
+TEST_F(TestTypeManagers, GeneratedGraphIsDeterministic)
+{
+    GraphGeneratorOptions options;
+    options.nodeCount = 300;
+    options.topology = GraphTopology::Random;
+    options.fanOutDistribution = DegreeDistribution::PowerLaw;
+    options.maxFanOut = 4;
+    options.clusterCount = 3;
+    options.seed = 7;
+
+    GeneratedGraph first = GraphGenerator(&_NodeTypeManager, &_PinTypeManager).generate(options);
+    GeneratedGraph second = GraphGenerator(&_NodeTypeManager, &_PinTypeManager).generate(options);
+    ASSERT_EQ(300, first.nodes.size());
+    EXPECT_FALSE(first.edges.isEmpty());
+    EXPECT_EQ(first.nodes, second.nodes);
+    EXPECT_EQ(first.edges, second.edges);
+
+    options.seed = 8;
+    GeneratedGraph third = GraphGenerator(&_NodeTypeManager, &_PinTypeManager).generate(options);
+    EXPECT_NE(first.nodes, third.nodes) << "Expected another seed to give another graph";
+}
+
+TEST_F(TestTypeManagers, GeneratedLayeredGraphIsAcyclic)
+{
+    GraphGeneratorOptions options;
+    options.nodeCount = 500;
+    options.layerCount = 8;
+    options.maxFanOut = 3;
+    options.maxFanIn = 2;
+
+    GeneratedGraph graph = GraphGenerator(&_NodeTypeManager, &_PinTypeManager).generate(options);
+    EXPECT_FALSE(graph.edges.isEmpty());
+
+    QMap<QPair<int, int>, int> inPinsLoad;
+    std::ranges::for_each(graph.edges, [&](const GeneratedGraph::Edge &edge) {
+        // layers are contiguous ranges of nodes, so edges going to the following layers go forward
+        EXPECT_LT(edge.outNode, edge.inNode);
+        inPinsLoad[QPair<int, int>(edge.inNode, edge.inPin)]++;
+    });
+    std::ranges::for_each(inPinsLoad, [&](int load) { EXPECT_LE(load, options.maxFanIn); });
+}
+
+TEST_F(TestTypeManagers, GeneratedFanInFollowsDistribution)
+{
+    GraphGeneratorOptions options;
+    options.nodeCount = 2000;
+    options.topology = GraphTopology::Random;
+    options.maxFanOut = 4;
+    options.fanInDistribution = DegreeDistribution::PowerLaw;
+    options.maxFanIn = 8;
+
+    GeneratedGraph graph = GraphGenerator(&_NodeTypeManager, &_PinTypeManager).generate(options);
+    QMap<QPair<int, int>, int> inPinsLoad;
+    std::ranges::for_each(graph.edges, [&](const GeneratedGraph::Edge &edge) {
+        EXPECT_NE(edge.outNode, edge.inNode);
+        inPinsLoad[QPair<int, int>(edge.inNode, edge.inPin)]++;
+    });
+
+    // most in-pins take a single connection and a few take many
+    const auto loads = inPinsLoad.values();
+    const qsizetype single = std::ranges::count(loads, 1);
+    const qsizetype many = std::ranges::count_if(loads, [](int load) { return load >= 4; });
+    EXPECT_GT(single, many * 2);
+    EXPECT_GT(many, 0);
+    EXPECT_LE(std::ranges::max(loads), options.maxFanIn);
+}
+
+TEST(TestCommandJournal, CoalescesMovesUntilSealed)
+{
+    CommandJournal journal(1024 * 1024);
+
+    journal.record(MoveNodesCommand{ { NodeMove{ 1, QPointF(0, 0), QPointF(10, 0) } } });
+    journal.record(MoveNodesCommand{ { NodeMove{ 1, QPointF(10, 0), QPointF(20, 5) } } });
+    ASSERT_EQ(1, journal.size()) << "Expected consecutive moves of a node to be merged";
+
+    journal.seal();
+    journal.record(MoveNodesCommand{ { NodeMove{ 1, QPointF(20, 5), QPointF(30, 5) } } });
+    EXPECT_EQ(2, journal.size());
+
+    journal.undo();
+    const Command *command = journal.undo();
+    ASSERT_NE(nullptr, command);
+    const NodeMove &move = std::get<MoveNodesCommand>(*command).moves.first();
+    EXPECT_EQ(QPointF(0, 0), move.from);
+    EXPECT_EQ(QPointF(20, 5), move.to);
+
+    journal.record(ConnectPinsCommand{ { EdgeRecord{ 1, 0, 2, 0 } } });
+    EXPECT_FALSE(journal.canRedo()) << "Expected recording to drop the commands that could be redone";
+    EXPECT_EQ(1, journal.size());
+}
+
+TEST(TestCommandJournal, DropsOldestCommandsOverCap)
+{
+    const qsizetype commandSize = CommandJournal::memorySize(ConnectPinsCommand{ { EdgeRecord{ 0, 0, 1, 0 } } });
+    CommandJournal journal(commandSize * 3);
+
+    for (int i = 0; i < 10; i++)
+        journal.record(ConnectPinsCommand{ { EdgeRecord{ i, 0, i + 1, 0 } } });
+
+    EXPECT_EQ(3, journal.size());
+    EXPECT_LE(journal.memoryUsage(), journal.memoryCap());
+
+    const Command *newest = journal.undo();
+    ASSERT_NE(nullptr, newest);
+    EXPECT_EQ(9, std::get<ConnectPinsCommand>(*newest).edges.first().outNodeID);
+}
+
+TEST(TestSubgraph, ByteArrayConversions)
+{
+    Subgraph first;
+    first.nodes.append({ 4, 2, QPointF(10.5, -20), QString(), {} });
+    first.nodes.append({ 7, -1, QPointF(300, 40), QString("Base"),
+                         { { "in", PinDirection::In, QColor(Qt::red) }, { "out", PinDirection::Out, QColor(0, 0, 255, 128) } } });
+    first.edges.append({ 7, 1, 4, 0 });
+
+    QByteArray arr = first.toByteArray();
+    Subgraph second = Subgraph::fromByteArray(arr);
+    EXPECT_EQ(first, second);
+
+    Subgraph truncated = Subgraph::fromByteArray(arr.left(arr.size() - 3));
+    EXPECT_TRUE(truncated.nodes.isEmpty()) << "Expected malformed data to give an empty subgraph";
+    EXPECT_TRUE(Subgraph::fromByteArray(QByteArray("garbage")).nodes.isEmpty());
+}
+
+TEST(TestLayeredLayout, LayersFollowEdges)
+{
+    LayoutGraph graph;
+    for (int i = 0; i < 5; i++)
+        graph.nodes.append({ 10 + i, QPointF(0, i * 10), QSizeF(100, 50), 2 });
+
+    // 0 -> 1 -> 2 -> 3, 0 -> 3, 4 -> 2 and 3 -> 0 closing a cycle
+    graph.edges = { { 0, 1, 1, 0 }, { 1, 1, 2, 0 }, { 2, 1, 3, 0 }, { 0, 1, 3, 0 }, { 4, 1, 2, 0 }, { 3, 1, 0, 0 } };
+
+    LayeredLayoutOptions options;
+    LayoutPositions positions = LayeredLayout::compute(graph, options);
+    ASSERT_EQ(5, positions.size());
+
+    QMap<int, QPointF> byID;
+    std::ranges::for_each(positions, [&](const QPair<int, QPointF> &position) { byID.insert(position.first, position.second); });
+
+    EXPECT_LT(byID[10].x(), byID[11].x());
+    EXPECT_LT(byID[11].x(), byID[12].x());
+    EXPECT_LT(byID[12].x(), byID[13].x());
+    EXPECT_LT(byID[14].x(), byID[12].x());
+
+    // nodes of one layer must not overlap
+    for (int a = 10; a < 15; a++)
+        for (int b = a + 1; b < 15; b++)
+            if (byID[a].x() == byID[b].x())
+                EXPECT_GE(std::abs(byID[a].y() - byID[b].y()), 50 + options.nodeSpacing);
+}
+
+TEST(TestForceLayout, SettlesOnlyNodesNearEdit)
+{
+    LayoutGraph graph;
+    graph.nodes = { { 1, QPointF(0, 0), QSizeF(100, 50), 1 },
+                    { 2, QPointF(2000, 0), QSizeF(100, 50), 1 },
+                    { 3, QPointF(6000, 0), QSizeF(100, 50), 1 } };
+    graph.edges = { { 0, 0, 1, 0 } };
+
+    ForceLayoutOptions options;
+    options.settleRadius = 2500;
+    LayoutPositions positions = ForceLayout::compute(graph, options, { 0 });
+
+    // the far node is pinned and not reported at all
+    ASSERT_EQ(2, positions.size());
+    EXPECT_EQ(1, positions[0].first);
+    EXPECT_EQ(2, positions[1].first);
+
+    // the connected nodes are pulled towards each other
+    double distance = QLineF(positions[0].second, positions[1].second).length();
+    EXPECT_LT(distance, 2000);
+}
+
+TEST(TestSpatialIndex, QueriesFollowUpdates)
+{
+    SpatialIndex index(100);
+    index.insert(1, QRectF(0, 0, 50, 50));
+    index.insert(2, QRectF(120, 0, 300, 50));
+    index.insert(3, QRectF(-1000, -1000, 10, 10));
+
+    EXPECT_EQ(QVector<int>({ 1, 2 }), index.query(QRectF(40, 10, 100, 10)));
+    EXPECT_EQ(QVector<int>({ 2 }), index.query(QRectF(400, 40, 5, 5)));
+
+    index.insert(1, QRectF(-1000, -980, 10, 10));
+    index.remove(2);
+    EXPECT_TRUE(index.query(QRectF(40, 10, 100, 10)).isEmpty());
+    EXPECT_EQ(QVector<int>({ 1, 3 }), index.query(QRectF(-1100, -1100, 200, 200)));
+    EXPECT_EQ(QRectF(-1000, -1000, 10, 30), index.bounds());
+}
+
+TEST(TestSpatialIndex, DifferenceMatchesFullQueries)
+{
+    SpatialIndex index(100);
+    for (int i = 0; i < 400; i++)
+        index.insert(i, QRectF((i % 20) * 60, (i / 20) * 60, 40, 40));
+
+    // a rubber band growing, shrinking and jumping away
+    QVector<QRectF> areas{ QRectF(10, 10, 100, 100), QRectF(10, 10, 400, 250), QRectF(10, 10, 150, 300),
+                           QRectF(-50, 200, 300, 30), QRectF(700, 700, 200, 200) };
+    QVector<int> entered, left;
+    for (int i = 1; i < areas.size(); i++)
+    {
+        QVector<int> before = index.query(areas[i - 1]), after = index.query(areas[i]);
+        QVector<int> expectedEntered, expectedLeft;
+        std::ranges::set_difference(after, before, std::back_inserter(expectedEntered));
+        std::ranges::set_difference(before, after, std::back_inserter(expectedLeft));
+
+        index.queryDifference(areas[i - 1], areas[i], entered, left);
+        EXPECT_EQ(expectedEntered, entered);
+        EXPECT_EQ(expectedLeft, left);
+    }
+}
+
+TEST(TestSelectionSet, SelectAllAndInvertFollowExistingNodes)
+{
+    SelectionSet selection;
+    for (int id = 0; id < 100000; id++)
+        selection.addNode(id);
+    for (int id = 0; id < 100000; id += 10)
+        selection.removeNode(id);
+
+    EXPECT_TRUE(selection.select(5));
+    EXPECT_FALSE(selection.select(5));
+    EXPECT_FALSE(selection.select(10));
+    EXPECT_EQ(1, selection.size());
+
+    selection.invert();
+    EXPECT_EQ(90000 - 1, selection.size());
+    EXPECT_FALSE(selection.contains(5));
+    EXPECT_FALSE(selection.contains(10));
+    EXPECT_TRUE(selection.contains(11));
+
+    selection.selectAll();
+    EXPECT_EQ(90000, selection.size());
+    QVector<int> ids = selection.ids();
+    EXPECT_EQ(90000, ids.size());
+    EXPECT_TRUE(std::ranges::is_sorted(ids));
+    EXPECT_EQ(1, ids.first());
+    EXPECT_EQ(99999, ids.last());
+
+    selection.removeNode(99999);
+    EXPECT_EQ(90000 - 1, selection.size());
+    selection.clear();
+    EXPECT_TRUE(selection.isEmpty());
+}
+
+TEST(TestEdgeRouter, RoutesAroundObstacles)
+{
+    QPointF origin(0, 100), target(600, 100);
+    QVector<QRectF> obstacles{ QRectF(250, 0, 100, 200) };
+
+    QVector<QPointF> route = EdgeRouter::compute(origin, target, obstacles);
+    ASSERT_GE(route.size(), 4);
+    EXPECT_EQ(origin, route.first());
+    EXPECT_EQ(target, route.last());
+
+    QRectF blocked = obstacles.first().adjusted(-c_edgeRouteMargin + 1, -c_edgeRouteMargin + 1, c_edgeRouteMargin - 1, c_edgeRouteMargin - 1);
+    for (int i = 1; i < route.size(); i++)
+    {
+        QLineF segment(route[i - 1], route[i]);
+        // every segment is either horizontal or vertical and stays away from the obstacle
+        EXPECT_TRUE(segment.dx() == 0 || segment.dy() == 0);
+        for (int step = 0; step <= 20; step++)
+            EXPECT_FALSE(blocked.contains(segment.pointAt(step / 20.0)));
+    }
+}
+
+TEST(TestTileRenderer, TilesShowOnlyTheirPartOfTheScene)
+{
+    TileScene scene;
+    scene.addNode({ QRectF(100, 100, 200, 150), false });
+    scene.addNode({ QRectF(1000, 1000, 200, 150), true });
+
+    // a zoom of 0.5 puts the first node into tile (0, 0) and the second one into tile (1, 1)
+    QImage first = TileRenderer::renderTile(scene, QPoint(0, 0), 256, 0.5f, 1000);
+    QImage second = TileRenderer::renderTile(scene, QPoint(1, 1), 256, 0.5f, 1000);
+
+    EXPECT_EQ(c_nodesBackgroundColor.alpha(), first.pixelColor(100, 80).alpha());
+    EXPECT_EQ(0, first.pixelColor(200, 200).alpha());
+    EXPECT_EQ(c_selectionColor.rgb(), second.pixelColor(505 - 256, 505 - 256).rgb());
+}
+
+TEST(TestPngStreamWriter, StripsMakeOneImage)
+{
+    QImage image(37, 20, QImage::Format_ARGB32);
+    for (int y = 0; y < image.height(); y++)
+        for (int x = 0; x < image.width(); x++)
+            image.setPixelColor(x, y, QColor(x * 6, y * 12, (x + y) % 256, 255 - y));
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    PngStreamWriter writer(&buffer, image.size());
+    ASSERT_TRUE(writer.isValid());
+    EXPECT_TRUE(writer.writeRows(image.copy(0, 0, 37, 13)));
+    // too many rows for the rest of the image
+    EXPECT_FALSE(writer.writeRows(image));
+    EXPECT_TRUE(writer.writeRows(image.copy(0, 13, 37, 7)));
+    EXPECT_TRUE(writer.finish());
+
+    QImage written = QImage::fromData(buffer.data(), "PNG").convertToFormat(QImage::Format_ARGB32);
+    ASSERT_EQ(image.size(), written.size());
+    for (int y = 0; y < image.height(); y++)
+        for (int x = 0; x < image.width(); x++)
+            EXPECT_EQ(image.pixel(x, y), written.pixel(x, y));
+}
+
+TEST(TestMinimapRaster, RedrawsOnlyChangedAreas)
+{
+    MinimapRaster raster(QSize(200, 100));
+    for (int i = 0; i < 100; i++)
+        raster.setNode(i, QRectF((i % 10) * 400, (i / 10) * 200, 200, 100));
+
+    EXPECT_TRUE(raster.update());
+    EXPECT_EQ(100, raster.redrawnNodes());
+    EXPECT_FALSE(raster.update());
+
+    // moving a node inside the shown area only redraws the nodes around it
+    QPointF before = raster.mapFromCanvas(QPointF(100, 50));
+    raster.setNode(0, QRectF(200, 100, 200, 150));
+    EXPECT_TRUE(raster.update());
+    EXPECT_LT(raster.redrawnNodes(), 10);
+    EXPECT_EQ(0, raster.image().pixelColor(before.toPoint()).alpha());
+    EXPECT_NE(0, raster.image().pixelColor(raster.mapFromCanvas(QPointF(300, 175)).toPoint()).alpha());
+
+    // leaving the area fits the area to the nodes again
+    raster.setNode(1, QRectF(10000, 0, 200, 100));
+    EXPECT_TRUE(raster.update());
+    EXPECT_EQ(100, raster.redrawnNodes());
+    EXPECT_TRUE(raster.area().contains(QRectF(10000, 0, 200, 100)));
+}
+
+TEST(TestZoomLevel, LevelsRoundTripAndStayNearTheZoom)
+{
+    EXPECT_EQ(0, zoomLevelFor(1.0f));
+    EXPECT_FLOAT_EQ(1.0f, zoomMultiplierForLevel(0));
+
+    for (short level = zoomLevelFor(c_minZoomMultiplier); level <= zoomLevelFor(c_maxZoomMultiplier); level++)
+        EXPECT_EQ(level, zoomLevelFor(zoomMultiplierForLevel(level)));
+
+    // a level's multiplier is never further than half a level from the zoom
+    for (float zoom = c_minZoomMultiplier; zoom <= c_maxZoomMultiplier; zoom *= 1.03f)
+    {
+        float ratio = zoom / zoomMultiplierForLevel(zoomLevelFor(zoom));
+        EXPECT_LE(std::max(ratio, 1.0f / ratio), std::sqrt(c_zoomLevelRatio) + 1e-4f);
+    }
+
+    EXPECT_FLOAT_EQ(c_maxZoomMultiplier, clampZoomMultiplier(100.0f));
+    EXPECT_FLOAT_EQ(c_minZoomMultiplier, clampZoomMultiplier(0.0f));
+}
+
+TEST(TestKineticPan, SlowsDownAndStops)
+{
+    KineticPan pan;
+    const qint64 frameNs = 16000000;
+    for (int i = 0; i < 5; i++)
+        pan.track(QPointF(16, 0), frameNs);
+
+    EXPECT_NEAR(1000.0, pan.velocity().x(), 1.0);
+    pan.release();
+    ASSERT_TRUE(pan.isMoving());
+
+    double distance = 0;
+    double previousStep = std::numeric_limits<double>::max();
+    int frames = 0;
+    while (pan.isMoving() && frames < 1000)
+    {
+        QPointF step = pan.step(frameNs);
+        EXPECT_LE(step.x(), previousStep);
+        EXPECT_EQ(0.0, step.y());
+        previousStep = step.x();
+        distance += step.x();
+        frames++;
+    }
+
+    // friction stops it after moving about velocity / friction
+    EXPECT_FALSE(pan.isMoving());
+    EXPECT_LT(frames, 1000);
+    EXPECT_NEAR(1000.0 / c_kineticPanFriction, distance, 20.0);
+
+    // releasing a pan that wasn't moving doesn't start it
+    pan.track(QPointF(0, 0), frameNs);
+    pan.release();
+    EXPECT_FALSE(pan.isMoving());
+}
+
+TEST(TestGraphQuery, ConesCyclesAndOrder)
+{
+    GraphQuery query;
+    for (int id = 0; id < 6; id++)
+        query.addNode(id);
+
+    // 0 -> 1 -> 2 -> 3, 1 -> 4, 5 alone; two pins connect 0 and 1
+    query.addEdge(0, 1);
+    query.addEdge(0, 1);
+    query.addEdge(1, 2);
+    query.addEdge(2, 3);
+    query.addEdge(1, 4);
+
+    EXPECT_EQ(QVector<int>({ 1, 2, 3, 4 }), query.downstream(0));
+    EXPECT_EQ(QVector<int>({ 0, 1, 2 }), query.upstream(3));
+    EXPECT_TRUE(query.downstream(5).isEmpty());
+    EXPECT_FALSE(query.hasCycle());
+
+    const std::optional<QVector<int>> order = query.topologicalOrder();
+    ASSERT_TRUE(order.has_value());
+    auto position = [&](int id) { return order->indexOf(id); };
+    EXPECT_LT(position(0), position(1));
+    EXPECT_LT(position(1), position(2));
+    EXPECT_LT(position(2), position(3));
+    EXPECT_LT(position(1), position(4));
+
+    EXPECT_TRUE(query.wouldCreateCycle(3, 0));
+    EXPECT_TRUE(query.wouldCreateCycle(2, 2));
+    EXPECT_FALSE(query.wouldCreateCycle(4, 3));
+    EXPECT_FALSE(query.wouldCreateCycle(0, 5));
+
+    // the edit drops the cached results
+    query.addEdge(3, 1);
+    EXPECT_TRUE(query.hasCycle());
+    EXPECT_EQ(QVector<int>({ 1, 2, 3, 4 }), query.downstream(2));
+
+    QVector<QVector<int>> components = query.stronglyConnectedComponents();
+    EXPECT_EQ(4, components.size());
+    EXPECT_TRUE(components.contains(QVector<int>({ 1, 2, 3 })));
+
+    // one of the two parallel edges keeps the nodes connected
+    query.removeEdge(0, 1);
+    EXPECT_TRUE(query.wouldCreateCycle(1, 0));
+    query.removeEdge(0, 1);
+    EXPECT_FALSE(query.wouldCreateCycle(1, 0));
+
+    query.removeNode(3);
+    EXPECT_FALSE(query.hasCycle());
+
+    // a removed node takes its edges both ways along, a node added again under its ID has none
+    query.addEdge(0, 1);
+    query.removeNode(1);
+    query.addNode(1);
+    EXPECT_TRUE(query.downstream(0).isEmpty());
+    EXPECT_TRUE(query.upstream(2).isEmpty());
+    query.addEdge(5, 5);
+    query.removeNode(5);
+    EXPECT_FALSE(query.hasCycle());
+}
+
+TEST(TestNodeSearchIndex, PrefixFuzzyAndUpdates)
+{
+    NodeSearchIndex index;
+    index.insert(1, "Add", "Math");
+    index.insert(2, "Addition helper", "Math");
+    index.insert(3, "Multiply", "Math");
+    index.insert(4, "Output");
+
+    EXPECT_EQ(QVector<int>({ 1, 2 }), index.findPrefix("add"));
+    // nodes sharing a term come in the order of their IDs
+    EXPECT_EQ(QVector<int>({ 1, 2, 3 }), index.findPrefix(" MA"));
+    EXPECT_TRUE(index.findPrefix("x").isEmpty());
+
+    // a typo still finds the node, the most similar term comes first
+    const QVector<int> fuzzy = index.findFuzzy("multipy");
+    ASSERT_FALSE(fuzzy.isEmpty());
+    EXPECT_EQ(3, fuzzy.first());
+    EXPECT_EQ(1, index.find("add", 1).size());
+
+    index.rename(3, "Scale");
+    EXPECT_TRUE(index.findPrefix("mul").isEmpty());
+    EXPECT_EQ(QVector<int>({ 3 }), index.findPrefix("sca"));
+
+    // terms nobody uses anymore are dropped
+    const qsizetype terms = index.termsCount();
+    index.remove(1);
+    EXPECT_EQ(QVector<int>({ 2 }), index.findPrefix("add"));
+    EXPECT_EQ(terms - 1, index.termsCount());
+    EXPECT_EQ(3, index.size());
+
+    index.insert(0, "Zero", "Math");
+    EXPECT_EQ(QVector<int>({ 0, 2, 3 }), index.findPrefix("math"));
+}
+
+TEST(TestPaletteModel, FiltersByNameAndCategory)
+{
+    NodeFactoryModule::PaletteModel model;
+    model.setEntries({ { "Multiply", "Math", 0 }, { "Add", "Math", 1 }, { "Monitor", "Devices", 2 },
+                       { "Keyboard", "Devices", 3 }, { "Note", QString(), 4 } });
+
+    ASSERT_EQ(5, model.visibleCount());
+    EXPECT_EQ("Add", model.visibleEntry(0).name);
+    EXPECT_EQ(QStringList({ "Devices", "Math" }), model.categories());
+
+    // typing more only narrows the rows already passing
+    model.setFilter("m");
+    EXPECT_EQ(2, model.visibleCount());
+    model.setFilter("MO");
+    ASSERT_EQ(1, model.visibleCount());
+    EXPECT_EQ(2, model.visibleEntry(0).typeID);
+
+    model.setFilter("", "Math");
+    EXPECT_EQ(2, model.visibleCount());
+    model.setFilter("d", "Devices");
+    ASSERT_EQ(1, model.visibleCount());
+    EXPECT_EQ("Keyboard", model.visibleEntry(0).name);
+
+    // the filter stays when the types change
+    model.setEntries({ { "Dock", "Devices", 5 }, { "Keyboard", "Devices", 3 } });
+    EXPECT_EQ(2, model.visibleCount());
+
+    using Rows = QPair<qsizetype, qsizetype>;
+    EXPECT_EQ(Rows(0, 3), NodeFactoryModule::PaletteModel::rowsInSpan(0, 50, 20, 100));
+    EXPECT_EQ(Rows(2, 5), NodeFactoryModule::PaletteModel::rowsInSpan(45, 50, 20, 100));
+    EXPECT_EQ(Rows(98, 100), NodeFactoryModule::PaletteModel::rowsInSpan(1960, 100, 20, 100));
+}
+
+TEST(TestRenderDetail, TiersFollowZoom)
+{
+    EXPECT_EQ(RenderDetail::Overview, renderDetailForZoom(c_overviewZoomMultiplier));
+    EXPECT_EQ(RenderDetail::Simplified, renderDetailForZoom(c_changeRenderZoomMultiplier));
+    EXPECT_EQ(RenderDetail::Reduced, renderDetailForZoom(c_cachedTextZoomMultiplier));
+    EXPECT_EQ(RenderDetail::Full, renderDetailForZoom(1.0f));
+
+    // closer zoom never gives less detail
+    RenderDetail previous = RenderDetail::Overview;
+    for (float zoom = 0.05f; zoom < 3.0f; zoom += 0.05f)
+    {
+        EXPECT_GE(renderDetailForZoom(zoom), previous);
+        previous = renderDetailForZoom(zoom);
+    }
+}
+
+TEST(TestNodeRenderCache, ImagesAreKeyedByEverythingTheyShow)
+{
+    NodeRenderCache cache(1024);
+    const NodeRenderKey key{ 1, 7, 0, false, 0b01 };
+    cache.insert(key, QPixmap(10, 10));
+    cache.insert({ 1, 7, 3, false, 0b01 }, QPixmap(10, 10));
+
+    EXPECT_NE(nullptr, cache.find(key));
+    EXPECT_EQ(nullptr, cache.find({ 1, 8, 0, false, 0b01 }));
+    EXPECT_EQ(nullptr, cache.find({ 1, 7, 0, true, 0b01 }));
+    EXPECT_EQ(nullptr, cache.find({ 1, 7, 0, false, 0b11 }));
+    EXPECT_EQ(nullptr, cache.find({ 2, 7, 0, false, 0b01 }));
+
+    cache.retainLevels(-1, 1);
+    EXPECT_NE(nullptr, cache.find(key));
+    EXPECT_EQ(nullptr, cache.find({ 1, 7, 3, false, 0b01 }));
+}
+
+TEST_F(TestCanvas, PinChangesInvalidateNodeRender)
+{
+    QSharedPointer<BaseNode> node = _canvas->addBaseNode(QPoint(0, 0), "Node").toStrongRef();
+    node->addPin("in", PinDirection::In);
+    AbstractPin *pin = node->pins().first();
+
+    quint64 generation = node->renderGeneration();
+    pin->setText("renamed");
+    EXPECT_NE(generation, node->renderGeneration());
+
+    generation = node->renderGeneration();
+    pin->setColor(Qt::red);
+    EXPECT_NE(generation, node->renderGeneration());
+}
+
+TEST_F(TestCanvas, UndoRedoKeepsPinsAddedAfterTheNode)
+{
+    QSharedPointer<BaseNode> source = _canvas->addBaseNode(QPoint(0, 0), "Source").toStrongRef();
+    source->addPin("out", PinDirection::Out);
+    QSharedPointer<BaseNode> target = _canvas->addBaseNode(QPoint(300, 0), "Target").toStrongRef();
+    target->addPin("in", PinDirection::In);
+    const int sourceID = source->ID(), targetID = target->ID();
+    _canvas->connectPins(source->pins().first()->getData(), target->pins().first()->getData());
+    target.reset();
+
+    _canvas->undo();
+    _canvas->undo();
+    EXPECT_TRUE(_canvas->graphQuery().downstream(sourceID).isEmpty());
+
+    _canvas->redo();
+    _canvas->redo();
+    EXPECT_EQ(QVector<int>({ targetID }), _canvas->graphQuery().downstream(sourceID));
+
+    _canvas->selectAll();
+    const Subgraph subgraph = _canvas->selectedSubgraph();
+    ASSERT_EQ(2, subgraph.nodes.size());
+    EXPECT_EQ(1, subgraph.nodes.at(1).pins.size());
+    EXPECT_EQ(1, subgraph.edges.size());
+}
+
+TEST_F(TestCanvas, DraggedPinScrollsCanvasNearEdge)
+{
+    QSharedPointer<BaseNode> node = _canvas->addBaseNode(QPoint(0, 0), "Node").toStrongRef();
+    node->addPin("out", PinDirection::Out);
+    // starts from an idle clock
+    FrameClock *clock = _canvas->frameClock();
+    QElapsedTimer timeout;
+    timeout.start();
+    while (clock->isRunning() && timeout.elapsed() < 1000)
+        QCoreApplication::processEvents();
+    ASSERT_FALSE(clock->isRunning());
+
+    QMimeData mimeData;
+    mimeData.setData(c_mimeFormatForPinConnection, QByteArray());
+    auto dragTo = [&](QPoint position) {
+        QDragMoveEvent event(position, Qt::CopyAction, &mimeData, Qt::LeftButton, Qt::NoModifier);
+        QCoreApplication::sendEvent(_canvas.get(), &event);
+    };
+
+    // the first frame after idling lasts an interval, so it moves a known distance
+    emit node->onPinDrag(PinDragSignal(node->pins().first()->getData(), PinDragSignalType::Start));
+    dragTo(QPoint(_canvas->width() - 1, _canvas->height() / 2));
+    const QPointF start = _canvas->getOffset();
+    clock->flush();
+    const float maxMove = c_pinDragEdgeCanvasMoveSpeed * c_frameIntervalMs / 1000.0f;
+    const QPointF moved = _canvas->getOffset() - start;
+    EXPECT_GT(moved.x(), 0.9f * maxMove);
+    EXPECT_LE(moved.x(), maxMove);
+    EXPECT_EQ(moved.y(), 0);
+
+    // a cursor staying at the edge keeps scrolling the canvas on the following frames
+    QThread::msleep(c_frameIntervalMs);
+    clock->flush();
+    EXPECT_GT(_canvas->getOffset().x(), start.x() + moved.x());
+
+    // away from the edges the scrolling stops
+    dragTo(_canvas->rect().center());
+    clock->flush();
+    const QPointF stopped = _canvas->getOffset();
+    clock->flush();
+    EXPECT_EQ(stopped, _canvas->getOffset());
+
+    emit node->onPinDrag(PinDragSignal(node->pins().first()->getData(), PinDragSignalType::End));
+}
+
+TEST_F(TestCanvas, DraggingMovesSelectionAndUndoesAtOnce)
+{
+    QSharedPointer<BaseNode> anchor = _canvas->addBaseNode(QPoint(0, 0), "Anchor").toStrongRef();
+    QSharedPointer<BaseNode> selected = _canvas->addBaseNode(QPoint(200, 0), "Selected").toStrongRef();
+    QSharedPointer<BaseNode> other = _canvas->addBaseNode(QPoint(400, 0), "Other").toStrongRef();
+    const QPointF anchorStart = anchor->canvasPosition();
+    const QPointF selectedStart = selected->canvasPosition();
+    const QPointF otherStart = other->canvasPosition();
+
+    emit anchor->onSelect(false, anchor->ID());
+    emit selected->onSelect(true, selected->ID());
+
+    // one step is applied on a frame, the last one when the drag ends
+    emit anchor->onDrag(anchor->ID(), anchorStart + QPointF(10, 20));
+    _canvas->frameClock()->flush();
+    EXPECT_EQ(selectedStart + QPointF(10, 20), selected->canvasPosition());
+    emit anchor->onDrag(anchor->ID(), anchorStart + QPointF(30, 50));
+    emit anchor->onMoveFinished(anchor->ID());
+
+    EXPECT_EQ(anchorStart + QPointF(30, 50), anchor->canvasPosition());
+    EXPECT_EQ(selectedStart + QPointF(30, 50), selected->canvasPosition());
+    EXPECT_EQ(otherStart, other->canvasPosition()) << "Unselected node is expected to stay";
+
+    // the drag's steps are merged into one command
+    _canvas->undo();
+    EXPECT_EQ(anchorStart, anchor->canvasPosition());
+    EXPECT_EQ(selectedStart, selected->canvasPosition());
+
+    _canvas->redo();
+    EXPECT_EQ(anchorStart + QPointF(30, 50), anchor->canvasPosition());
+    EXPECT_EQ(selectedStart + QPointF(30, 50), selected->canvasPosition());
+}
+
+// Chain a -> b -> c with a spare in-pin d, a and b are collapsed
+class TestCanvasGroups : public TestCanvas
+{
+protected:
+    void SetUp() override
+    {
+        TestCanvas::SetUp();
+        _a = _canvas->addBaseNode(QPoint(0, 40), "A").toStrongRef();
+        _a->addPin("out", PinDirection::Out);
+        _b = _canvas->addBaseNode(QPoint(300, 0), "B").toStrongRef();
+        _b->addPin("in", PinDirection::In);
+        _b->addPin("out", PinDirection::Out);
+        _c = _canvas->addBaseNode(QPoint(600, 0), "C").toStrongRef();
+        _c->addPin("in", PinDirection::In);
+        _d = _canvas->addBaseNode(QPoint(600, 300), "D").toStrongRef();
+        _d->addPin("in", PinDirection::In);
+        _canvas->connectPins(_a->pins().first()->getData(), _b->pins().first()->getData());
+        _canvas->connectPins(_b->pins().last()->getData(), _c->pins().first()->getData());
+
+        emit _a->onSelect(false, _a->ID());
+        emit _b->onSelect(true, _b->ID());
+        _groupID = _canvas->collapseSelection();
+    }
+
+    QSharedPointer<BaseNode> _a, _b, _c, _d;
+    int _groupID;
+};
+
+TEST_F(TestCanvasGroups, CollapseHidesMembersBehindTheGroup)
+{
+    ASSERT_TRUE(_canvas->isGroup(_groupID));
+    EXPECT_TRUE(_canvas->isCollapsed(_a->ID()));
+    EXPECT_TRUE(_canvas->isCollapsed(_b->ID()));
+    EXPECT_TRUE(_canvas->isNodeSelected(_groupID));
+
+    // only the member's pin connected outside of the group is shown
+    const GroupNode *group = _canvas->group(_groupID);
+    ASSERT_EQ(1, group->pins().size());
+    EXPECT_EQ(_b->pins().last()->getData(), group->memberPin(group->pins().first()->getData()));
+    EXPECT_EQ(QPointF(0, 0), group->canvasPosition()) << "Group is expected at its members' top-left corner";
+
+    // the group is indexed in place of its members, and is neither searched nor a part of the graph
+    EXPECT_TRUE(_canvas->nodeIndex().contains(_groupID));
+    EXPECT_FALSE(_canvas->nodeIndex().contains(_a->ID()));
+    EXPECT_TRUE(_canvas->findNodes("Group").isEmpty());
+    EXPECT_FALSE(_canvas->graphQuery().topologicalOrder()->contains(_groupID));
+    EXPECT_EQ(QVector<int>({ _b->ID(), _c->ID() }), _canvas->graphQuery().downstream(_a->ID()));
+
+    // a selected group is copied as its members
+    const Subgraph subgraph = _canvas->selectedSubgraph();
+    EXPECT_EQ(2, subgraph.nodes.size());
+    EXPECT_EQ(1, subgraph.edges.size());
+}
+
+TEST_F(TestCanvasGroups, GroupPinsConnectTheMembersPins)
+{
+    GroupNode *group = _canvas->group(_groupID);
+    emit group->onPinConnect(group->pins().first()->getData(), _d->pins().first()->getData());
+    EXPECT_EQ(QVector<int>({ _c->ID(), _d->ID() }), _canvas->graphQuery().downstream(_b->ID()));
+    EXPECT_TRUE(_b->pins().last()->getConnectedPins().contains(_d->pins().first()->getData()));
+}
+
+TEST_F(TestCanvasGroups, ExpandShowsMembersWhereTheGroupMovedThem)
+{
+    GroupNode *group = _canvas->group(_groupID);
+    emit group->onDrag(_groupID, QPointF(50, 20));
+    emit group->onMoveFinished(_groupID);
+    EXPECT_EQ(QPointF(50, 60), _a->canvasPosition());
+
+    // only the members' moves are recorded, the group follows them back
+    _canvas->undo();
+    EXPECT_EQ(QPointF(0, 40), _a->canvasPosition());
+    EXPECT_EQ(QPointF(0, 0), group->canvasPosition());
+    EXPECT_EQ(QPointF(0, 0), _canvas->nodeIndex().rect(_groupID).topLeft());
+    _canvas->redo();
+    EXPECT_EQ(QPointF(50, 20), group->canvasPosition());
+
+    _canvas->expandGroup(_groupID);
+    EXPECT_FALSE(_canvas->isGroup(_groupID));
+    EXPECT_FALSE(_canvas->isCollapsed(_a->ID()));
+    EXPECT_FALSE(_canvas->nodeIndex().contains(_groupID));
+    EXPECT_EQ(QPointF(50, 60), _canvas->nodeIndex().rect(_a->ID()).topLeft());
+    EXPECT_TRUE(_canvas->isNodeSelected(_a->ID()) && _canvas->isNodeSelected(_b->ID()));
+    EXPECT_EQ(QVector<int>({ _b->ID(), _c->ID() }), _canvas->graphQuery().downstream(_a->ID()));
+}
+
+TEST_F(TestCanvasGroups, RemovingGroupRemovesItsMembers)
+{
+    const int aID = _a->ID(), bID = _b->ID();
+    _canvas->removeNode(_groupID);
+    EXPECT_FALSE(_canvas->isGroup(_groupID));
+    EXPECT_FALSE(_canvas->nodeIndex().contains(aID));
+    EXPECT_FALSE(_canvas->nodeIndex().contains(bID));
+    EXPECT_TRUE(_canvas->graphQuery().upstream(_c->ID()).isEmpty());
+
+    // the members come back expanded, with their connections
+    _canvas->undo();
+    EXPECT_FALSE(_canvas->isCollapsed(aID));
+    EXPECT_TRUE(_canvas->nodeIndex().contains(bID));
+    EXPECT_EQ(QVector<int>({ bID, _c->ID() }), _canvas->graphQuery().downstream(aID));
+}
+
+TEST_F(TestCanvasGroups, RemovingMemberDropsItsGroupPins)
+{
+    _canvas->removeNode(_b->ID());
+    const GroupNode *group = _canvas->group(_groupID);
+    ASSERT_NE(nullptr, group);
+    EXPECT_EQ(QVector<int>({ _a->ID() }), group->members());
+    EXPECT_TRUE(group->pins().isEmpty());
+}
+
+TEST_F(TestCanvas, UndoDuringLayoutAnimationSticks)
+{
+    QSharedPointer<BaseNode> node = _canvas->addBaseNode(QPoint(0, 0), "Node").toStrongRef();
+    const QPointF start = node->canvasPosition();
+
+    _canvas->applyLayout({ { node->ID(), QPointF(200, 100) } }, true);
+    ASSERT_TRUE(_canvas->isLayoutAnimating());
+    _canvas->undo();
+    EXPECT_FALSE(_canvas->isLayoutAnimating());
+    EXPECT_EQ(start, node->canvasPosition());
+
+    // nothing left to take the node to the layout's positions
+    processEventsUntil([] { return false; }, c_layoutAnimationDurationMs + 100);
+    EXPECT_EQ(start, node->canvasPosition());
+    EXPECT_EQ(start, _canvas->nodeIndex().rect(node->ID()).topLeft());
+
+    _canvas->redo();
+    EXPECT_EQ(QPointF(200, 100), node->canvasPosition());
+}
+
+TEST_F(TestCanvas, MouseDragKeepsSelection)
+{
+    QSharedPointer<BaseNode> anchor = _canvas->addBaseNode(QPoint(0, 0), "Anchor").toStrongRef();
+    QSharedPointer<BaseNode> selected = _canvas->addBaseNode(QPoint(200, 0), "Selected").toStrongRef();
+    const QPointF anchorStart = anchor->canvasPosition();
+    const QPointF selectedStart = selected->canvasPosition();
+    emit anchor->onSelect(false, anchor->ID());
+    emit selected->onSelect(true, selected->ID());
+
+    auto send = [&](QEvent::Type type, QPointF position, Qt::MouseButton button, Qt::MouseButtons buttons) {
+        QMouseEvent event(type, position, anchor->mapToGlobal(position), button, buttons, Qt::NoModifier);
+        QCoreApplication::sendEvent(anchor.get(), &event);
+    };
+
+    // the release ending a drag doesn't select the dragged node alone
+    send(QEvent::MouseButtonPress, QPointF(10, 10), Qt::LeftButton, Qt::LeftButton);
+    send(QEvent::MouseMove, QPointF(60, 50), Qt::NoButton, Qt::LeftButton);
+    send(QEvent::MouseButtonRelease, QPointF(60, 50), Qt::LeftButton, Qt::NoButton);
+    EXPECT_TRUE(_canvas->isNodeSelected(anchor->ID()));
+    EXPECT_TRUE(_canvas->isNodeSelected(selected->ID()));
+    const QPointF moved = anchor->canvasPosition() - anchorStart;
+    EXPECT_FALSE(moved.isNull());
+    EXPECT_EQ(selectedStart + moved, selected->canvasPosition());
+
+    // a click still selects only the clicked node
+    send(QEvent::MouseButtonPress, QPointF(10, 10), Qt::LeftButton, Qt::LeftButton);
+    send(QEvent::MouseButtonRelease, QPointF(10, 10), Qt::LeftButton, Qt::NoButton);
+    EXPECT_TRUE(_canvas->isNodeSelected(anchor->ID()));
+    EXPECT_FALSE(_canvas->isNodeSelected(selected->ID()));
+}
+
+TEST_F(TestCanvas, PastingMalformedSubgraphSkipsBrokenEdges)
+{
+    // pins of untyped nodes come from the records, typed nodes get the pins of their type
+    Subgraph subgraph;
+    subgraph.nodes = { { 10, -1, QPointF(0, 0), "Source", { { "out", PinDirection::Out, Qt::black } } },
+                       { 11, -1, QPointF(200, 0), "Target", { { "in", PinDirection::In, Qt::black } } },
+                       { 12, 2, QPointF(400, 0), QString(), {} },
+                       { 13, 1000, QPointF(600, 0), QString(), {} } };
+    subgraph.edges = { { 10, 0, 11, 0 },
+                       // pin indices past the pins, negative ones and edges going from an in-pin
+                       { 10, 5, 11, 0 }, { 10, 0, 11, -1 }, { 11, 0, 10, 0 }, { 12, 0, 11, 3 },
+                       // a node that isn't pasted and a duplicate
+                       { 13, 0, 11, 0 }, { 10, 0, 11, 0 } };
+
+    const QVector<int> ids = _canvas->addSubgraph(Subgraph::fromByteArray(subgraph.toByteArray()), QPointF(0, 0));
+    ASSERT_EQ(3, ids.size());
+    EXPECT_EQ(QVector<int>({ ids.at(1) }), _canvas->graphQuery().downstream(ids.at(0)));
+    EXPECT_TRUE(_canvas->graphQuery().downstream(ids.at(2)).isEmpty());
+
+    // only the restored edge is recorded
+    _canvas->undo();
+    _canvas->redo();
+    _canvas->selectAll();
+    EXPECT_EQ(1, _canvas->selectedSubgraph().edges.size());
+}
+
+TEST_F(TestCanvas, ExportKeepsCanvasLayout)
+{
+    const int nodeID = _canvas->addTypedNode(QPoint(0, 0), 1).toStrongRef()->ID();
+    _canvas->addTypedNode(QPoint(1500, 900), 2);
+
+    // an export at the canvas' zoom leaves the nodes laid out for it
+    ExportOptions options;
+    QBuffer png;
+    png.open(QIODevice::WriteOnly);
+    ASSERT_TRUE(_canvas->exportPng(&png, options));
+    const QRectF bounds = _canvas->nodeIndex().rect(nodeID);
+
+    // exports at other scales, finished or refused, don't leave their layout behind
+    options.scale = 2.0;
+    ASSERT_TRUE(_canvas->exportPng(&png, options));
+    EXPECT_EQ(bounds, _canvas->nodeIndex().rect(nodeID));
+    options.scale = 1e9;
+    EXPECT_FALSE(_canvas->exportPng(&png, options));
+    EXPECT_EQ(bounds, _canvas->nodeIndex().rect(nodeID));
+    QTemporaryDir dir;
+    options.scale = 0.25;
+    ASSERT_TRUE(_canvas->exportSvg(dir.filePath("graph.svg"), options));
+    EXPECT_EQ(bounds, _canvas->nodeIndex().rect(nodeID));
+}
+
+TEST_F(TestCanvas, ExportsWholeGraphInStrips)
+{
+    ExportOptions options;
+    QBuffer empty;
+    empty.open(QIODevice::WriteOnly);
+    EXPECT_FALSE(_canvas->exportPng(&empty, options)) << "Expected an empty graph not to be exported";
+
+    _canvas->addTypedNode(QPoint(0, 0), 1);
+    _canvas->addTypedNode(QPoint(1500, 900), 2);
+
+    // a small budget makes the image be written in several strips
+    options.memoryBudgetBytes = 64 * 1024;
+    const QSize size = _canvas->exportSize(options);
+    ASSERT_FALSE(size.isEmpty());
+
+    QBuffer png;
+    png.open(QIODevice::WriteOnly);
+    ASSERT_TRUE(_canvas->exportPng(&png, options));
+    const QImage image = QImage::fromData(png.data(), "PNG");
+    EXPECT_EQ(size, image.size());
+    EXPECT_NE(0, image.pixel(size.width() / 2, size.height() / 2)) << "Expected the background to be drawn";
+
+    QTemporaryDir dir;
+    const QString svg = dir.filePath("graph.svg");
+    ASSERT_TRUE(_canvas->exportSvg(svg, options));
+    QFile file(svg);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    EXPECT_TRUE(file.readAll().contains("<svg"));
+
+    // sizes that don't fit an int, or a row into memory, are refused instead of overflowing
+    options.scale = 1e9;
+    EXPECT_TRUE(_canvas->exportSize(options).isEmpty());
+    EXPECT_FALSE(_canvas->exportPng(&empty, options));
+    options.scale = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_FALSE(_canvas->exportSvg(svg, options));
+}